@@ -2,6 +2,22 @@
 #define ALGORITHMS_H
 
 #include "../include/graph.h"
+#include "../include/pqueue.h"
+#include "../include/search_context.h"
+
+/**
+ * @brief Selects the priority queue backend used by Dijkstra and A*.
+ * Defaults to PQ_BINARY_HEAP; PQ_LINEAR_SCAN is the O(V^2) scan, only worth it
+ * on graphs with a handful of vertices.
+ *
+ * @param kind Queue backend for subsequent queries
+ */
+void search_set_queue(PQueueKind kind);
+
+/**
+ * @brief Returns the queue backend currently used by Dijkstra and A*.
+ */
+PQueueKind search_get_queue(void);
 
 /**
  * @brief Finds the shortest path in terms of number of hops (edges) using BFS.
@@ -42,7 +58,60 @@ int dfs_path(Graph *graph, int start, int goal, int *out_path, int max_path_len)
  * @param out_distance Total path weight or -1 if unreachable
  * @return Path length (number of vertices) or 0 on failure
  */
-int dijkstra_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, int *out_distance);
+int dijkstra_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance);
+
+/**
+ * @brief One-to-all Dijkstra – settles every vertex reachable from start.
+ * Assumes non-negative edge weights. Both arrays are indexed by vertex.
+ *
+ * @param graph      The graph
+ * @param start      Start vertex
+ * @param out_dist   numVertices distances, -1 for unreachable vertices
+ * @param out_parent Optional (NULL): numVertices predecessors on a shortest path,
+ *                   -1 for start and unreachable vertices
+ * @return Number of reachable vertices (start included), or -1 on failure
+ */
+int dijkstra_one_to_all(Graph *graph, int start, long long *out_dist, int *out_parent);
+
+/**
+ * @brief Bidirectional Dijkstra – searches forward from start and backward from
+ * goal over incoming edges (graph_reverse()) until the two radii add up to the
+ * best meeting distance found. Same result as dijkstra_shortest_path(), with
+ * about half the settled vertices on long queries.
+ *
+ * @param graph       The graph
+ * @param start       Start vertex
+ * @param goal        Goal vertex
+ * @param out_path    Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @return Path length (number of vertices) or 0 on failure
+ */
+int bidirectional_dijkstra_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance);
+
+/**
+ * @brief Bidirectional A* – bidirectional Dijkstra on edge costs reduced by the
+ * average potential (h(v, goal) - h(start, v)) / 2. Both directions see the same
+ * reduced graph, so the result is exact for any consistent heuristic.
+ * If heuristic is NULL, behaves like bidirectional Dijkstra.
+ *
+ * @param graph       The graph
+ * @param start       Start vertex
+ * @param goal        Goal vertex
+ * @param out_path    Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @param heuristic   Consistent heuristic function(from, to) → estimated cost (can be NULL)
+ * @return Path length (number of vertices) or 0 on failure, including
+ *         landmark_heuristic() over a stale landmark set
+ */
+int bidirectional_astar_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance, int (*heuristic)(int from, int to));
+
+/**
+ * @brief Number of vertices the calling thread's last BFS, Dijkstra or A* query
+ * settled (both directions for bidirectional searches).
+ */
+int search_last_settled(void);
 
 /**
  * @brief A* search – shortest path using heuristic.
@@ -55,9 +124,10 @@ int dijkstra_shortest_path(Graph *graph, int start, int goal, int *out_path, int
  * @param max_path_len Buffer size
  * @param out_distance Total path cost or -1
  * @param heuristic   Heuristic function(from, to) → estimated cost (can be NULL)
- * @return Path length or 0 if no path
+ * @return Path length or 0 if no path, or if heuristic is landmark_heuristic()
+ *         over a stale landmark set
  */
-int astar_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, int *out_distance, int (*heuristic)(int from, int to));
+int astar_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance, int (*heuristic)(int from, int to));
 int simple_euclidean_heuristic(int a, int b);
 int simple_manhattan_heuristic(int a, int b);
 
@@ -73,6 +143,6 @@ int simple_manhattan_heuristic(int a, int b);
  * @param out_distance Total cost or -1 (no path or negative cycle detected)
  * @return Number of vertices in path or 0 on failure/no path/negative cycle
  */
-int bellman_ford_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, int *out_distance);
+int bellman_ford_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance);
 
 #endif /* ALGORITHMS_H */
\ No newline at end of file
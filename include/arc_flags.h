@@ -0,0 +1,72 @@
+#ifndef ARC_FLAGS_H
+#define ARC_FLAGS_H
+
+#include <stdint.h>
+#include "../include/graph.h"
+
+/** Regions one flag word can hold */
+#define ARC_FLAGS_MAX_REGIONS 64
+
+/** Regions the CLI partitions into */
+#define ARC_FLAGS_DEFAULT_REGIONS 32
+
+/** Worker threads arc_flags_build() uses when asked for 0 */
+#define ARC_FLAGS_DEFAULT_THREADS 4
+
+/**
+ * @brief Arc flags over a partition of a graph's internal vertices.
+ *
+ * Bit r of flags[e] is set if base edge e starts a shortest path into region r.
+ * A Dijkstra towards a goal in region r may skip every edge whose bit r is
+ * clear and still finds a shortest path. flags is parallel to the CSR edge
+ * storage and indexed by GraphEdgeIter.edge. Edges inserted through the overlay
+ * have no edge ID and are never skipped.
+ *
+ * Flags reflect the edges and weights at build time; queries fail once the
+ * graph has changed, so rebuild them after edge changes.
+ */
+typedef struct ArcFlags {
+    int numVertices;        /**< Vertices of the graph it was built for */
+    int numEdges;           /**< Base edges of the graph it was built for */
+    unsigned int graphVersion; /**< graph_version() at build time */
+    int numRegions;         /**< Regions of the partition (≤ ARC_FLAGS_MAX_REGIONS) */
+    int *regionOf;          /**< Region per internal vertex */
+    uint64_t *flags;        /**< Region bitmask per base edge ID */
+} ArcFlags;
+
+/**
+ * @brief Partitions the graph and computes the flag of every edge.
+ * Regions come from recursive BFS bisection (graph_partition_bisect()).
+ * For every region a backward Dijkstra runs from each boundary vertex (one
+ * with an incoming edge from another region) and flags the edges that are
+ * tight in its shortest-path DAG; edges inside a region always carry its own
+ * flag. Regions are split across threads.
+ *
+ * @param graph       The graph (frozen first if needed; weights must be non-negative)
+ * @param num_regions Regions to create (1 .. ARC_FLAGS_MAX_REGIONS, capped at the vertex count)
+ * @param num_threads Worker threads (0 = ARC_FLAGS_DEFAULT_THREADS, 1 = no threads)
+ * @return New arc flags, or NULL on invalid input, negative weights or allocation failure
+ */
+ArcFlags *arc_flags_build(Graph *graph, int num_regions, int num_threads);
+
+/**
+ * @brief Frees arc flags (safe to pass NULL).
+ */
+void arc_flags_free(ArcFlags *af);
+
+/**
+ * @brief Dijkstra that only relaxes edges flagged for the goal's region.
+ *
+ * @param af          Flags built from graph
+ * @param graph       The graph
+ * @param start       Start vertex
+ * @param goal        Goal vertex
+ * @param out_path    Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @return Path length (number of vertices) or 0 on failure (including stale flags)
+ */
+int arc_flags_shortest_path(const ArcFlags *af, Graph *graph, int start, int goal,
+                            int *out_path, int max_path_len, long long *out_distance);
+
+#endif /* ARC_FLAGS_H */
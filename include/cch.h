@@ -0,0 +1,61 @@
+#ifndef CCH_H
+#define CCH_H
+
+#include "../include/graph.h"
+#include "../include/ch.h"
+
+/** Worker threads cch_customize() uses when asked for 0 */
+#define CCH_DEFAULT_THREADS 4
+
+/**
+ * @brief Customizable contraction hierarchy.
+ *
+ * The contraction order comes from the topology alone: nested dissection
+ * with BFS level separators gives each separator higher ranks than the two
+ * halves it splits. Contracting in that order without witness searches
+ * yields a fixed set of arcs that is valid for every metric. Customization
+ * then fills in the arc weights for the graph's current edge weights, bottom
+ * up over the lower triangles {v, a, b} of each arc {a, b}.
+ *
+ * The hierarchy field is an ordinary ContractionHierarchy whose weights and
+ * shortcut middles are overwritten by every customization; query it with
+ * ch_shortest_path(). Arcs the current metric does not use carry CH_NO_ARC.
+ */
+typedef struct CustomizableCH {
+    ContractionHierarchy *hierarchy;    /**< Topology plus the current metric */
+    int numArcs;                        /**< Undirected arcs {a, b}, stored once at the lower rank */
+    int *lowerOffsets;                  /**< Lower neighbours of rank a: [lowerOffsets[a], lowerOffsets[a + 1]) */
+    int *lowerVertex;                   /**< Lower neighbour v (rank) */
+    int *lowerArc;                      /**< Index of arc {v, a} in v's upward arcs */
+    int numLevels;                      /**< Customization rounds */
+    int *levelOffsets;                  /**< Ranks of round l: levelRanks[levelOffsets[l] .. levelOffsets[l + 1]) */
+    int *levelRanks;                    /**< Ranks grouped by round; a round only reads earlier rounds */
+    unsigned int orderVersion;          /**< graph_order_version() the ranks were assigned for */
+} CustomizableCH;
+
+/**
+ * @brief Computes the nested dissection order and the metric-independent
+ * arcs, then customizes once for the graph's current weights.
+ * @param graph The graph (frozen first if needed; weights must be non-negative)
+ * @return New hierarchy, or NULL on invalid input, negative weights or allocation failure
+ */
+CustomizableCH *cch_build(Graph *graph);
+
+/**
+ * @brief Re-derives every arc weight from the graph's current edge weights,
+ * including pending live updates. Rounds run in order; the ranks of one round
+ * are split across threads.
+ * @param cch         Hierarchy built from graph
+ * @param graph       The graph
+ * @param num_threads Worker threads (0 = CCH_DEFAULT_THREADS, 1 = no threads)
+ * @return 0 on success, -1 on failure (negative weight, a renumbered graph, or an
+ *         edge between vertices the topology does not connect: rebuild with cch_build())
+ */
+int cch_customize(CustomizableCH *cch, Graph *graph, int num_threads);
+
+/**
+ * @brief Frees a customizable hierarchy (safe to pass NULL).
+ */
+void cch_free(CustomizableCH *cch);
+
+#endif /* CCH_H */
@@ -0,0 +1,78 @@
+#ifndef CH_H
+#define CH_H
+
+#include <limits.h>
+#include "../include/graph.h"
+
+/** Weight of an arc the current metric does not use (customizable hierarchies) */
+#define CH_NO_ARC LLONG_MAX
+
+/**
+ * @brief Contraction hierarchy over a graph's internal vertices.
+ *
+ * Vertices are contracted one by one in rank order; contracting v adds a
+ * shortcut u → x of weight w(u, v) + w(v, x) unless a witness path avoiding v
+ * is at least as short. Every shortest path then has an equivalent up-down
+ * path: ranks rise to a top vertex and fall from there.
+ *
+ * The search graph is stored by rank. Upward arcs of rank r lead to higher
+ * ranks and drive the forward search. Downward arcs stored at r come from
+ * higher ranks into r; reversed, they drive the backward search. Each arc
+ * records the middle vertex of its shortcut (-1 for an original edge), which
+ * is how paths are unpacked.
+ *
+ * The hierarchy reflects the weights at build time; queries fail once the
+ * graph has changed, so rebuild (or re-customize) it after edge changes.
+ */
+typedef struct ContractionHierarchy {
+    int numVertices;        /**< Vertices of the graph it was built for */
+    int numShortcuts;       /**< Shortcut arcs added during contraction */
+    int *rankOf;            /**< Rank per internal vertex (0 = contracted first) */
+    int *vertexAt;          /**< Internal vertex per rank */
+    int *upOffsets;         /**< Upward arcs of rank r: [upOffsets[r], upOffsets[r + 1]) */
+    int *upTargets;         /**< Head rank (> r) */
+    long long *upWeights;   /**< Arc weight */
+    int *upMiddle;          /**< Rank of the shortcut's middle vertex, -1 for an original edge */
+    int *downOffsets;       /**< Downward arcs into rank r: [downOffsets[r], downOffsets[r + 1]) */
+    int *downSources;       /**< Tail rank (> r) */
+    long long *downWeights; /**< Arc weight */
+    int *downMiddle;        /**< Rank of the shortcut's middle vertex, -1 for an original edge */
+    unsigned int graphVersion; /**< graph_version() the weights reflect, 0 while being customized */
+} ContractionHierarchy;
+
+/**
+ * @brief Orders and contracts every vertex of the graph.
+ * The next vertex is the one with the smallest edge difference (shortcuts
+ * added minus arcs removed) plus number of already contracted neighbours,
+ * re-evaluated lazily when it reaches the top of the queue. Witness searches
+ * are local Dijkstra runs with a settled-vertex limit, so a few unnecessary
+ * shortcuts may remain; distances are exact regardless.
+ *
+ * @param graph The graph (frozen first if needed; weights must be non-negative)
+ * @return New hierarchy, or NULL on invalid input, negative weights or allocation failure
+ */
+ContractionHierarchy *ch_build(Graph *graph);
+
+/**
+ * @brief Frees a hierarchy (safe to pass NULL).
+ */
+void ch_free(ContractionHierarchy *ch);
+
+/**
+ * @brief CH query – bidirectional Dijkstra restricted to upward arcs, with
+ * stall-on-demand. Each direction stops once its queue minimum reaches the
+ * best meeting distance. Shortcuts on the result are unpacked into original edges.
+ *
+ * @param ch          Hierarchy built from graph
+ * @param graph       The graph
+ * @param start       Start vertex
+ * @param goal        Goal vertex
+ * @param out_path    Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @return Path length (number of vertices) or 0 on failure or a changed graph
+ */
+int ch_shortest_path(const ContractionHierarchy *ch, Graph *graph, int start, int goal,
+                     int *out_path, int max_path_len, long long *out_distance);
+
+#endif /* CH_H */
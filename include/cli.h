@@ -15,7 +15,18 @@ typedef enum {
     ALGO_ASTAR_NONE,        /**< A* without heuristic (falls back to Dijkstra) */
     ALGO_ASTAR_MANHATTAN,   /**< A* with Manhattan heuristic */
     ALGO_ASTAR_EUCLIDEAN,   /**< A* with Euclidean heuristic */
-    ALGO_BELLMAN_FORD       /**< Bellman-Ford – negative weights & cycle detection */
+    ALGO_BELLMAN_FORD,      /**< Bellman-Ford – negative weights & cycle detection */
+    ALGO_BIDIJKSTRA,        /**< Bidirectional Dijkstra – same result, fewer settled vertices */
+    ALGO_BIASTAR_MANHATTAN, /**< Bidirectional A* with Manhattan heuristic */
+    ALGO_BIASTAR_EUCLIDEAN, /**< Bidirectional A* with Euclidean heuristic */
+    ALGO_ASTAR_LANDMARKS,   /**< A* with ALT landmark lower bounds */
+    ALGO_BIASTAR_LANDMARKS, /**< Bidirectional A* with ALT landmark lower bounds */
+    ALGO_CH,                /**< Contraction Hierarchies – preprocessed, fastest repeated queries */
+    ALGO_CCH,               /**< Customizable CH – metric-independent order, re-customized after weight changes */
+    ALGO_HUB_LABELS,        /**< Hub labels – label intersection, microsecond distance queries */
+    ALGO_ARC_FLAGS,         /**< Dijkstra pruned by arc flags towards the goal's region */
+    ALGO_CRP,               /**< Multi-level overlay (CRP) – cell cliques, re-customized after weight changes */
+    ALGO_TNR                /**< Transit-node routing – table lookups for long queries, CH for local ones */
 } Algorithm;
 
 /* ============================================================================
@@ -24,7 +35,7 @@ typedef enum {
 
 /**
  * @brief Displays an interactive menu and returns the user's chosen algorithm.
- * Loops until valid input (0–5) is received.
+ * Loops until valid input (0–13, 4.1–4.4 or 7.1–7.3) is received.
  * @return Selected Algorithm value (ALGO_NONE = 0 means exit)
  */
 Algorithm cli_select_algorithm(void);
@@ -0,0 +1,111 @@
+#ifndef CRP_H
+#define CRP_H
+
+#include <limits.h>
+#include "../include/graph.h"
+
+/** Levels the CLI builds */
+#define CRP_DEFAULT_LEVELS 3
+
+/** Largest level-1 cell the CLI builds */
+#define CRP_DEFAULT_CELL_SIZE 64
+
+/** Cells of level l + 1 hold up to this many times the vertices of level l */
+#define CRP_LEVEL_FANOUT 8
+
+/** Worker threads crp_customize() uses when asked for 0 */
+#define CRP_DEFAULT_THREADS 4
+
+/** Clique entry for a boundary pair with no path inside the cell */
+#define CRP_NO_PATH LLONG_MAX
+
+/**
+ * @brief One level of the overlay: a partition into cells and, per cell, the
+ * distances between its boundary vertices.
+ *
+ * A vertex is a boundary vertex of its cell if an edge joins it to another
+ * cell of this level. Cells nest: every cell lies inside one cell of the next
+ * level up, and boundary vertices of a level are also boundary vertices of the
+ * levels below.
+ */
+typedef struct CrpLevel {
+    int numCells;               /**< Cells of this level */
+    int *cellOf;                /**< Cell per internal vertex */
+    int *boundaryOffsets;       /**< Boundary of cell c: boundary[boundaryOffsets[c] .. boundaryOffsets[c + 1]) */
+    int *boundary;              /**< Boundary vertices (internal IDs), grouped by cell */
+    int *boundaryIndex;         /**< Position of v in its cell's boundary, -1 for interior vertices */
+    long long *matrixOffsets;   /**< Clique matrix of cell c starts at matrices[matrixOffsets[c]] */
+    long long *matrices;        /**< Row-major B × B distances inside each cell, CRP_NO_PATH if none */
+} CrpLevel;
+
+/**
+ * @brief Multi-level overlay for Customizable Route Planning (CRP).
+ *
+ * Preprocessing is split in two. crp_build() partitions the vertices into
+ * nested cells, which depends only on the topology. crp_customize() fills the
+ * clique matrices from the current weights: level-1 cells by Dijkstra over
+ * their own edges, higher cells over the cliques and cut edges of the level
+ * below. Cells are independent, so every level is split across threads.
+ *
+ * A query searches from both ends. Vertices in the start's or goal's level-1
+ * cell use the graph's own edges; every other vertex uses the cliques and cut
+ * edges of the highest level at which its cell holds neither endpoint.
+ *
+ * Queries fail until the overlay is customized again after an edge change.
+ */
+typedef struct CrpOverlay {
+    int numVertices;            /**< Vertices of the graph it was built for */
+    int numLevels;              /**< Overlay levels */
+    CrpLevel *levels;           /**< levels[0] holds the smallest cells */
+    unsigned int orderVersion;  /**< graph_order_version() the cells were numbered for */
+    unsigned int customizedVersion; /**< graph_version() of the last customization, 0 if none */
+} CrpOverlay;
+
+/**
+ * @brief Partitions the graph into nested cells and customizes once.
+ * Cells come from recursive BFS bisection (graph_partition_bisect()), top
+ * level first; level l cells hold at most cell_size * CRP_LEVEL_FANOUT^(l - 1)
+ * vertices.
+ *
+ * @param graph      The graph (frozen first if needed; weights must be non-negative)
+ * @param num_levels Overlay levels (≥ 1)
+ * @param cell_size  Largest level-1 cell (≥ 1)
+ * @return New overlay, or NULL on invalid input, negative weights or allocation failure
+ */
+CrpOverlay *crp_build(Graph *graph, int num_levels, int cell_size);
+
+/**
+ * @brief Recomputes every clique matrix from the graph's current edge weights,
+ * including pending live updates. Levels run bottom up; the cells of one
+ * level are split across threads.
+ * @param crp         Overlay built from graph
+ * @param graph       The graph
+ * @param num_threads Worker threads (0 = CRP_DEFAULT_THREADS, 1 = no threads)
+ * @return 0 on success, -1 on failure (negative weight, a renumbered graph, or an
+ *         inserted edge between cells at a vertex that is not a boundary vertex:
+ *         rebuild with crp_build())
+ */
+int crp_customize(CrpOverlay *crp, Graph *graph, int num_threads);
+
+/**
+ * @brief Frees an overlay (safe to pass NULL).
+ */
+void crp_free(CrpOverlay *crp);
+
+/**
+ * @brief CRP query – bidirectional Dijkstra over the overlay. Clique arcs on
+ * the result are unpacked by a Dijkstra inside their cell.
+ *
+ * @param crp         Overlay built from graph and customized for its current weights
+ * @param graph       The graph
+ * @param start       Start vertex
+ * @param goal        Goal vertex
+ * @param out_path    Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @return Path length (number of vertices) or 0 on failure
+ */
+int crp_shortest_path(const CrpOverlay *crp, Graph *graph, int start, int goal,
+                      int *out_path, int max_path_len, long long *out_distance);
+
+#endif /* CRP_H */
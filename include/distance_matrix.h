@@ -0,0 +1,35 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include "../include/graph.h"
+#include "../include/ch.h"
+
+/** Worker threads distance_matrix() uses when asked for 0 */
+#define MATRIX_DEFAULT_THREADS 4
+
+/**
+ * @brief Many-to-many distance table over a contraction hierarchy.
+ *
+ * Bucket-based: a backward upward search from every target leaves an entry
+ * (target, distance) in the bucket of each vertex it settles. A forward
+ * upward search from every source then scans the buckets of the vertices it
+ * settles, and the smallest d(s, v) + d(v, t) over them is dist(s, t). Both
+ * searches use stall-on-demand, and stalled vertices neither fill nor scan
+ * buckets. Targets are split across threads for the backward searches and
+ * source rows for the forward ones; each row is written by one thread.
+ *
+ * @param graph       The graph the hierarchy was built from (frozen first if needed)
+ * @param ch          Hierarchy for the graph's current weights (CH or CCH)
+ * @param sources     Source vertices (duplicates allowed)
+ * @param num_sources Number of sources (rows)
+ * @param targets     Target vertices (duplicates allowed)
+ * @param num_targets Number of targets (columns)
+ * @param out         Row-major num_sources × num_targets distances, -1 if unreachable
+ * @param num_threads Worker threads (0 = MATRIX_DEFAULT_THREADS, 1 = no threads)
+ * @return 0 on success, -1 on invalid input, a hierarchy older than the graph's
+ *         last change, or allocation failure
+ */
+int distance_matrix(Graph *graph, const ContractionHierarchy *ch, const int *sources, int num_sources,
+                    const int *targets, int num_targets, long long *out, int num_threads);
+
+#endif /* DISTANCE_MATRIX_H */
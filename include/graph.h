@@ -1,12 +1,19 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/** @brief nameOffsets value of a vertex without a name. */
+#define GRAPH_NO_NAME UINT32_MAX
+
 /**
  * @brief Edge in the adjacency list — represents a neighbor and edge weight.
  */
 typedef struct Edge {
     int to;             /**< Destination vertex index */
-    int weight;         /**< Edge weight (can be negative, zero or positive) */
+    long long weight;   /**< Edge weight (can be negative, zero or positive) */
     struct Edge *next;      /**< Next edge in the linked list */
 } Edge;
 
@@ -17,13 +24,157 @@ typedef struct AdjList {
     Edge *head;             /**< Pointer to first edge / NULL if empty */
 } AdjList;
 
+/** @brief Number of name pool chunks; together they span every offset below GRAPH_NO_NAME. */
+#define GRAPH_NAME_CHUNKS 24
+
+/** @brief Size of the first name pool chunk; chunk k holds GRAPH_NAME_CHUNK_MIN << k bytes. */
+#define GRAPH_NAME_CHUNK_MIN 256u
+
+/**
+ * @brief Vertex name storage: NUL-terminated strings addressed by a 32-bit offset.
+ * Chunk k covers offsets [graph_name_chunk_start(k), graph_name_chunk_start(k + 1)),
+ * so the chunks laid end to end form one contiguous offset space (binary
+ * snapshots store the pool that way). A name never straddles two chunks, and
+ * chunks are never moved, so a name stays put until graph_compact_names().
+ */
+typedef struct NamePool {
+    char *chunks[GRAPH_NAME_CHUNKS]; /**< Chunk k, or NULL while the pool does not reach it */
+    uint32_t size;                   /**< Offset of the next free byte */
+    uint32_t garbage;                /**< Bytes of replaced names no vertex uses any more */
+} NamePool;
+
+/** @brief First pool offset stored in name chunk k (0 ≤ k ≤ GRAPH_NAME_CHUNKS). */
+static inline uint64_t graph_name_chunk_start(int k) {
+    return (uint64_t)GRAPH_NAME_CHUNK_MIN * ((1ull << k) - 1);
+}
+
+/**
+ * @brief Slot of the open-addressing name index (vertex -1 marks an empty slot).
+ */
+typedef struct NameSlot {
+    unsigned int hash;      /**< Cached hash of the vertex name */
+    int vertex;             /**< External vertex ID, or -1 if the slot is empty */
+} NameSlot;
+
+/**
+ * @brief One block of the graph's edge arena.
+ * Edges are bump-allocated from the newest chunk; chunks are only freed as a whole.
+ */
+typedef struct EdgeChunk {
+    struct EdgeChunk *next;   /**< Previously allocated chunk (or NULL) */
+    int used;                 /**< Edges handed out from this chunk */
+    int capacity;             /**< Edges this chunk can hold */
+    Edge edges[];             /**< Edge storage */
+} EdgeChunk;
+
+/**
+ * @brief Frozen adjacency in compressed sparse row (CSR) layout.
+ * Outgoing edges of vertex v occupy the index range [offsets[v], offsets[v + 1])
+ * of the parallel targets/weights arrays. Weights are stored at the narrowest
+ * width (16, 32 or 64 bits) that holds every weight of the graph; read them with
+ * graph_csr_weight() or through GraphEdgeIter.
+ */
+typedef struct GraphCSR {
+    int   numEdges;    /**< Number of directed edges stored */
+    int   weightBits;  /**< Width of each stored weight: 16, 32 or 64 */
+    int  *offsets;     /**< numVertices + 1 entries */
+    int  *targets;     /**< Destination vertex per edge (size = numEdges) */
+    void *weights;     /**< int16_t/int32_t/int64_t weight per edge, see weightBits */
+} GraphCSR;
+
+/**
+ * @brief Compressed adjacency: per vertex, edges sorted by target, each stored as a
+ * LEB128 varint target (zigzag delta to the vertex for the first edge, gap to the
+ * previous target afterwards) followed by the weight in weightBytes bytes.
+ */
+typedef struct GraphCompressed {
+    uint8_t *data;          /**< Encoded edge stream */
+    size_t  *byteOffsets;   /**< numVertices + 1 entries into data */
+    size_t   dataSize;      /**< Bytes used in data */
+    int      weightBytes;   /**< Width of each packed weight: 1, 2, 4 or 8 */
+} GraphCompressed;
+
+/**
+ * @brief One pending change of the delta overlay, keyed by (from, to).
+ * An entry either removes the edge (deleted) or states its current weight;
+ * entries for edges missing from the base are inserted edges.
+ */
+typedef struct DeltaEdge {
+    int from;               /**< Source vertex (internal ID) */
+    int to;                 /**< Destination vertex (internal ID) */
+    long long weight;       /**< Weight of the live edge */
+    unsigned int seq;       /**< Update sequence number of the last change */
+    int nextOfSource;       /**< Next entry with the same source, -1 at the end */
+    int nextOfTarget;       /**< Next entry with the same target, -1 at the end */
+    uint8_t deleted;        /**< Non-zero if the edge is removed */
+    uint8_t inBase;         /**< Non-zero if the base adjacency has from → to */
+} DeltaEdge;
+
+struct DeltaCompaction;
+
+/**
+ * @brief Mutable overlay of edge changes on top of the frozen base adjacency.
+ * Queries see base ⊕ overlay through GraphEdgeIter; compaction folds the overlay
+ * back into a new base CSR.
+ */
+typedef struct GraphDelta {
+    DeltaEdge *entries;         /**< Entry pool (indices stay valid until compaction) */
+    int count;                  /**< Entries in use */
+    int capacity;               /**< Entries allocated */
+    int *headOfSource;          /**< First entry per internal vertex, -1 if none */
+    int *headOfTarget;          /**< First entry into each internal vertex, -1 if none */
+    int *slots;                 /**< Linear-probing (from, to) → entry index, -1 if empty */
+    int slotMask;               /**< Slot count - 1 (a power of two ≥ 2 * capacity) */
+    unsigned int seq;           /**< Last issued update sequence number */
+    unsigned long long baseBound;      /**< Distance bound of the base (see distBits) */
+    unsigned long long absWeightSum;   /**< Sum of |weight| written through the overlay */
+    long long maxWeight;               /**< Largest weight written through the overlay */
+    struct DeltaCompaction *job;       /**< Running background compaction, or NULL */
+} GraphDelta;
+
 /**
  * @brief Graph structure — adjacency list representation with optional vertex names.
+ *
+ * The linked adjacency lists are the mutable builder used while loading.
+ * Queries run on the contiguous CSR copy produced by graph_freeze().
+ * Graphs loaded from a binary snapshot have no builder (array == NULL): their CSR
+ * arrays and names point into a shared read-only mapping and cannot be modified.
+ *
+ * Every public function takes and returns external vertex IDs (the IDs of the
+ * input file). The CSR may be stored in a different internal order chosen for
+ * memory locality; toInternal/toExternal translate between the two.
+ *
+ * Freezing also picks the integer widths the algorithm kernels run with:
+ * csr.weightBits for stored weights and distBits for distance accumulators,
+ * each the narrowest of 16/32/64 bits that cannot overflow on this graph.
  */
 typedef struct Graph {
     int numVertices;  /**< Number of vertices */
     AdjList* array;        /**< Array of adjacency lists (size = numVertices) */
-    char** names;        /**< Array of dynamically allocated names (can be NULL) */
+    NamePool names;        /**< Deduplicated vertex names */
+    uint32_t *nameOffsets; /**< Offset into names per vertex, GRAPH_NO_NAME if unnamed */
+    NameSlot *nameIndex;   /**< Linear-probing name → vertex index (NULL until a name is set) */
+    int nameIndexMask;     /**< Index capacity - 1 (capacity is a power of two ≥ 2 * numVertices) */
+    EdgeChunk *edgeChunks; /**< Arena owning every Edge of the adjacency lists */
+    GraphCSR csr;          /**< Frozen query representation (valid while frozen != 0) */
+    int frozen;            /**< Non-zero when csr reflects the adjacency lists */
+    int symmetric;         /**< Non-zero while every edge was added undirected */
+    int distBits;          /**< Width of distance accumulators: 16, 32 or 64 (set by freeze) */
+    int minWeightBits;     /**< Lower bound for csr.weightBits (0 = automatic) */
+    int minDistBits;       /**< Lower bound for distBits (0 = automatic) */
+    long long maxWeight;   /**< Largest base edge weight, at least 0 (-1 = not computed yet) */
+    GraphCSR *reverse;     /**< Cached transpose of the base (NULL until built, &csr if symmetric) */
+    GraphCompressed *compressed; /**< Compressed adjacency; when set csr keeps only offsets */
+    GraphDelta *delta;     /**< Pending live edge updates (NULL until the first update) */
+    int *toInternal;       /**< External → internal vertex ID (NULL = identity) */
+    int *toExternal;       /**< Internal → external vertex ID (NULL = identity) */
+    unsigned int version;  /**< Bumped by every change a query can observe (see graph_version()) */
+    unsigned int orderVersion; /**< Bumped whenever internal vertex IDs are renumbered */
+    double *coords;        /**< Optional x/y pairs per external vertex (NULL if none) */
+    void *mapping;         /**< Read-only snapshot backing csr and names (NULL if owned) */
+    int csrInMapping;      /**< Non-zero while csr points into mapping */
+    size_t mappingSize;    /**< Size of mapping in bytes */
+    void (*unmap)(void *mapping, size_t size); /**< Releases mapping in graph_free() */
 } Graph;
 
 /* ──────────────────────────────────────────────────────────────────────────────
@@ -50,9 +201,21 @@ void graph_free(Graph *graph);
  * @param destination Destination vertex index
  * @param weight Edge weight (may be negative)
  * @param undirected If non-zero, adds edge in both directions
- * @return 0 on success, -1 on failure (invalid indices, allocation error, NULL graph)
+ * Only the loader's builder accepts edges: the call is ignored for snapshot-backed
+ * or compacted graphs and while a compaction runs (use graph_insert_edge() there).
+ * @return 0 on success, -1 on failure (invalid indices, allocation error, NULL graph,
+ *         snapshot-backed graph)
  */
-void addWeightedEdge(Graph *graph, int source, int destination, int weight, int undirected);
+void addWeightedEdge(Graph *graph, int source, int destination, long long weight, int undirected);
+
+/**
+ * @brief Pre-sizes the edge arena so the next `count` edge insertions need no further allocation.
+ * Undirected insertions consume two edges each.
+ * @param graph The graph
+ * @param count Number of directed edges expected
+ * @return 0 on success, -1 on failure (NULL graph, invalid count, allocation error)
+ */
+int graph_reserve_edges(Graph *graph, int count);
 
 /**
  * @brief Adds an unweighted edge (weight = 1).
@@ -60,12 +223,396 @@ void addWeightedEdge(Graph *graph, int source, int destination, int weight, int
  */
 void addEdge(Graph *graph, int source, int destination, int undirected);
 
+/* ──────────────────────────────────────────────────────────────────────────────
+   Frozen (CSR) representation
+   ────────────────────────────────────────────────────────────────────────────── */
+
+/**
+ * @brief Builds the contiguous CSR arrays from the adjacency lists.
+ * Edge order per vertex matches the list order (most recently added first).
+ * Calling it on an already frozen graph is a no-op; any later edge insertion
+ * marks the graph unfrozen again and the next call rebuilds the arrays.
+ * @param graph The graph
+ * @return 0 on success, -1 on failure (NULL graph, allocation error)
+ */
+int graph_freeze(Graph *graph);
+
+/**
+ * @brief Narrowest weight width (16, 32 or 64) holding every value in [lo, hi].
+ */
+int graph_weight_bits_for_range(long long lo, long long hi);
+
+/**
+ * @brief Narrowest distance width (16, 32 or 64) whose largest value, reserved
+ * for "unreached", stays above bound.
+ */
+int graph_dist_bits_for_bound(unsigned long long bound);
+
+/**
+ * @brief Largest edge weight of base ⊕ overlay, or 0 if every weight is negative
+ * or zero. Recorded by graph_freeze(); computed once for snapshot-backed and
+ * compacted graphs. Updates can only raise it until the next compaction.
+ * @return Weight bound, or -1 on invalid input
+ */
+long long graph_max_weight(Graph *graph);
+
+/**
+ * @brief Forces wider weight storage and distance accumulators than freezing
+ * would pick (e.g. before applying updates with larger weights).
+ * Widths are only ever raised: the graph uses max(automatic, requested).
+ * The graph is refrozen, which also returns a compressed graph to the plain layout.
+ * @param graph       The graph (must still have its builder lists)
+ * @param weight_bits 0, 16, 32 or 64
+ * @param dist_bits   0, 16, 32 or 64
+ * @return 0 on success, -1 on invalid widths or a read-only graph
+ */
+int graph_select_widths(Graph *graph, int weight_bits, int dist_bits);
+
+/**
+ * @brief Switches a frozen graph to the compressed adjacency mode.
+ * Edges of each vertex are sorted by target, encoded into one byte stream and the
+ * plain targets/weights arrays are released (offsets stay, so edge IDs remain
+ * offsets[v] + k). Traversals must go through graph_edges_begin()/graph_edges_next().
+ * Refreezing after an edge insertion returns the graph to the plain layout.
+ * @param graph The graph (must not be snapshot-backed)
+ * @return 0 on success, -1 on failure
+ */
+int graph_compress(Graph *graph);
+
+/**
+ * @brief Memory used by the frozen adjacency (offsets, targets, weights or the
+ * compressed stream), excluding the builder lists.
+ * @return Bytes, or 0 for an unfrozen/NULL graph
+ */
+size_t graph_adjacency_bytes(const Graph *graph);
+
+/**
+ * @brief Replaces the frozen adjacency with an externally built CSR in internal order.
+ * The graph takes ownership of csr's arrays (csr is cleared). The builder lists,
+ * compressed stream and reverse cache are released, so the graph behaves like one
+ * after graph_drop_builder().
+ * @param dist_bits Distance width that is safe for the new adjacency
+ * @return 0 on success, -1 on invalid input
+ */
+int graph_install_csr(Graph *graph, GraphCSR *csr, int dist_bits);
+
+/**
+ * @brief Frees the linked-list builder and its edge arena once the graph is frozen.
+ * The graph then behaves like a snapshot-backed one: queries work, edge insertion
+ * is ignored.
+ * @return 0 on success, -1 if the graph is NULL or cannot be frozen
+ */
+int graph_drop_builder(Graph *graph);
+
+/**
+ * @brief Returns the incoming-edge adjacency (transposed CSR), building it on first use.
+ * Edges into internal vertex v occupy [offsets[v], offsets[v + 1]); targets holds
+ * the source vertex of each edge and weights its weight. For uncompressed graphs
+ * built only from undirected edges this is the forward CSR itself.
+ * Only the base is transposed: iterate it with graph_reverse_edges_begin() so
+ * pending overlay updates are applied on the fly, as for outgoing edges. The
+ * cache survives live updates and is rebuilt only after the base changes
+ * (refreeze, compaction, renumbering or compression).
+ * @param graph The graph (frozen first if needed)
+ * @return Reverse CSR owned by the graph, or NULL on failure
+ */
+const GraphCSR *graph_reverse(Graph *graph);
+
+/**
+ * @brief Renumbers the internal CSR order of a frozen graph.
+ * External IDs, names and coordinates are unchanged; only the storage order of
+ * vertices moves. The permutation is remembered and reapplied when the graph
+ * is refrozen after edge insertion.
+ * @param graph      The graph (must not be snapshot-backed)
+ * @param new_of_old For every current internal ID, its new internal ID (a permutation)
+ * @return 0 on success, -1 on failure (invalid permutation, read-only graph, allocation error)
+ */
+int graph_apply_permutation(Graph *graph, const int *new_of_old);
+
+/**
+ * @brief Change counter of the graph, starting at 1.
+ * Any edge update, rebuild of the base arrays (refreeze, compaction,
+ * compression) or renumbering raises it. Preprocessed structures record it at
+ * build time and refuse to answer once it differs.
+ * @return Current version, or 0 for a NULL graph
+ */
+unsigned int graph_version(const Graph *graph);
+
+/**
+ * @brief Counter raised only when internal vertex IDs are renumbered
+ * (graph_apply_permutation()). Structures keyed by internal ID whose metric
+ * can be refreshed in place (CRP, CCH) check it before customizing.
+ * @return Current order version, or 0 for a NULL graph
+ */
+unsigned int graph_order_version(const Graph *graph);
+
+/**
+ * @brief Translates an external vertex ID to the internal CSR index.
+ * @return Internal index, or -1 for invalid input
+ */
+int graph_to_internal(const Graph *graph, int id);
+
+/**
+ * @brief Translates an internal CSR index back to the external vertex ID.
+ * @return External ID, or -1 for invalid input
+ */
+int graph_to_external(const Graph *graph, int v);
+
+/* ──────────────────────────────────────────────────────────────────────────────
+   Live updates (delta overlay)
+   ────────────────────────────────────────────────────────────────────────────── */
+
+/**
+ * @brief Inserts the edge source → destination into a frozen graph.
+ * The change goes into the delta overlay and is visible to the next query.
+ * An edge already in the overlay is found by hash in expected O(1); the first
+ * change of an edge also scans the source vertex's base edges once, O(out-degree).
+ * Updates never rebuild the reverse adjacency (see graph_reverse()).
+ * @return 0 on success, -1 on invalid input, allocation error or if the edge exists
+ */
+int graph_insert_edge(Graph *graph, int source, int destination, long long weight);
+
+/**
+ * @brief Removes the edge source → destination (all parallel copies of it).
+ * @return 0 on success, -1 on invalid input or if there is no such edge
+ */
+int graph_delete_edge(Graph *graph, int source, int destination);
+
+/**
+ * @brief Changes the weight of the edge source → destination.
+ * @return 0 on success, -1 on invalid input or if there is no such edge
+ */
+int graph_set_edge_weight(Graph *graph, int source, int destination, long long weight);
+
+/**
+ * @brief Number of pending overlay entries (0 when the base is up to date).
+ */
+int graph_delta_size(const Graph *graph);
+
+/**
+ * @brief Folds the overlay into a new base CSR.
+ * With background != 0 the new base is built on a separate thread. Queries
+ * and further updates keep running on base ⊕ overlay. The finished base is
+ * swapped in by the first graph_freeze() (i.e. the next query) after it is
+ * ready, and only the updates made after the compaction started stay in the
+ * overlay. The result drops the builder lists; addWeightedEdge() is then ignored.
+ * A Graph is still used from one thread; only the build runs in the background.
+ * @return 0 on success or when there is nothing to compact, -1 on failure
+ */
+int graph_compact(Graph *graph, int background);
+
+/**
+ * @brief Waits for a background compaction and installs its result.
+ * @return 0 on success or if none is running, -1 if the compaction failed
+ */
+int graph_compact_wait(Graph *graph);
+
+/**
+ * @brief Installs a finished background compaction without waiting.
+ * @return 1 if a new base was installed, 0 otherwise
+ */
+int graph_delta_poll(Graph *graph);
+
+/**
+ * @brief Recomputes which overlay entries exist in the base after it was rebuilt.
+ */
+void graph_delta_rebase(Graph *graph);
+
+/**
+ * @brief Stops any background compaction and frees the overlay.
+ */
+void graph_delta_free(Graph *graph);
+
+/* ──────────────────────────────────────────────────────────────────────────────
+   Edge iteration (plain or compressed layout)
+   ────────────────────────────────────────────────────────────────────────────── */
+
+/**
+ * @brief Reads the weight of edge e from a plain CSR of any weight width.
+ */
+static inline long long graph_csr_weight(const GraphCSR *csr, int e) {
+    switch (csr->weightBits) {
+        case 16: return ((const int16_t *)csr->weights)[e];
+        case 32: return ((const int32_t *)csr->weights)[e];
+        default: return ((const int64_t *)csr->weights)[e];
+    }
+}
+
+/**
+ * @brief Stores w as the weight of edge e of a plain CSR (w must fit weightBits).
+ */
+static inline void graph_csr_set_weight(GraphCSR *csr, int e, long long w) {
+    switch (csr->weightBits) {
+        case 16: ((int16_t *)csr->weights)[e] = (int16_t)w; break;
+        case 32: ((int32_t *)csr->weights)[e] = (int32_t)w; break;
+        default: ((int64_t *)csr->weights)[e] = (int64_t)w; break;
+    }
+}
+
+/**
+ * @brief Cursor over the outgoing edges of one vertex.
+ * Pending overlay updates (graph_insert_edge() etc.) are applied on the fly.
+ * Usage:
+ *   GraphEdgeIter it;
+ *   for (graph_edges_begin(g, v, &it); graph_edges_next(&it); ) { it.to, it.weight, it.edge }
+ */
+typedef struct GraphEdgeIter {
+    int to;                 /**< Target of the current edge (internal ID) */
+    long long weight;       /**< Weight of the current edge */
+    int edge;               /**< ID of the current edge (index into per-edge arrays) */
+    int end;                /**< One past the last edge ID of the vertex */
+    int first;              /**< First edge ID of the vertex */
+    const int *targets;     /**< Plain layout: target array (NULL when compressed) */
+    const void *weights;    /**< Plain layout: weight array */
+    const uint8_t *cursor;  /**< Compressed layout: next encoded byte */
+    int weightBytes;        /**< Width of one stored weight in bytes (either layout) */
+    const GraphDelta *delta; /**< Overlay with entries for this vertex, else NULL */
+    int source;             /**< Vertex whose edges are iterated */
+    int deltaNext;          /**< -2 while on base edges, then next overlay entry (-1 = done) */
+    int reverse;            /**< Non-zero when iterating incoming edges (it->to is the source) */
+} GraphEdgeIter;
+
+/**
+ * @brief Slow path of graph_edges_next() for vertices with overlay entries.
+ * Inserted edges have no base edge ID and are reported with edge == -1.
+ */
+int graph_delta_edges_next(GraphEdgeIter *it);
+
+/**
+ * @brief Starts iterating the outgoing edges of internal vertex v of a frozen graph.
+ */
+static inline void graph_edges_begin(const Graph *graph, int v, GraphEdgeIter *it) {
+    it->first = graph->csr.offsets[v];
+    it->edge = it->first - 1;
+    it->end = graph->csr.offsets[v + 1];
+    it->to = v;
+    if (graph->compressed) {
+        it->targets = NULL;
+        it->weights = NULL;
+        it->cursor = graph->compressed->data + graph->compressed->byteOffsets[v];
+        it->weightBytes = graph->compressed->weightBytes;
+    } else {
+        it->targets = graph->csr.targets;
+        it->weights = graph->csr.weights;
+        it->cursor = NULL;
+        it->weightBytes = graph->csr.weightBits / 8;
+    }
+    it->source = v;
+    it->deltaNext = -2;
+    it->reverse = 0;
+    it->delta = (graph->delta && graph->delta->headOfSource[v] >= 0) ? graph->delta : NULL;
+}
+
+/**
+ * @brief Starts iterating vertex v of a plain CSR (e.g. the reverse adjacency).
+ */
+static inline void graph_csr_edges_begin(const GraphCSR *csr, int v, GraphEdgeIter *it) {
+    it->first = csr->offsets[v];
+    it->edge = it->first - 1;
+    it->end = csr->offsets[v + 1];
+    it->to = v;
+    it->targets = csr->targets;
+    it->weights = csr->weights;
+    it->cursor = NULL;
+    it->weightBytes = csr->weightBits / 8;
+    it->source = v;
+    it->deltaNext = -2;
+    it->reverse = 0;
+    it->delta = NULL;
+}
+
+/**
+ * @brief Starts iterating the incoming edges of internal vertex v.
+ * rev is graph_reverse(graph); graph_edges_next() then reports each edge u → v
+ * as it->to = u, with pending overlay updates applied.
+ */
+static inline void graph_reverse_edges_begin(const Graph *graph, const GraphCSR *rev, int v,
+                                             GraphEdgeIter *it) {
+    graph_csr_edges_begin(rev, v, it);
+    it->reverse = 1;
+    it->delta = (graph->delta && graph->delta->headOfTarget[v] >= 0) ? graph->delta : NULL;
+}
+
+/**
+ * @brief Advances to the next base edge, ignoring the overlay.
+ * @return 1 if it->to / it->weight / it->edge now describe an edge, 0 when done
+ */
+static inline int graph_base_edges_next(GraphEdgeIter *it) {
+    if (++it->edge >= it->end) {
+        return 0;
+    }
+
+    if (it->targets) {
+        it->to = it->targets[it->edge];
+        switch (it->weightBytes) {
+            case 2:  it->weight = ((const int16_t *)it->weights)[it->edge]; break;
+            case 4:  it->weight = ((const int32_t *)it->weights)[it->edge]; break;
+            default: it->weight = ((const int64_t *)it->weights)[it->edge]; break;
+        }
+        return 1;
+    }
+
+    uint32_t x = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = *it->cursor++;
+        x |= (uint32_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    /* it->to holds the vertex itself before the first edge, which is zigzag-encoded */
+    if (it->edge == it->first) {
+        it->to += (int)((x >> 1) ^ (0u - (x & 1)));
+    } else {
+        it->to += (int)x;
+    }
+
+    switch (it->weightBytes) {
+        case 1: {
+            int8_t w8 = (int8_t)it->cursor[0];
+            it->weight = w8;
+            break;
+        }
+        case 2: {
+            int16_t w16;
+            memcpy(&w16, it->cursor, sizeof(w16));
+            it->weight = w16;
+            break;
+        }
+        case 4: {
+            int32_t w32;
+            memcpy(&w32, it->cursor, sizeof(w32));
+            it->weight = w32;
+            break;
+        }
+        default: {
+            int64_t w64;
+            memcpy(&w64, it->cursor, sizeof(w64));
+            it->weight = w64;
+            break;
+        }
+    }
+    it->cursor += it->weightBytes;
+    return 1;
+}
+
+/**
+ * @brief Advances to the next edge, with pending overlay changes applied.
+ * @return 1 if it->to / it->weight / it->edge now describe an edge, 0 when done
+ */
+static inline int graph_edges_next(GraphEdgeIter *it) {
+    return it->delta ? graph_delta_edges_next(it) : graph_base_edges_next(it);
+}
+
 /* ──────────────────────────────────────────────────────────────────────────────
    Vertex naming support
    ────────────────────────────────────────────────────────────────────────────── */
 
 /**
  * @brief Assigns a name to a vertex (replaces any previous name).
+ * Names are interned: vertices with equal names share one copy in the pool.
+ * Ignored for snapshot-backed graphs.
  * @param graph The graph
  * @param id Vertex index
  * @param name New name (NULL is allowed → removes name)
@@ -74,16 +621,51 @@ void graphSetName(Graph *graph, int id, const char *name);
 
 /**
  * @brief Returns the name of a vertex (or NULL if not set).
+ * The pointer refers into the graph's name pool. Renaming vertices never moves
+ * pooled names, so it stays valid until graph_compact_names() (also run by
+ * graph_build_name_index()) or graph_free().
  * @return Read-only pointer to name string or NULL
  */
 const char *graphGetName(const Graph *graph, int id);
 
 /**
  * @brief Finds vertex index by its name (exact match, case-sensitive).
+ * Uses the hash index (expected O(1)); if several vertices share a name the
+ * lowest ID is returned.
  * @return Vertex index or -1 if not found or invalid input
  */
 int graph_find_vertex_by_name(const Graph *graph, const char *name);
 
+/**
+ * @brief (Re)builds the name index from the current names.
+ * graphSetName() keeps the index up to date; this is for graphs whose names
+ * were attached without it (e.g. snapshot loading). Compacts the pool first
+ * (see graph_compact_names()).
+ * @return 0 on success, -1 on failure (lookups then fall back to a linear scan)
+ */
+int graph_build_name_index(Graph *graph);
+
+/**
+ * @brief Copies the names still in use into a fresh pool and frees the old one,
+ * reclaiming the bytes of replaced names (names.garbage). Invalidates every
+ * pointer returned by graphGetName(). Does nothing if there is no garbage.
+ * @return 0 on success, -1 on allocation failure (the pool is left as it was)
+ *         or for snapshot-backed graphs
+ */
+int graph_compact_names(Graph *graph);
+
+/**
+ * @brief Assigns planar coordinates to a vertex (used by space-filling orders).
+ * Ignored for snapshot-backed graphs.
+ */
+void graphSetCoordinates(Graph *graph, int id, double x, double y);
+
+/**
+ * @brief Reads the coordinates of a vertex.
+ * @return 1 if coordinates are available, 0 otherwise
+ */
+int graphGetCoordinates(const Graph *graph, int id, double *x, double *y);
+
 /* ──────────────────────────────────────────────────────────────────────────────
    Debugging / output
    ────────────────────────────────────────────────────────────────────────────── */
@@ -0,0 +1,83 @@
+#ifndef HUB_LABELS_H
+#define HUB_LABELS_H
+
+#include "../include/graph.h"
+#include "../include/ch.h"
+
+/** Hub ID closing every label (merge loops need no bounds checks) */
+#define HUB_LABEL_END 0x7fffffff
+
+/**
+ * @brief Hub labeling distance oracle over a graph's internal vertices.
+ *
+ * Every vertex v has a forward label (hubs h with dist(v, h)) and a backward
+ * label (hubs h with dist(h, v)). For every pair s, t some hub on a shortest
+ * s → t path appears in both the forward label of s and the backward label of
+ * t, so dist(s, t) is the minimum of d_f(s, h) + d_b(h, t) over their common
+ * hubs.
+ *
+ * Labels are flat: the forward label of v occupies
+ * [fwdOffsets[v], fwdOffsets[v + 1]) of fwdHubs / fwdDists / fwdNext, sorted by
+ * hub ID and closed by a HUB_LABEL_END entry. Hub IDs are importance ranks
+ * (0 = most important); hubVertex maps them back to vertices. The next and
+ * prev arrays store the neighbour of v on its shortest path to / from the hub,
+ * which is itself labelled with that hub, so paths unfold hop by hop.
+ *
+ * Labels reflect the weights at build time; queries fail once the graph has
+ * changed, so rebuild them after edge changes.
+ */
+typedef struct HubLabels {
+    int numVertices;        /**< Vertices of the graph it was built for */
+    unsigned int graphVersion; /**< graph_version() at build time */
+    long long numEntries;   /**< Label entries in both directions, sentinels excluded */
+    int *hubVertex;         /**< Internal vertex per hub ID */
+    int *fwdOffsets;        /**< Forward label of v: [fwdOffsets[v], fwdOffsets[v + 1]) */
+    int *fwdHubs;           /**< Hub ID, ascending within a label */
+    long long *fwdDists;    /**< dist(v, hub) */
+    int *fwdNext;           /**< Successor of v towards the hub, -1 at the hub itself */
+    int *bwdOffsets;        /**< Backward label of v: [bwdOffsets[v], bwdOffsets[v + 1]) */
+    int *bwdHubs;           /**< Hub ID, ascending within a label */
+    long long *bwdDists;    /**< dist(hub, v) */
+    int *bwdPrev;           /**< Predecessor of v coming from the hub, -1 at the hub itself */
+} HubLabels;
+
+/**
+ * @brief Pruned landmark labeling in hierarchy order.
+ * Hubs are processed from the highest rank of the given hierarchy down. Each
+ * runs a backward and a forward Dijkstra that stops expanding any vertex whose
+ * distance the labels built so far already cover.
+ *
+ * @param graph The graph (frozen first if needed; weights must be non-negative)
+ * @param order Any hierarchy built from graph (CH or CCH); only its ranks are used
+ * @return New labels, or NULL on invalid input, negative weights or allocation failure
+ */
+HubLabels *hub_labels_build(Graph *graph, const ContractionHierarchy *order);
+
+/**
+ * @brief Frees hub labels (safe to pass NULL).
+ */
+void hub_labels_free(HubLabels *hl);
+
+/**
+ * @brief Distance query – one merge of two sorted labels.
+ * @return Shortest distance from start to goal, -1 if unreachable, on invalid input
+ *         or once the graph has changed
+ */
+long long hub_labels_distance(const HubLabels *hl, const Graph *graph, int start, int goal);
+
+/**
+ * @brief Distance query plus path recovery through the stored next / prev vertices.
+ *
+ * @param hl          Labels built from graph
+ * @param graph       The graph
+ * @param start       Start vertex
+ * @param goal        Goal vertex
+ * @param out_path    Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @return Path length (number of vertices) or 0 on failure or a changed graph
+ */
+int hub_labels_shortest_path(const HubLabels *hl, const Graph *graph, int start, int goal,
+                             int *out_path, int max_path_len, long long *out_distance);
+
+#endif /* HUB_LABELS_H */
@@ -2,6 +2,12 @@
 #define IO_H
 
 #include "../include/graph.h"
+#include "../include/ch.h"
+#include "../include/hub_labels.h"
+#include "../include/arc_flags.h"
+#include "../include/crp.h"
+#include "../include/tnr.h"
+#include "../include/search_session.h"
 
 /**
  * @brief Result structure returned by pathfinding wrapper functions.
@@ -10,7 +16,8 @@ typedef struct {
     int     found;      /**< 1 if a path was found, 0 otherwise */
     int    *path;       /**< Dynamically allocated array of vertex indices (start → goal) */
     int     path_len;   /**< Number of vertices in the path (including start and goal) */
-    int     distance;   /**< For BFS: number of hops, for others: sum of edge weights */
+    long long distance; /**< For BFS: number of hops, for others: sum of edge weights */
+    int     settled;    /**< Vertices the search settled (0 where not tracked: DFS, Bellman-Ford) */
 } PathResult;
 
 /* ============================================================================
@@ -22,7 +29,7 @@ typedef struct {
  *
  * File format:
  *   First line:        num_vertices num_edges directed(0/1)
- *   Next num_vertices lines:  id name
+ *   Next num_vertices lines:  id name [x y]   (optional planar coordinates)
  *   Next num_edges lines:     from to weight
  *
  * @param filename Path to the graph file
@@ -30,6 +37,52 @@ typedef struct {
  */
 Graph *load_graph_from_file(const char *filename);
 
+/* ============================================================================
+   Binary graph snapshots
+   ========================================================================== */
+
+/**
+ * @brief Writes the frozen graph (CSR topology, weights and names) as a versioned
+ * binary snapshot that load_graph_snapshot() can map without parsing.
+ * A vertex order applied with graph_reorder() is stored too, so reordering can
+ * be done once offline.
+ * @param g        The graph (frozen first if needed)
+ * @param filename Output path
+ * @return 0 on success, -1 on error
+ */
+int save_graph_snapshot(Graph *g, const char *filename);
+
+/**
+ * @brief Maps a binary snapshot read-only and returns a ready-to-query graph.
+ * CSR arrays and names point straight into the shared mapping, so processes
+ * loading the same file share the page cache. The result is read-only:
+ * edge insertion and renaming are ignored. graph_free() unmaps the file.
+ *
+ * Only the header and the section bounds are checked, in O(1): the distance
+ * width and the symmetry flag are taken from the header and the section
+ * contents are trusted. Use load_graph_snapshot_checked() for files that may
+ * be corrupt or come from elsewhere.
+ * @param filename Path to a file written by save_graph_snapshot()
+ * @return Graph* backed by the mapping, or NULL on error
+ */
+Graph *load_graph_snapshot(const char *filename);
+
+/**
+ * @brief load_graph_snapshot() plus one O(V + E log E) pass over the sections:
+ * monotone offsets, targets inside the graph, name offsets inside the pool, a
+ * name index with a free slot and a vertex order whose two maps are inverse
+ * permutations. The distance width is recomputed from the edges, and the
+ * symmetry flag is kept only if every edge has an exact reverse twin.
+ * @return Graph* backed by the mapping, or NULL on error or corrupt sections
+ */
+Graph *load_graph_snapshot_checked(const char *filename);
+
+/**
+ * @brief Checks whether a file starts with the binary snapshot magic.
+ * @return 1 for a snapshot file, 0 otherwise (including unreadable files)
+ */
+int is_graph_snapshot_file(const char *filename);
+
 /* ============================================================================
    PathResult creation wrappers
    ========================================================================== */
@@ -52,6 +105,59 @@ PathResult pathresult_from_dfs(Graph *g, int start, int goal);
  */
 PathResult pathresult_from_dijkstra(Graph *g, int start, int goal);
 
+/**
+ * @brief Runs bidirectional Dijkstra and returns a PathResult.
+ * Distance = total edge weight sum.
+ */
+PathResult pathresult_from_bidirectional_dijkstra(Graph *g, int start, int goal);
+
+/**
+ * @brief Runs bidirectional A* and returns a PathResult.
+ * Distance = total edge weight sum.
+ */
+PathResult pathresult_from_bidirectional_astar(Graph *g, int start, int goal, int (*heuristic)(int, int));
+
+/**
+ * @brief Runs a Contraction Hierarchies query and returns a PathResult with
+ * the shortcuts unpacked into original edges.
+ * Distance = total edge weight sum.
+ */
+PathResult pathresult_from_ch(Graph *g, const ContractionHierarchy *ch, int start, int goal);
+
+/**
+ * @brief Answers a query from hub labels and returns a PathResult with the
+ * path unfolded through the labels' next / prev vertices.
+ * Distance = total edge weight sum; no vertices are settled.
+ */
+PathResult pathresult_from_hub_labels(Graph *g, const HubLabels *hl, int start, int goal);
+
+/**
+ * @brief Runs Dijkstra pruned by arc flags and returns a PathResult.
+ * Distance = total edge weight sum.
+ */
+PathResult pathresult_from_arc_flags(Graph *g, const ArcFlags *af, int start, int goal);
+
+/**
+ * @brief Runs a CRP overlay query and returns a PathResult with the clique
+ * arcs unpacked into original edges.
+ * Distance = total edge weight sum.
+ */
+PathResult pathresult_from_crp(Graph *g, const CrpOverlay *crp, int start, int goal);
+
+/**
+ * @brief Runs a transit-node routing query (table lookups, or the CH search
+ * for local pairs) and returns a PathResult.
+ * Distance = total edge weight sum.
+ */
+PathResult pathresult_from_tnr(Graph *g, const TransitNodeRouting *tnr, const ContractionHierarchy *ch,
+                               int start, int goal);
+
+/**
+ * @brief Resumes a search session until goal is settled and returns its PathResult.
+ * settled counts only the vertices this call settled.
+ */
+PathResult pathresult_from_session(SearchSession *session, int goal);
+
 /**
  * @brief Runs A* (with NULL heuristic → Dijkstra behavior) and returns PathResult.
  */
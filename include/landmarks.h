@@ -0,0 +1,120 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <stdint.h>
+
+#include "../include/graph.h"
+
+/**
+ * @brief Strategies for picking ALT landmarks.
+ */
+typedef enum {
+    LANDMARKS_FARTHEST = 0, /**< Each landmark is the vertex farthest from the ones already chosen */
+    LANDMARKS_AVOID         /**< Goldberg–Werneck avoid: leaf of the shortest-path subtree the
+                                 current landmarks bound worst */
+} LandmarkStrategy;
+
+/** Table entry for a vertex the landmark cannot reach / be reached from */
+#define LANDMARK_UNREACHABLE (-1LL)
+
+/**
+ * @brief ALT (A*, landmarks, triangle inequality) preprocessing result.
+ *
+ * For every landmark L and vertex v the tables hold d(L, v) and d(v, L). By the
+ * triangle inequality d(v, t) ≥ max(d(L, t) - d(L, v), d(v, L) - d(t, L)) for
+ * every L, which gives a consistent A* heuristic on any graph with non-negative
+ * weights. Tables are indexed by external vertex ID, landmark-major per vertex
+ * (entry [v * count + i]), so one heuristic call reads two short runs.
+ *
+ * Lower weights than at build time (live updates) can make the bounds
+ * inadmissible, so the set remembers graph_version() and any later change makes
+ * it stale (see landmarks_current()); rebuild the tables after such updates.
+ */
+typedef struct Landmarks {
+    int numVertices;            /**< Vertices of the graph the tables were built for */
+    int count;                  /**< Number of landmarks */
+    int *vertices;              /**< External ID of each landmark */
+    long long *fromLandmark;    /**< d(L_i, v) at [v * count + i], or LANDMARK_UNREACHABLE */
+    long long *toLandmark;      /**< d(v, L_i) at [v * count + i], or LANDMARK_UNREACHABLE */
+    unsigned int graphVersion;  /**< graph_version() when the tables were built or loaded */
+    int numEdges;               /**< Edges of the graph, checked by landmarks_load() */
+    uint64_t edgeHash;          /**< Order-independent hash of those edges by external ID */
+} Landmarks;
+
+/**
+ * @brief Picks up to count landmarks and computes their distance tables.
+ * Runs two one-to-all Dijkstra searches per landmark (forward, and backward
+ * over graph_reverse()); the avoid strategy runs one more per landmark.
+ * Fewer landmarks are returned if the graph has fewer vertices.
+ *
+ * @param g        The graph (frozen first if needed; weights must be non-negative)
+ * @param count    Number of landmarks (> 0)
+ * @param strategy Selection strategy
+ * @return New landmark set, or NULL on invalid input, negative weights or allocation failure
+ */
+Landmarks *landmarks_build(Graph *g, int count, LandmarkStrategy strategy);
+
+/**
+ * @brief Frees a landmark set (safe to pass NULL).
+ * Must not be the active set (see landmarks_set_active()).
+ */
+void landmarks_free(Landmarks *lm);
+
+/**
+ * @brief Triangle-inequality lower bound on the distance from → to (external IDs).
+ * @return Lower bound ≥ 0, 0 if no landmark gives a bound
+ */
+long long landmarks_lower_bound(const Landmarks *lm, int from, int to);
+
+/**
+ * @brief Writes the landmarks and both tables to a binary file.
+ * @return 0 on success, -1 on failure
+ */
+int landmarks_save(const Landmarks *lm, const char *filename);
+
+/**
+ * @brief Reads tables written by landmarks_save().
+ * @param g Graph the tables are used with (frozen first if needed); its vertex
+ *          count, edge count and edge hash must match the file
+ * @return New landmark set, or NULL on I/O error, corrupt file or mismatching graph
+ */
+Landmarks *landmarks_load(const char *filename, Graph *g);
+
+/**
+ * @brief Makes lm the set landmark_heuristic() reads (NULL to clear).
+ */
+void landmarks_set_active(const Landmarks *lm);
+
+/**
+ * @brief The set landmark_heuristic() currently reads, or NULL.
+ */
+const Landmarks *landmarks_active(void);
+
+/**
+ * @brief Whether lm still describes g: same vertex count and graph_version().
+ * Edge updates, compaction, compression and renumbering all make a set stale.
+ * @return 1 if current, 0 if stale or NULL
+ */
+int landmarks_current(const Landmarks *lm, const Graph *g);
+
+/**
+ * @brief A* heuristic over the active landmark set: landmarks_lower_bound(), capped
+ * at INT_MAX. Consistent, so it also suits bidirectional A*. Returns 0 if no set is active.
+ * The A* entry points refuse this heuristic while the active set is stale.
+ */
+int landmark_heuristic(int from, int to);
+
+/**
+ * @brief Whether an A* search on g may use heuristic: 0 only if it is
+ * landmark_heuristic() and the active set is stale (see landmarks_current()).
+ * Call after freezing g.
+ */
+int landmarks_heuristic_usable(int (*heuristic)(int, int), const Graph *g);
+
+/**
+ * @brief Parses "farthest" or "avoid".
+ * @return 0 on success, -1 for an unknown name
+ */
+int landmark_strategy_from_string(const char *name, LandmarkStrategy *out);
+
+#endif /* LANDMARKS_H */
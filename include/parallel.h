@@ -0,0 +1,52 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+/** Most threads any parallel phase starts, whatever the caller asks for */
+#define PARALLEL_MAX_THREADS 64
+
+/**
+ * @brief The threads of one parallel_run() call.
+ * Members can wait for each other with parallel_barrier().
+ */
+typedef struct ParallelTeam ParallelTeam;
+
+/**
+ * @brief Work of one team member.
+ * @param ctx    Caller data passed to parallel_run()
+ * @param team   The team, for parallel_barrier()
+ * @param member This member's index, 0 .. size - 1 (0 is the calling thread)
+ * @param size   Members that actually run; may be fewer than requested
+ */
+typedef void (*ParallelFn)(void *ctx, ParallelTeam *team, int member, int size);
+
+/**
+ * @brief Caps a requested thread count to [1, min(items, PARALLEL_MAX_THREADS)].
+ * Callers size per-member arrays with it before calling parallel_run().
+ */
+int parallel_threads(int requested, int items);
+
+/**
+ * @brief Bounds [*first, *last) of member's share when count items are split
+ * into size contiguous slices.
+ */
+void parallel_slice(int count, int member, int size, int *first, int *last);
+
+/**
+ * @brief Runs fn on num_threads members and returns once all have finished.
+ *
+ * The calling thread is member 0. If a thread cannot be started the team is
+ * simply smaller: members are numbered after startup, so fn always sees
+ * consecutive indices and the real size, and splits the work over them.
+ * Thread handles live on the heap, and num_threads is capped by
+ * parallel_threads().
+ */
+void parallel_run(int num_threads, ParallelFn fn, void *ctx);
+
+/**
+ * @brief Blocks until every member of the team has reached the barrier.
+ * Writes made before the barrier are visible to all members after it. Every
+ * member must call it the same number of times.
+ */
+void parallel_barrier(ParallelTeam *team);
+
+#endif /* PARALLEL_H */
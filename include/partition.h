@@ -0,0 +1,25 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "../include/graph.h"
+
+/**
+ * @brief Refines a vertex partition by recursive BFS bisection.
+ *
+ * Regions are split breadth-first, so sizes stay within a factor of two of
+ * each other. A split orders the region by a BFS over edges in both
+ * directions, grown from a pseudo-peripheral vertex. The second half of that
+ * order becomes a new region. Disconnected pieces are ordered one after another.
+ * Splitting only ever divides a region, so calling it again with a smaller
+ * max_size gives a nested (multi-level) partition.
+ *
+ * @param graph       The graph (frozen first if needed)
+ * @param region_of   Region per internal vertex, in 0 .. num_regions - 1; refined in place
+ * @param num_regions Regions region_of holds on entry (≥ 1)
+ * @param max_regions Stop once this many regions exist
+ * @param max_size    Regions of at most this many vertices are not split
+ * @return Number of regions afterwards, or -1 on invalid input or allocation failure
+ */
+int graph_partition_bisect(Graph *graph, int *region_of, int num_regions, int max_regions, int max_size);
+
+#endif /* PARTITION_H */
@@ -0,0 +1,81 @@
+#ifndef PHAST_H
+#define PHAST_H
+
+#include "../include/graph.h"
+#include "../include/ch.h"
+
+/** Sources phast_many_to_all() sweeps at once (distance lanes per vertex) */
+#define PHAST_LANES 8
+
+/**
+ * @brief Hierarchy laid out for PHAST one-to-all queries.
+ *
+ * A query runs a Dijkstra from the source over the upward arcs, then one
+ * linear sweep over every vertex: each takes the minimum over its incoming
+ * downward arcs, whose tails have already been swept. Vertices are numbered
+ * by sweep position. Levels come first: a vertex's level is one more than
+ * the highest level of any tail of a downward arc into it, so every level
+ * depends only on earlier ones. Within a level vertices keep rank order
+ * (highest first). Distances of one query then sit in one array read and
+ * written front to back.
+ *
+ * The layout reflects the weights at build time; queries fail once the graph
+ * has changed, so rebuild after edge changes.
+ */
+typedef struct PhastSweep {
+    int numVertices;        /**< Vertices of the graph it was built for */
+    unsigned int graphVersion; /**< graph_version() at build time */
+    int numLevels;          /**< Sweep levels */
+    int *posOf;             /**< Sweep position per internal vertex */
+    int *vertexAt;          /**< Internal vertex per sweep position */
+    int *upOffsets;         /**< Upward arcs of position p: [upOffsets[p], upOffsets[p + 1]) */
+    int *upTargets;         /**< Head position */
+    long long *upWeights;   /**< Arc weight */
+    int *downOffsets;       /**< Downward arcs into position p: [downOffsets[p], downOffsets[p + 1]) */
+    int *downSources;       /**< Tail position (< p) */
+    long long *downWeights; /**< Arc weight */
+} PhastSweep;
+
+/**
+ * @brief Lays out a hierarchy for sweeps.
+ * @param graph The graph (frozen first if needed)
+ * @param ch    Any hierarchy built from graph (CH or CCH)
+ * @return New layout, or NULL on invalid input or allocation failure
+ */
+PhastSweep *phast_build(Graph *graph, const ContractionHierarchy *ch);
+
+/**
+ * @brief Frees a layout (safe to pass NULL).
+ */
+void phast_free(PhastSweep *ph);
+
+/**
+ * @brief Distances from start to every vertex: upward search plus one sweep.
+ * Parents, if asked for, are a breadth-first tree over the edges that are
+ * tight for these distances, so every parent chain is a shortest path.
+ *
+ * @param ph         Layout built from graph
+ * @param graph      The graph
+ * @param start      Start vertex
+ * @param out_dist   numVertices distances, -1 for unreachable vertices
+ * @param out_parent Optional (NULL): numVertices predecessors, -1 for start and unreachable vertices
+ * @return Number of reachable vertices (start included), or -1 on failure
+ */
+int phast_one_to_all(const PhastSweep *ph, Graph *graph, int start, long long *out_dist, int *out_parent);
+
+/**
+ * @brief Distances from several sources. Sources go PHAST_LANES at a time
+ * through one sweep that keeps their distances side by side per vertex, so
+ * the inner minimum is a short fixed-length loop the compiler can vectorize.
+ *
+ * @param ph          Layout built from graph
+ * @param graph       The graph
+ * @param sources     Source vertices
+ * @param num_sources Number of sources
+ * @param out_dists   Row-major num_sources × numVertices distances, -1 for unreachable
+ * @return 0 on success, -1 on failure
+ */
+int phast_many_to_all(const PhastSweep *ph, Graph *graph, const int *sources, int num_sources,
+                      long long *out_dists);
+
+#endif /* PHAST_H */
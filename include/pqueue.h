@@ -0,0 +1,109 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+/**
+ * @brief Available priority queue backends.
+ */
+typedef enum PQueueKind {
+    PQ_AUTO,            /**< PQ_DIAL or PQ_RADIX_HEAP, picked from the largest edge weight */
+    PQ_BINARY_HEAP,     /**< Indexed binary min-heap, O(log n) per operation */
+    PQ_LINEAR_SCAN,     /**< Key array scanned on every pop, O(n); only for tiny graphs */
+    PQ_DIAL,            /**< Ring of max_weight + 1 buckets, O(1) per operation (monotone) */
+    PQ_RADIX_HEAP       /**< 65 buckets by highest bit differing from the last pop (monotone) */
+} PQueueKind;
+
+/**
+ * @brief Largest edge weight PQ_AUTO serves with Dial's buckets; heavier graphs
+ * get the radix heap, whose size does not depend on the weights.
+ */
+#define PQ_DIAL_MAX_WEIGHT 4096
+
+typedef struct PQueue PQueue;
+
+/** @brief pqueue_pop() result when a backend could not allocate (the queue is unchanged). */
+#define PQUEUE_NO_MEMORY (-2)
+
+/**
+ * @brief Operations every backend implements.
+ * Nodes are integers in [0, capacity); each node is in the queue at most once.
+ *
+ * Monotone backends require keys ≥ 0 that never drop below the last popped key
+ * (0 for a new or cleared queue) and, for PQ_DIAL, never exceed it by more than
+ * max_weight. Dijkstra meets both;
+ * A* only with a consistent heuristic, so it keeps the binary heap when a
+ * heuristic is set. A push that breaks the rule fails with -1.
+ */
+typedef struct PQueueOps {
+    const char *name;                                       /**< Backend name for reports */
+    int monotone;                                           /**< Non-zero if keys must not decrease (see above) */
+    int  (*push)(PQueue *pq, int node, long long key);      /**< Insert, or lower the key of a queued node */
+    int  (*pop)(PQueue *pq, int *node, long long *key);     /**< Remove the minimum; -1 if empty, PQUEUE_NO_MEMORY */
+    void (*clear)(PQueue *pq);                              /**< Empty the queue, keep the memory */
+    void (*destroy)(PQueue *pq);                            /**< Free the queue */
+} PQueueOps;
+
+/**
+ * @brief Common header of every backend (backends embed it as their first member).
+ */
+struct PQueue {
+    const PQueueOps *ops;   /**< Backend implementation */
+    int size;               /**< Nodes currently queued */
+    int capacity;           /**< Node IDs must be < capacity */
+};
+
+/**
+ * @brief Creates a queue for node IDs in [0, capacity).
+ * @param max_weight Largest edge weight of the graph; sizes PQ_DIAL and resolves
+ *                   PQ_AUTO, ignored by the other backends
+ * @return New queue or NULL on allocation failure / invalid input
+ */
+PQueue *pqueue_create(PQueueKind kind, int capacity, long long max_weight);
+
+/**
+ * @brief Backend PQ_AUTO stands for on a graph whose largest edge weight is max_weight.
+ */
+PQueueKind pqueue_kind_for_max_weight(long long max_weight);
+
+/**
+ * @brief Parses a backend name ("auto", "heap", "scan", "dial", "radix").
+ * @return 0 on success, -1 for an unknown name
+ */
+int pqueue_kind_from_string(const char *name, PQueueKind *kind);
+
+/**
+ * @brief Inserts node with the given key, or lowers its key if it is already queued
+ * (a higher key for a queued node is ignored).
+ * @return 0 on success, -1 on invalid node or a key a monotone backend cannot take
+ */
+static inline int pqueue_push(PQueue *pq, int node, long long key) {
+    return pq->ops->push(pq, node, key);
+}
+
+/**
+ * @brief Removes the node with the smallest key.
+ * Only PQ_RADIX_HEAP allocates while popping; callers that loop until the
+ * queue is empty must treat PQUEUE_NO_MEMORY as a failed search, not as the end.
+ * @return 0 on success, -1 if the queue is empty, PQUEUE_NO_MEMORY if the
+ *         backend ran out of memory
+ */
+static inline int pqueue_pop(PQueue *pq, int *node, long long *key) {
+    return pq->ops->pop(pq, node, key);
+}
+
+/**
+ * @brief Removes every node; the queue can be reused.
+ */
+static inline void pqueue_clear(PQueue *pq) {
+    pq->ops->clear(pq);
+}
+
+/**
+ * @brief Frees the queue (safe to pass NULL).
+ */
+static inline void pqueue_destroy(PQueue *pq) {
+    if (pq) {
+        pq->ops->destroy(pq);
+    }
+}
+
+#endif /* PQUEUE_H */
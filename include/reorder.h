@@ -0,0 +1,40 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "../include/graph.h"
+
+/**
+ * @brief Strategies for renumbering vertices to improve memory locality.
+ */
+typedef enum {
+    ORDER_BFS = 0,      /**< Breadth-first discovery order */
+    ORDER_RCM,          /**< Reverse Cuthill–McKee (bandwidth reduction) */
+    ORDER_HILBERT       /**< Hilbert curve over vertex coordinates */
+} VertexOrder;
+
+/**
+ * @brief Computes a locality-improving order for the graph's current internal IDs.
+ * Disconnected components are laid out one after another.
+ *
+ * @param g          The graph (frozen first if needed)
+ * @param order      Strategy to use (ORDER_HILBERT requires coordinates)
+ * @param new_of_old Output array of numVertices entries: new internal ID per current internal ID
+ * @return 0 on success, -1 on failure (invalid input, missing coordinates, allocation error)
+ */
+int compute_vertex_order(Graph *g, VertexOrder order, int *new_of_old);
+
+/**
+ * @brief Computes an order and applies it with graph_apply_permutation().
+ * Neighbouring vertices end up close together in the CSR and in every per-vertex
+ * search array, while external IDs, names and paths are unaffected.
+ * @return 0 on success, -1 on failure
+ */
+int graph_reorder(Graph *g, VertexOrder order);
+
+/**
+ * @brief Parses "bfs", "rcm" or "hilbert".
+ * @return 0 on success, -1 for an unknown name
+ */
+int vertex_order_from_string(const char *name, VertexOrder *out);
+
+#endif /* REORDER_H */
@@ -0,0 +1,96 @@
+#ifndef SEARCH_CONTEXT_H
+#define SEARCH_CONTEXT_H
+
+#include "../include/pqueue.h"
+
+/**
+ * @brief Reusable per-vertex workspace for the search algorithms.
+ *
+ * dist[v] and parent[v] are only meaningful while stamp[v] == generation;
+ * every other vertex reads as unreached. Starting a query bumps the generation
+ * instead of clearing the arrays, so a reset is O(1) and a query on a graph
+ * that fits the context allocates nothing.
+ *
+ * Bidirectional searches also use the *Back arrays (allocated on first use),
+ * stamped with the same generation.
+ *
+ * Each thread gets a default context on its first query. search_context_bind()
+ * swaps in a caller-owned one, e.g. to reuse it across threads in turn.
+ */
+typedef struct SearchContext {
+    int capacity;               /**< Vertices every array holds */
+    unsigned int generation;    /**< Current query; 0 is never used */
+    unsigned int *stamp;        /**< Generation at which dist/parent of v were last written */
+    void *dist;                 /**< 8 bytes per vertex, read at the kernel's distance width */
+    int *parent;                /**< Predecessor per vertex, -1 for the start */
+    int *scratch;               /**< Per-vertex int buffer (BFS queue) */
+    unsigned char *flags;       /**< Per-vertex byte buffer (Bellman-Ford cycle marks) */
+    PQueue *queue;              /**< Cached priority queue, empty between queries */
+    PQueueKind queueKind;       /**< Backend of queue (and queueBack) */
+    long long queueMaxWeight;   /**< max_weight queue was created with */
+    int settled;                /**< Vertices settled by the current/last query */
+    unsigned int *stampBack;    /**< Backward search stamps (NULL until a bidirectional query) */
+    long long *distBack;        /**< Backward distance to the target per vertex */
+    int *parentBack;            /**< Successor towards the target, -1 for the target */
+    PQueue *queueBack;          /**< Backward search queue (same backend as queue) */
+} SearchContext;
+
+/**
+ * @brief Creates a context for graphs of up to capacity vertices.
+ * @return New context or NULL on allocation failure / invalid input
+ */
+SearchContext *search_context_create(int capacity);
+
+/**
+ * @brief Frees a context and its cached queue (safe to pass NULL).
+ * The context must not be bound to any thread.
+ */
+void search_context_free(SearchContext *ctx);
+
+/**
+ * @brief Grows the arrays to hold at least capacity vertices (never shrinks).
+ * @return 0 on success, -1 on allocation failure
+ */
+int search_context_reserve(SearchContext *ctx, int capacity);
+
+/**
+ * @brief Allocates the backward-search arrays (no-op if present).
+ * @return 0 on success, -1 on allocation failure
+ */
+int search_context_enable_backward(SearchContext *ctx);
+
+/**
+ * @brief Starts a new query: every vertex reads as unreached again.
+ * O(1) except when the generation counter wraps, which clears the stamps.
+ * @return The new generation
+ */
+unsigned int search_context_begin(SearchContext *ctx);
+
+/**
+ * @brief Returns the context's queue for the given backend, recreating it only
+ * when the backend changes or a Dial ring is too small for max_weight.
+ * queueBack is kept in step once the backward arrays exist.
+ * @param kind Resolved backend (not PQ_AUTO)
+ * @return Empty queue or NULL on allocation failure
+ */
+PQueue *search_context_queue(SearchContext *ctx, PQueueKind kind, long long max_weight);
+
+/**
+ * @brief Makes the calling thread's queries use ctx (NULL = the thread's default).
+ * @return The previously bound context, or NULL if the default was in use
+ */
+SearchContext *search_context_bind(SearchContext *ctx);
+
+/**
+ * @brief Context for the calling thread's next query, grown to capacity.
+ * Creates the thread's default context on first use.
+ * @return Context or NULL on allocation failure
+ */
+SearchContext *search_context_current(int capacity);
+
+/**
+ * @brief Frees the calling thread's default context (the next query creates a new one).
+ */
+void search_context_release(void);
+
+#endif /* SEARCH_CONTEXT_H */
@@ -0,0 +1,78 @@
+#ifndef SEARCH_SESSION_H
+#define SEARCH_SESSION_H
+
+#include "../include/graph.h"
+#include "../include/pqueue.h"
+
+/** Vertex states of a session */
+#define SESSION_UNSEEN  0
+#define SESSION_OPEN    1
+#define SESSION_SETTLED 2
+
+/**
+ * @brief Resumable Dijkstra or A* from a fixed start vertex.
+ *
+ * The session keeps its queue and its dist / parent arrays between goals.
+ * A goal that is already settled is answered from the parent pointers. For
+ * any other goal the search resumes where it stopped and settles vertices
+ * until that goal is settled. Routing one depot to many stops therefore
+ * settles each vertex at most once over the whole session.
+ *
+ * With a heuristic the open vertices are re-keyed with g + h(v, goal)
+ * whenever the goal changes. Settled distances are exact for any consistent
+ * heuristic, so the search stays correct from one goal to the next. The
+ * session owns its arrays and queue, and does not use the thread's
+ * SearchContext. Queries fail once the graph has changed, or after a search
+ * ran out of memory; start a new session.
+ */
+typedef struct SearchSession {
+    Graph *graph;               /**< Graph searched */
+    int start;                  /**< Start vertex (internal ID) */
+    int (*heuristic)(int, int); /**< Consistent heuristic on external IDs, or NULL for Dijkstra */
+    int target;                 /**< Goal the queue keys are computed for, -1 if none */
+    unsigned int graphVersion;  /**< graph_version() at creation */
+    int failed;                 /**< Set when a search ran out of memory; every later query fails */
+    long long *dist;            /**< Distance from start per internal vertex, valid once reached */
+    int *parent;                /**< Predecessor per internal vertex, -1 for the start */
+    unsigned char *state;       /**< SESSION_UNSEEN / SESSION_OPEN / SESSION_SETTLED per internal vertex */
+    int *reached;               /**< Vertices reached so far, in discovery order */
+    int numReached;             /**< Entries of reached */
+    PQueue *queue;              /**< Open vertices */
+    int settled;                /**< Vertices settled over the whole session */
+    int lastSettled;            /**< Vertices settled by the last search_session_path() */
+} SearchSession;
+
+/**
+ * @brief Starts a session at start. Nothing is settled until the first goal.
+ * Without a heuristic the queue backend follows search_set_queue(); with one it
+ * is the binary heap (re-keyed goals need not be monotone).
+ *
+ * @param graph     The graph (frozen first if needed; negative edges are skipped)
+ * @param start     Start vertex
+ * @param heuristic Consistent heuristic on external IDs, or NULL for Dijkstra
+ * @return New session, or NULL on invalid input, allocation failure, or
+ *         landmark_heuristic() over a stale landmark set
+ */
+SearchSession *search_session_create(Graph *graph, int start, int (*heuristic)(int from, int to));
+
+/**
+ * @brief Frees a session (safe to pass NULL).
+ */
+void search_session_free(SearchSession *session);
+
+/**
+ * @brief Shortest path from the session's start to goal, settling only what
+ * is still missing.
+ *
+ * @param session      The session
+ * @param goal         Goal vertex
+ * @param out_path     Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @return Path length (number of vertices) or 0 on failure, no path, a changed graph
+ *         or an earlier failed search
+ */
+int search_session_path(SearchSession *session, int goal, int *out_path, int max_path_len,
+                        long long *out_distance);
+
+#endif /* SEARCH_SESSION_H */
@@ -0,0 +1,108 @@
+#ifndef TNR_H
+#define TNR_H
+
+#include <limits.h>
+#include <stdint.h>
+#include "../include/graph.h"
+#include "../include/ch.h"
+
+/** Transit nodes per vertex-count square root when tnr_build() is asked for 0 */
+#define TNR_DEFAULT_TRANSIT_FACTOR 4
+
+/** Partition cells behind the locality filter (one bit each) */
+#define TNR_LOCALITY_CELLS 64
+
+/** Table entry for a transit pair with no path */
+#define TNR_NO_PATH LLONG_MAX
+
+/**
+ * @brief Transit-node routing over a contraction hierarchy.
+ *
+ * The transit nodes are the highest-ranked vertices of the hierarchy. The
+ * forward access nodes of v are the transit nodes an upward search from v
+ * reaches before passing any other transit node, minus those reached more
+ * cheaply through another access node; backward access nodes are the same
+ * for the reverse search. A shortest s → t path whose highest vertex is a
+ * transit node has length
+ *
+ *     min over access nodes a of s, b of t of d(s, a) + D(a, b) + d(b, t)
+ *
+ * with D the transit-to-transit table, so such queries are table lookups.
+ *
+ * Every other path stays below the transit nodes, inside the upward search
+ * spaces of both s and t. The locality filter keeps, per vertex and
+ * direction, a bitmask of the partition cells its search space touches (the
+ * vertices below the transit nodes only). Disjoint masks of s (forward) and
+ * t (backward) prove the query is not local; otherwise it falls back to the
+ * hierarchy's own query.
+ *
+ * Access nodes and table reflect the weights at build time; queries fail once
+ * the graph has changed, so rebuild after edge changes.
+ */
+typedef struct TransitNodeRouting {
+    int numVertices;        /**< Vertices of the graph it was built for */
+    unsigned int graphVersion; /**< graph_version() at build time */
+    int numTransit;         /**< Transit nodes (the top ranks of the hierarchy) */
+    int *transitVertex;     /**< Internal vertex per transit ID */
+    long long *table;       /**< Row-major numTransit × numTransit distances, TNR_NO_PATH if none */
+    int *fwdOffsets;        /**< Forward access nodes of v: [fwdOffsets[v], fwdOffsets[v + 1]) */
+    int *fwdAccess;         /**< Transit ID */
+    long long *fwdDists;    /**< dist(v, access node) */
+    int *bwdOffsets;        /**< Backward access nodes of v: [bwdOffsets[v], bwdOffsets[v + 1]) */
+    int *bwdAccess;         /**< Transit ID */
+    long long *bwdDists;    /**< dist(access node, v) */
+    uint64_t *fwdCells;     /**< Cells touched by v's forward search space below the transit nodes */
+    uint64_t *bwdCells;     /**< Cells touched by v's backward search space below the transit nodes */
+} TransitNodeRouting;
+
+/**
+ * @brief Selects transit nodes and computes access nodes, the distance table
+ * and the locality masks. The table comes from bucket-based many-to-many
+ * searches over the upward arcs among the transit nodes; access nodes from
+ * one pruned upward search per vertex and direction. The cells are
+ * TNR_LOCALITY_CELLS regions of graph_partition_bisect().
+ *
+ * @param graph       The graph (frozen first if needed; weights must be non-negative)
+ * @param ch          Any hierarchy built from graph (CH or CCH)
+ * @param num_transit Transit nodes (0 = TNR_DEFAULT_TRANSIT_FACTOR · √n, capped at n)
+ * @return New routing layer, or NULL on invalid input, negative weights or allocation failure
+ */
+TransitNodeRouting *tnr_build(Graph *graph, const ContractionHierarchy *ch, int num_transit);
+
+/**
+ * @brief Frees a routing layer (safe to pass NULL).
+ */
+void tnr_free(TransitNodeRouting *tnr);
+
+/**
+ * @brief Whether the locality filter sends start → goal to the hierarchy search.
+ * @return 1 if local, 0 if table lookups answer it, -1 on invalid input
+ */
+int tnr_is_local(const TransitNodeRouting *tnr, const Graph *graph, int start, int goal);
+
+/**
+ * @brief Distance query – access-node table lookups, or a CH query for local pairs.
+ * @return Shortest distance from start to goal, -1 if unreachable, on invalid
+ *         input or once the graph has changed
+ */
+long long tnr_distance(const TransitNodeRouting *tnr, const ContractionHierarchy *ch, Graph *graph,
+                       int start, int goal);
+
+/**
+ * @brief Distance query plus path. A long-range path is joined from CH paths
+ * start → a, a → b and b → goal for the access nodes a, b the lookup chose.
+ *
+ * @param tnr         Routing layer built from graph and ch
+ * @param ch          The hierarchy it was built from
+ * @param graph       The graph
+ * @param start       Start vertex
+ * @param goal        Goal vertex
+ * @param out_path    Output buffer for path
+ * @param max_path_len Buffer size
+ * @param out_distance Total path weight or -1 if unreachable
+ * @return Path length (number of vertices) or 0 on failure
+ */
+int tnr_shortest_path(const TransitNodeRouting *tnr, const ContractionHierarchy *ch, Graph *graph,
+                      int start, int goal, int *out_path, int max_path_len, long long *out_distance);
+
+#endif /* TNR_H */
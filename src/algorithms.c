@@ -1,24 +1,28 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 
 #include "../include/graph.h"
 #include "../include/algorithms.h"
+#include "../include/search_context.h"
+#include "../include/landmarks.h"
 
 /* ============================================================================
    Shared helper: reconstruct path from parent array
+   start/goal/parent use internal IDs; out_path receives external IDs.
+   Walks the chain twice (count, then fill backwards) so no buffer is needed;
+   a chain longer than numVertices is a cycle.
    Returns number of vertices in path or 0 if invalid/no path
    ========================================================================== */
 
-static int reconstruct_path(int start, int goal, const int *parent, int *out_path, int max_len, int num_vertices) {
-    if (!parent || !out_path || max_len < 2) {
-        return 0;
-    }
+static int reconstruct_path(const Graph *graph, int start, int goal, const int *parent, int *out_path, int max_len) {
+    int num_vertices = graph->numVertices;
 
-    int *temp = malloc(num_vertices * sizeof(int));
-    if (!temp) {
+    if (!parent || !out_path || max_len < 2) {
         return 0;
     }
 
@@ -26,28 +30,22 @@ static int reconstruct_path(int start, int goal, const int *parent, int *out_pat
     int at = goal;
 
     while (at != -1 && length < num_vertices) {
-        temp[length++] = at;
+        length++;
         if (at == start) {
             break;
         }
         at = parent[at];
     }
 
-    if (length == 0 || temp[length - 1] != start) {
-        free(temp);
-        return 0;
-    }
-
-    if (length > max_len) {
-        free(temp);
+    if (at != start || length > max_len) {
         return 0;
     }
 
-    for (int i = 0; i < length; i++) {
-        out_path[i] = temp[length - 1 - i];
+    at = goal;
+    for (int i = length - 1; i >= 0; i--) {
+        out_path[i] = graph_to_external(graph, at);
+        at = parent[at];
     }
-
-    free(temp);
     return length;
 }
 
@@ -61,54 +59,59 @@ int bfs_shortest_hops(Graph *graph, int start, int goal, int *out_path, int max_
         return 0;
     }
 
-    int n = graph->numVertices;
+    if (graph_freeze(graph) != 0) {
+        *out_distance = -1;
+        return 0;
+    }
 
-    bool *visited = calloc(n, sizeof(bool));
-    int  *parent  = malloc(n * sizeof(int));
-    int  *queue   = malloc(n * sizeof(int));
-    if (!visited || !parent || !queue) {
-        free(visited);
-        free(parent);
-        free(queue);
-        if (out_distance) *out_distance = -1;
+    start = graph_to_internal(graph, start);
+    goal  = graph_to_internal(graph, goal);
+
+    GraphEdgeIter it;
+    SearchContext *ctx = search_context_current(graph->numVertices);
+    if (!ctx) {
+        *out_distance = -1;
         return 0;
     }
 
-    for (int i = 0; i < n; i++) parent[i] = -1;
+    /* stamp[v] == gen marks v as visited */
+    unsigned int gen = search_context_begin(ctx);
+    unsigned int *stamp = ctx->stamp;
+    int *parent = ctx->parent;
+    int *queue = ctx->scratch;
 
     int front = 0, rear = 0;
-    visited[start] = true;
+    stamp[start] = gen;
+    parent[start] = -1;
     queue[rear++] = start;
 
     while (front < rear) {
         int v = queue[front++];
+        ctx->settled++;
 
         if (v == goal) {
             break;
         }
 
-        for (Edge *e = graph->array[v].head; e != NULL; e = e->next) {
-            int u = e->to;
-            if (!visited[u]) {
-                visited[u] = true;
+        for (graph_edges_begin(graph, v, &it); graph_edges_next(&it); ) {
+            int u = it.to;
+            if (stamp[u] != gen) {
+                stamp[u] = gen;
                 parent[u] = v;
                 queue[rear++] = u;
             }
         }
     }
 
-    int path_len = reconstruct_path(start, goal, parent, out_path, max_path_len, n);
-
-    free(queue);
-    free(visited);
-    free(parent);
+    int path_len = stamp[goal] == gen
+                 ? reconstruct_path(graph, start, goal, parent, out_path, max_path_len) : 0;
 
     if (path_len == 0) {
-        if (out_distance) *out_distance = -1;
+        *out_distance = -1;
         return 0;
     }
 
-    if (out_distance) *out_distance = path_len - 1; /* hops */
+    *out_distance = path_len - 1; /* hops */
     return path_len;
 }
 
@@ -116,15 +119,16 @@ int bfs_shortest_hops(Graph *graph, int start, int goal, int *out_path, int max_
    DFS – any path (not necessarily shortest)
    ========================================================================== */
 
-static bool dfs_recursive(Graph *graph, int v, int goal, bool *visited, int *parent) {
-    visited[v] = true;
+static bool dfs_recursive(const Graph *graph, int v, int goal, unsigned int *stamp, unsigned int gen, int *parent) {
+    stamp[v] = gen;
     if (v == goal) return true;
 
-    for (Edge *e = graph->array[v].head; e; e = e->next) {
-        int u = e->to;
-        if (!visited[u]) {
+    GraphEdgeIter it;
+    for (graph_edges_begin(graph, v, &it); graph_edges_next(&it); ) {
+        int u = it.to;
+        if (stamp[u] != gen) {
             parent[u] = v;
-            if (dfs_recursive(graph, u, goal, visited, parent)) {
+            if (dfs_recursive(graph, u, goal, stamp, gen, parent)) {
                 return true;
             }
         }
@@ -137,550 +141,521 @@ int dfs_path(Graph *graph, int start, int goal, int *out_path, int max_path_len)
         return 0;
     }
 
-    int n = graph->numVertices;
-
-    bool *visited = calloc(n, sizeof(bool));
-    int  *parent  = malloc(n * sizeof(int));
-    if (!visited || !parent) {
-        free(visited);
-        free(parent);
+    if (graph_freeze(graph) != 0) {
         return 0;
     }
 
-    for (int i = 0; i < n; i++) parent[i] = -1;
-
-    bool found = dfs_recursive(graph, start, goal, visited, parent);
-    int path_len = 0;
-
-    if (found) {
-        path_len = reconstruct_path(start, goal, parent, out_path, max_path_len, n);
-    }
-
-    free(visited);
-    free(parent);
-    return path_len;
-}
+    start = graph_to_internal(graph, start);
+    goal  = graph_to_internal(graph, goal);
 
-/* ============================================================================
-   Dijkstra – shortest weighted path (non-negative weights)
-   ========================================================================== */
-
-int dijkstra_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, int *out_distance) {
-    if (!graph || !out_path || !out_distance || start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices || max_path_len < 2) {
-        if (out_distance) *out_distance = -1;
+    SearchContext *ctx = search_context_current(graph->numVertices);
+    if (!ctx) {
         return 0;
     }
 
-    int n = graph->numVertices;
+    /* stamp[v] == gen marks v as visited */
+    unsigned int gen = search_context_begin(ctx);
+    ctx->parent[start] = -1;
 
-    int  *dist    = malloc(n * sizeof(int));
-    int  *parent  = malloc(n * sizeof(int));
-    bool *visited = calloc(n, sizeof(bool));
-    if (!dist || !parent || !visited) {
-        free(dist);
-        free(parent);
-        free(visited);
-        if (out_distance) *out_distance = -1;
+    if (!dfs_recursive(graph, start, goal, ctx->stamp, gen, ctx->parent)) {
         return 0;
     }
+    return reconstruct_path(graph, start, goal, ctx->parent, out_path, max_path_len);
+}
 
-    for (int i = 0; i < n; i++) {
-        dist[i]   = INT_MAX;
-        parent[i] = -1;
-    }
-
-    dist[start] = 0;
+/* ============================================================================
+   Queue backend shared by Dijkstra and A*
+   ========================================================================== */
 
-    for (int count = 0; count < n; count++) {
-        int u = -1;
-        int min_dist = INT_MAX;
+static PQueueKind search_queue_kind = PQ_AUTO;
 
-        for (int v = 0; v < n; v++) {
-            if (!visited[v] && dist[v] < min_dist) {
-                min_dist = dist[v];
-                u = v;
-            }
-        }
+void search_set_queue(PQueueKind kind) {
+    search_queue_kind = kind;
+}
 
-        if (u == -1) break;
-        visited[u] = true;
-        if (u == goal) break;
+PQueueKind search_get_queue(void) {
+    return search_queue_kind;
+}
 
-        for (Edge *e = graph->array[u].head; e != NULL; e = e->next) {
-            int v = e->to;
-            int w = e->weight;
-            if (w < 0) {
-                continue;
-            }
+/*
+ * Prepares the calling thread's context for a Dijkstra/A* query and its queue.
+ * Resolves PQ_AUTO from the graph's largest weight. Monotone queues need
+ * non-decreasing keys, which A* only produces with a consistent heuristic;
+ * the heuristics are not checked, so A* with one falls back to the heap.
+ */
+static SearchContext *search_begin_queue(Graph *graph, int has_heuristic, int bidirectional) {
+    long long max_weight = graph_max_weight(graph);
+    PQueueKind kind = search_queue_kind;
 
-            if (!visited[v] && dist[u] != INT_MAX) {
-                long new_dist = (long)dist[u] + w;
-                if (new_dist < dist[v]) {
-                    dist[v] = (new_dist > INT_MAX) ? INT_MAX : (int)new_dist;
-                    parent[v] = u;
-                }
-            }
-        }
+    if (kind == PQ_AUTO) {
+        kind = pqueue_kind_for_max_weight(max_weight);
     }
-
-    if (dist[goal] == INT_MAX) {
-        if (out_distance) *out_distance = -1;
-        free(dist);
-        free(parent);
-        free(visited);
-        return 0;
+    if (has_heuristic && (kind == PQ_DIAL || kind == PQ_RADIX_HEAP)) {
+        kind = PQ_BINARY_HEAP;
     }
 
-    int path_len = reconstruct_path(start, goal, parent, out_path, max_path_len, n);
-    if (path_len == 0) {
-        if (out_distance) *out_distance = -1;
-        free(dist);
-        free(parent);
-        free(visited);
-        return 0;
+    SearchContext *ctx = search_context_current(graph->numVertices);
+    if (!ctx || (bidirectional && search_context_enable_backward(ctx) != 0) ||
+        !search_context_queue(ctx, kind, max_weight)) {
+        return NULL;
     }
-
-    if (out_distance) *out_distance = dist[goal];
-    free(dist);
-    free(parent);
-    free(visited);
-    return path_len;
+    search_context_begin(ctx);
+    return ctx;
 }
 
 /* ============================================================================
-   A* – shortest path with heuristic (falls back to Dijkstra if heuristic=NULL)
+   Width-specialized kernels (see sssp_kernel.inc)
    ========================================================================== */
 
-#ifndef GRID_WIDTH
-#define GRID_WIDTH 5
-#endif
-
-int simple_manhattan_heuristic(int a, int b) {
-    int ax = a % GRID_WIDTH;
-    int ay = a / GRID_WIDTH;
-    int bx = b % GRID_WIDTH;
-    int by = b / GRID_WIDTH;
-    return abs(ax - bx) + abs(ay - by);
-}
+#define KERNEL_SUFFIX   w16_d16
+#define kernel_weight_t int16_t
+#define kernel_dist_t   int16_t
+#define KERNEL_DIST_MAX INT16_MAX
+#define KERNEL_DIST_MIN INT16_MIN
+#include "sssp_kernel.inc"
+
+#define KERNEL_SUFFIX   w16_d32
+#define kernel_weight_t int16_t
+#define kernel_dist_t   int32_t
+#define KERNEL_DIST_MAX INT32_MAX
+#define KERNEL_DIST_MIN INT32_MIN
+#include "sssp_kernel.inc"
+
+#define KERNEL_SUFFIX   w16_d64
+#define kernel_weight_t int16_t
+#define kernel_dist_t   int64_t
+#define KERNEL_DIST_MAX INT64_MAX
+#define KERNEL_DIST_MIN INT64_MIN
+#include "sssp_kernel.inc"
+
+#define KERNEL_SUFFIX   w32_d32
+#define kernel_weight_t int32_t
+#define kernel_dist_t   int32_t
+#define KERNEL_DIST_MAX INT32_MAX
+#define KERNEL_DIST_MIN INT32_MIN
+#include "sssp_kernel.inc"
+
+#define KERNEL_SUFFIX   w32_d64
+#define kernel_weight_t int32_t
+#define kernel_dist_t   int64_t
+#define KERNEL_DIST_MAX INT64_MAX
+#define KERNEL_DIST_MIN INT64_MIN
+#include "sssp_kernel.inc"
+
+#define KERNEL_SUFFIX   w64_d64
+#define kernel_weight_t int64_t
+#define kernel_dist_t   int64_t
+#define KERNEL_DIST_MAX INT64_MAX
+#define KERNEL_DIST_MIN INT64_MIN
+#include "sssp_kernel.inc"
+
+/* Compressed layout or pending overlay: weights come out of the iterator already widened */
+
+#define KERNEL_DECODE
+#define KERNEL_SUFFIX   packed_d16
+#define kernel_weight_t int64_t
+#define kernel_dist_t   int16_t
+#define KERNEL_DIST_MAX INT16_MAX
+#define KERNEL_DIST_MIN INT16_MIN
+#include "sssp_kernel.inc"
+
+#define KERNEL_DECODE
+#define KERNEL_SUFFIX   packed_d32
+#define kernel_weight_t int64_t
+#define kernel_dist_t   int32_t
+#define KERNEL_DIST_MAX INT32_MAX
+#define KERNEL_DIST_MIN INT32_MIN
+#include "sssp_kernel.inc"
+
+#define KERNEL_DECODE
+#define KERNEL_SUFFIX   packed_d64
+#define kernel_weight_t int64_t
+#define kernel_dist_t   int64_t
+#define KERNEL_DIST_MAX INT64_MAX
+#define KERNEL_DIST_MIN INT64_MIN
+#include "sssp_kernel.inc"
 
-int simple_euclidean_heuristic(int a, int b) {
-    int ax = a % GRID_WIDTH, ay = a / GRID_WIDTH;
-    int bx = b % GRID_WIDTH, by = b / GRID_WIDTH;
-    int dx = ax - bx;
-    int dy = ay - by;
-    return (int)(sqrt(dx * dx + dy * dy) + 0.5);
+typedef struct {
+    int weightBits;     /* 0 = compressed layout */
+    int distBits;
+    int (*dijkstra)(const Graph *, SearchContext *, int, int, long long *);
+    int (*astar)(const Graph *, SearchContext *, int, int, long long *, int (*)(int, int));
+    int (*bellman_ford)(const Graph *, SearchContext *, int, int, long long *);
+} SsspKernel;
+
+#define SSSP_KERNEL(wb, db, sfx) { wb, db, dijkstra_##sfx, astar_##sfx, bellman_ford_##sfx }
+
+static const SsspKernel sssp_kernels[] = {
+    SSSP_KERNEL(16, 16, w16_d16),
+    SSSP_KERNEL(16, 32, w16_d32),
+    SSSP_KERNEL(16, 64, w16_d64),
+    SSSP_KERNEL(32, 32, w32_d32),
+    SSSP_KERNEL(32, 64, w32_d64),
+    SSSP_KERNEL(64, 64, w64_d64),
+    SSSP_KERNEL(0,  16, packed_d16),
+    SSSP_KERNEL(0,  32, packed_d32),
+    SSSP_KERNEL(0,  64, packed_d64),
+};
+
+/*
+ * Picks the variant matching the widths chosen when the graph was frozen.
+ * Pending overlay updates need the iterator and may widen the distance bound.
+ */
+static const SsspKernel *sssp_kernel_for(const Graph *graph) {
+    int weight_bits = graph->compressed ? 0 : graph->csr.weightBits;
+    int dist_bits = graph->distBits;
+
+    if (graph_delta_size(graph) > 0) {
+        const GraphDelta *d = graph->delta;
+        unsigned long long bound = d->baseBound > ULLONG_MAX - d->absWeightSum
+                                 ? ULLONG_MAX : d->baseBound + d->absWeightSum;
+        int needed = graph_dist_bits_for_bound(bound);
+        weight_bits = 0;
+        if (needed > dist_bits) dist_bits = needed;
+    }
+
+    for (size_t i = 0; i < sizeof(sssp_kernels) / sizeof(sssp_kernels[0]); i++) {
+        if (sssp_kernels[i].weightBits == weight_bits &&
+            sssp_kernels[i].distBits == dist_bits) {
+            return &sssp_kernels[i];
+        }
+    }
+    return NULL;
 }
 
-/* --- Minimal binary min-heap for A* (priority = f_score) --- */
-
-typedef struct {
-    int node;
-    int priority;
-} PQNode;
+/* ============================================================================
+   Dijkstra – shortest weighted path (non-negative weights)
+   ========================================================================== */
 
-typedef struct {
-    PQNode *nodes;
-    int    *heap_index; /* node -> index in heap, -1 if not in heap */
-    int capacity;
-    int size;
-} PriorityQueue;
-
-static PriorityQueue *pq_create(int capacity) {
-    PriorityQueue *pq = malloc(sizeof(PriorityQueue));
-    if (!pq) return NULL;
-
-    pq->nodes = malloc(capacity * sizeof(PQNode));
-    pq->heap_index = malloc(capacity * sizeof(int));
-    pq->capacity = capacity;
-    pq->size = 0;
-
-    if (!pq->nodes || !pq->heap_index) {
-        free(pq->nodes);
-        free(pq->heap_index);
-        free(pq);
-        return NULL;
+int dijkstra_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance) {
+    if (!graph || !out_path || !out_distance || start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices || max_path_len < 2) {
+        if (out_distance) *out_distance = -1;
+        return 0;
     }
 
-    for (int i = 0; i < capacity; i++) {
-        pq->heap_index[i] = -1;
+    if (graph_freeze(graph) != 0) {
+        *out_distance = -1;
+        return 0;
     }
 
-    return pq;
-}
+    start = graph_to_internal(graph, start);
+    goal  = graph_to_internal(graph, goal);
+
+    const SsspKernel *kernel = sssp_kernel_for(graph);
+    SearchContext *ctx = search_begin_queue(graph, 0, 0);
+    long long dist = -1;
 
-static void pq_destroy(PriorityQueue *pq) {
-    if (pq) {
-        free(pq->nodes);
-        free(pq->heap_index);
-        free(pq);
+    if (!kernel || !ctx || kernel->dijkstra(graph, ctx, start, goal, &dist) != 0) {
+        *out_distance = -1;
+        return 0;
     }
-}
 
-static void pq_swap(PriorityQueue *pq, int i, int j) {
-    PQNode temp = pq->nodes[i];
-    pq->nodes[i] = pq->nodes[j];
-    pq->nodes[j] = temp;
+    int path_len = reconstruct_path(graph, start, goal, ctx->parent, out_path, max_path_len);
 
-    pq->heap_index[pq->nodes[i].node] = i;
-    pq->heap_index[pq->nodes[j].node] = j;
+    *out_distance = path_len > 0 ? dist : -1;
+    return path_len;
 }
 
-static void pq_heapify_up(PriorityQueue *pq, int idx) {
-    while (idx > 0) {
-        int parent = (idx - 1) / 2;
-        if (pq->nodes[parent].priority <= pq->nodes[idx].priority) break;
-        pq_swap(pq, parent, idx);
-        idx = parent;
+int dijkstra_one_to_all(Graph *graph, int start, long long *out_dist, int *out_parent) {
+    if (!graph || !out_dist || start < 0 || start >= graph->numVertices || graph_freeze(graph) != 0) {
+        return -1;
     }
-}
 
-static void pq_heapify_down(PriorityQueue *pq, int idx) {
-    while (1) {
-        int min_idx = idx;
-        int left = 2 * idx + 1;
-        int right = 2 * idx + 2;
+    const SsspKernel *kernel = sssp_kernel_for(graph);
+    SearchContext *ctx = search_begin_queue(graph, 0, 0);
+    long long unused;
+
+    if (!kernel || !ctx || kernel->dijkstra(graph, ctx, graph_to_internal(graph, start), -1, &unused) != 0) {
+        return -1;
+    }
 
-        if (left < pq->size &&
-            pq->nodes[left].priority < pq->nodes[min_idx].priority) {
-            min_idx = left;
+    /* Copy out at the kernel's distance width */
+    int reached = 0;
+    unsigned int gen = ctx->generation;
+    for (int v = 0; v < graph->numVertices; v++) {
+        int ext = graph_to_external(graph, v);
+        if (ctx->stamp[v] != gen) {
+            out_dist[ext] = -1;
+            if (out_parent) out_parent[ext] = -1;
+            continue;
         }
-        if (right < pq->size &&
-            pq->nodes[right].priority < pq->nodes[min_idx].priority) {
-            min_idx = right;
+        switch (kernel->distBits) {
+            case 16: out_dist[ext] = ((const int16_t *)ctx->dist)[v]; break;
+            case 32: out_dist[ext] = ((const int32_t *)ctx->dist)[v]; break;
+            default: out_dist[ext] = ((const int64_t *)ctx->dist)[v]; break;
         }
-
-        if (min_idx == idx) break;
-        pq_swap(pq, idx, min_idx);
-        idx = min_idx;
+        if (out_parent) {
+            out_parent[ext] = ctx->parent[v] < 0 ? -1 : graph_to_external(graph, ctx->parent[v]);
+        }
+        reached++;
     }
+    return reached;
 }
 
-static int pq_insert(PriorityQueue *pq, int node, int priority) {
-    if (pq->size >= pq->capacity) return -1;
-    pq->nodes[pq->size].node = node;
-    pq->nodes[pq->size].priority = priority;
-    pq->heap_index[node] = pq->size;
-    pq_heapify_up(pq, pq->size);
-    pq->size++;
-    return 0;
-}
+/* ============================================================================
+   Bidirectional search – forward from start over outgoing edges, backward
+   from goal over the incoming-edge CSR, alternating on the smaller radius.
+   mu is the best start→goal distance through a vertex reached from both
+   sides; once the radii sum to mu no shorter connection can appear.
+
+   With a heuristic h (bidirectional A*) both sides use the average potential
+   p(v) = (h(v, goal) - h(start, v)) / 2, forward keys d(v) + p(v) and backward
+   keys d(v) - p(v). The reduced edge costs w + p(v) - p(u) are then the same in
+   both directions and non-negative for any consistent h, so this is
+   bidirectional Dijkstra on the reduced graph and the same stopping rule
+   applies. Keys are then doubled to keep p integral; without a heuristic they
+   stay plain distances, so monotone queues keep their bucket range.
+   ========================================================================== */
 
-static int pq_decrease_key(PriorityQueue *pq, int node, int new_priority) {
-    int idx = pq->heap_index[node];
-    if (idx < 0 || idx >= pq->size) return -1;
-    if (new_priority >= pq->nodes[idx].priority) return 0;
-    pq->nodes[idx].priority = new_priority;
-    pq_heapify_up(pq, idx);
-    return 0;
+typedef struct {
+    const Graph *graph;
+    int (*heuristic)(int, int);
+    int start_ext;
+    int goal_ext;
+} BidirPotential;
+
+/* Queue key of v at distance d from its side's root: d, or 2 * (d ± p(v)) with a heuristic */
+static long long bidir_key(const BidirPotential *pot, int backward, int v, long long d) {
+    if (!pot->heuristic) {
+        return d;
+    }
+    int v_ext = graph_to_external(pot->graph, v);
+    long long p2 = (long long)pot->heuristic(v_ext, pot->goal_ext) - pot->heuristic(pot->start_ext, v_ext);
+    return 2 * d + (backward ? -p2 : p2);
 }
 
-static int pq_pop_min(PriorityQueue *pq, int *node_out, int *priority_out) {
-    if (pq->size == 0) return -1;
-
-    *node_out = pq->nodes[0].node;
-    *priority_out = pq->nodes[0].priority;
+/* Relaxes the edge u → from_to of one direction and updates the meeting point */
+static int bidir_scan(SearchContext *ctx, const BidirPotential *pot, int backward, int u, int from_to,
+                      long long w, long long *mu, int *meet) {
+    unsigned int gen = ctx->generation;
+    unsigned int *stamp = backward ? ctx->stampBack : ctx->stamp;
+    long long *dist = backward ? ctx->distBack : (long long *)ctx->dist;
+    int *parent = backward ? ctx->parentBack : ctx->parent;
+    const unsigned int *other_stamp = backward ? ctx->stamp : ctx->stampBack;
+    const long long *other_dist = backward ? (const long long *)ctx->dist : ctx->distBack;
+
+    long long nd = dist[u] + w;
+    if (stamp[from_to] == gen && nd >= dist[from_to]) {
+        return 0;
+    }
 
-    pq->heap_index[*node_out] = -1;
+    stamp[from_to] = gen;
+    dist[from_to] = nd;
+    parent[from_to] = u;
 
-    pq->size--;
-    if (pq->size > 0) {
-        pq->nodes[0] = pq->nodes[pq->size];
-        pq->heap_index[pq->nodes[0].node] = 0;
-        pq_heapify_down(pq, 0);
+    if (other_stamp[from_to] == gen && nd + other_dist[from_to] < *mu) {
+        *mu = nd + other_dist[from_to];
+        *meet = from_to;
     }
 
-    return 0;
+    return pqueue_push(backward ? ctx->queueBack : ctx->queue, from_to, bidir_key(pot, backward, from_to, nd));
 }
 
-static bool pq_contains(PriorityQueue *pq, int node) {
-    int idx = pq->heap_index[node];
-    return (idx >= 0 && idx < pq->size);
-}
-
-/* ============================================================================
-   A* – shortest path with heuristic
-   ========================================================================== */
-
-int astar_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, int *out_distance, int (*heuristic)(int, int)) {
+static int bidirectional_search(Graph *graph, int start, int goal, int *out_path, int max_path_len,
+                                long long *out_distance, int (*heuristic)(int, int)) {
     if (!graph || !out_path || !out_distance || start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices || max_path_len < 2) {
         if (out_distance) *out_distance = -1;
         return 0;
     }
 
-    int n = graph->numVertices;
-
-    int *dist    = malloc(n * sizeof(int));
-    int *parent  = malloc(n * sizeof(int));
-    int *f_score = malloc(n * sizeof(int));
-    PriorityQueue *pq = pq_create(n);
-
-    if (!dist || !parent || !f_score || !pq) {
-        free(dist);
-        free(parent);
-        free(f_score);
-        pq_destroy(pq);
-        if (out_distance) *out_distance = -1;
+    const GraphCSR *rev = graph_reverse(graph);
+    SearchContext *ctx = rev && landmarks_heuristic_usable(heuristic, graph)
+                         ? search_begin_queue(graph, heuristic != NULL, 1) : NULL;
+    if (!ctx) {
+        *out_distance = -1;
         return 0;
     }
 
-    for (int i = 0; i < n; i++) {
-        dist[i] = INT_MAX;
-        f_score[i] = INT_MAX;
-        parent[i] = -1;
-    }
-
-    dist[start] = 0;
-    f_score[start] = heuristic ? heuristic(start, goal) : 0;
-    pq_insert(pq, start, f_score[start]);
-
-    while (pq->size > 0) {
-        int current, current_f;
-        if (pq_pop_min(pq, &current, &current_f) != 0) {
+    BidirPotential pot = { graph, heuristic, start, goal };
+    start = graph_to_internal(graph, start);
+    goal  = graph_to_internal(graph, goal);
+
+    unsigned int gen = ctx->generation;
+    long long *dist_fwd = ctx->dist;
+    long long *dist_bwd = ctx->distBack;
+
+    ctx->stamp[start] = gen;
+    dist_fwd[start] = 0;
+    ctx->parent[start] = -1;
+    ctx->stampBack[goal] = gen;
+    dist_bwd[goal] = 0;
+    ctx->parentBack[goal] = -1;
+
+    long long mu = start == goal ? 0 : LLONG_MAX;
+    int meet = start == goal ? start : -1;
+    /* Radii are the last popped keys; both start out at the roots */
+    long long radius_fwd = bidir_key(&pot, 0, start, 0);
+    long long radius_bwd = bidir_key(&pot, 1, goal, 0);
+    long long key_scale = heuristic ? 2 : 1;
+    int failed = pqueue_push(ctx->queue, start, radius_fwd) != 0 ||
+                 pqueue_push(ctx->queueBack, goal, radius_bwd) != 0;
+
+    /* Once either side runs dry its distances are final, and so is mu */
+    while (!failed && ctx->queue->size > 0 && ctx->queueBack->size > 0) {
+        int backward = radius_bwd < radius_fwd;
+        int u;
+        long long key;
+        if (pqueue_pop(backward ? ctx->queueBack : ctx->queue, &u, &key) != 0) {
+            failed = 1;     /* Both queues are non-empty, so only PQUEUE_NO_MEMORY */
             break;
         }
 
-        if (current == goal) {
-            int path_len = reconstruct_path(start, goal, parent,
-                                            out_path, max_path_len, n);
-            if (path_len == 0) {
-                if (out_distance) *out_distance = -1;
-            } else {
-                if (out_distance) *out_distance = dist[goal];
-            }
-            free(dist);
-            free(parent);
-            free(f_score);
-            pq_destroy(pq);
-            return path_len;
+        /* Stopping criterion: every unsettled connection is at least radius_fwd + radius_bwd */
+        if (backward) radius_bwd = key; else radius_fwd = key;
+        if (mu != LLONG_MAX && radius_fwd + radius_bwd >= key_scale * mu) {
+            break;
         }
+        ctx->settled++;
 
-        for (Edge *e = graph->array[current].head; e != NULL; e = e->next) {
-            int nei = e->to;
-            int w   = e->weight;
-            if (w < 0) {
-                continue;
-            }
-            if (dist[current] == INT_MAX) continue;
-
-            long tentative = (long)dist[current] + w;
-            if (tentative < dist[nei]) {
-                dist[nei] = (tentative > INT_MAX) ? INT_MAX : (int)tentative;
-                parent[nei] = current;
-                int h = heuristic ? heuristic(nei, goal) : 0;
-                f_score[nei] = dist[nei] + h;
-
-                if (pq_contains(pq, nei)) {
-                    pq_decrease_key(pq, nei, f_score[nei]);
-                } else {
-                    pq_insert(pq, nei, f_score[nei]);
-                }
+        GraphEdgeIter it;
+        if (backward) {
+            graph_reverse_edges_begin(graph, rev, u, &it);
+        } else {
+            graph_edges_begin(graph, u, &it);
+        }
+        while (graph_edges_next(&it)) {
+            if (it.weight >= 0 && bidir_scan(ctx, &pot, backward, u, it.to, it.weight, &mu, &meet) != 0) {
+                failed = 1;
+                break;
             }
         }
     }
 
-    if (out_distance) *out_distance = -1;
-    free(dist);
-    free(parent);
-    free(f_score);
-    pq_destroy(pq);
-    return 0;
-}
-
-/* ============================================================================
-   Bellman-Ford – handles negative weights + detects negative cycles reachable
-   from start
-   ========================================================================== */
-
-int bellman_ford_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, int *out_distance) {
-    if (!graph || !out_path || !out_distance) {
-        if (out_distance) *out_distance = -1;
-        return 0;
-    }
+    pqueue_clear(ctx->queue);
+    pqueue_clear(ctx->queueBack);
 
-    if (start < 0 || goal < 0 ||
-        start >= graph->numVertices || goal >= graph->numVertices ||
-        max_path_len <= 0) {
+    if (failed || meet < 0) {
         *out_distance = -1;
         return 0;
     }
 
-    if (start == goal) {
-        out_path[0] = start;
-        *out_distance = 0;
-        return 1;
+    /* start → meet from the forward tree, then meet → goal along the backward successors */
+    int path_len = reconstruct_path(graph, start, meet, ctx->parent, out_path, max_path_len);
+    for (int v = ctx->parentBack[meet]; path_len > 0 && v != -1; v = ctx->parentBack[v]) {
+        if (path_len >= max_path_len || path_len >= graph->numVertices) {
+            path_len = 0;
+            break;
+        }
+        out_path[path_len++] = graph_to_external(graph, v);
     }
 
-    int n = graph->numVertices;
+    *out_distance = path_len > 0 ? mu : -1;
+    return path_len;
+}
 
-    int *dist   = malloc(n * sizeof(int));
-    int *parent = malloc(n * sizeof(int));
-    if (!dist || !parent) {
-        free(dist);
-        free(parent);
-        *out_distance = -1;
-        return 0;
-    }
+int bidirectional_dijkstra_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance) {
+    return bidirectional_search(graph, start, goal, out_path, max_path_len, out_distance, NULL);
+}
 
-    for (int i = 0; i < n; i++) {
-        dist[i] = INT_MAX;
-        parent[i] = -1;
-    }
-    dist[start] = 0;
+int bidirectional_astar_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance, int (*heuristic)(int, int)) {
+    return bidirectional_search(graph, start, goal, out_path, max_path_len, out_distance, heuristic);
+}
 
-    for (int iteration = 0; iteration < n - 1; iteration++) {
-        bool changed = false;
+int search_last_settled(void) {
+    SearchContext *ctx = search_context_current(0);
+    return ctx ? ctx->settled : 0;
+}
 
-        for (int u = 0; u < n; u++) {
-            if (dist[u] == INT_MAX) continue;
+/* ============================================================================
+   A* heuristics
+   ========================================================================== */
 
-            Edge *edge = graph->array[u].head;
-            while (edge != NULL) {
-                int v = edge->to;
-                int weight = edge->weight;
+#ifndef GRID_WIDTH
+#define GRID_WIDTH 5
+#endif
 
-                long long new_distance =
-                    (long long)dist[u] + (long long)weight;
+int simple_manhattan_heuristic(int a, int b) {
+    int ax = a % GRID_WIDTH;
+    int ay = a / GRID_WIDTH;
+    int bx = b % GRID_WIDTH;
+    int by = b / GRID_WIDTH;
+    return abs(ax - bx) + abs(ay - by);
+}
 
-                if (new_distance < (long long)dist[v]) {
-                    if (new_distance < INT_MIN) {
-                        dist[v] = INT_MIN;
-                    } else if (new_distance > INT_MAX) {
-                        dist[v] = INT_MAX;
-                    } else {
-                        dist[v] = (int)new_distance;
-                    }
-                    parent[v] = u;
-                    changed = true;
-                }
+int simple_euclidean_heuristic(int a, int b) {
+    int ax = a % GRID_WIDTH, ay = a / GRID_WIDTH;
+    int bx = b % GRID_WIDTH, by = b / GRID_WIDTH;
+    int dx = ax - bx;
+    int dy = ay - by;
+    return (int)(sqrt(dx * dx + dy * dy) + 0.5);
+}
 
-                edge = edge->next;
-            }
-        }
+/* ============================================================================
+   A* – shortest path with heuristic
+   ========================================================================== */
 
-        if (!changed) {
-            break;
-        }
+int astar_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance, int (*heuristic)(int, int)) {
+    if (!graph || !out_path || !out_distance || start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices || max_path_len < 2) {
+        if (out_distance) *out_distance = -1;
+        return 0;
     }
 
-    bool *affected_by_neg_cycle = calloc(n, sizeof(bool));
-    if (!affected_by_neg_cycle) {
-        free(dist);
-        free(parent);
+    if (graph_freeze(graph) != 0 || !landmarks_heuristic_usable(heuristic, graph)) {
         *out_distance = -1;
         return 0;
     }
 
-    for (int u = 0; u < n; u++) {
-        if (dist[u] == INT_MAX) continue;
-        Edge *edge = graph->array[u].head;
-        while (edge != NULL) {
-            int v = edge->to;
-            int weight = edge->weight;
-
-            long long new_distance =
-                (long long)dist[u] + (long long)weight;
+    start = graph_to_internal(graph, start);
+    goal  = graph_to_internal(graph, goal);
 
-            if (new_distance < (long long)dist[v]) {
-                affected_by_neg_cycle[v] = true;
-            }
-
-            edge = edge->next;
-        }
-    }
-
-    for (int iter = 0; iter < n; iter++) {
-        for (int u = 0; u < n; u++) {
-            if (!affected_by_neg_cycle[u]) continue;
-            Edge *edge = graph->array[u].head;
-            while (edge != NULL) {
-                affected_by_neg_cycle[edge->to] = true;
-                edge = edge->next;
-            }
-        }
-    }
+    const SsspKernel *kernel = sssp_kernel_for(graph);
+    SearchContext *ctx = search_begin_queue(graph, heuristic != NULL, 0);
+    long long dist = -1;
 
-    if (affected_by_neg_cycle[goal]) {
-        free(dist);
-        free(parent);
-        free(affected_by_neg_cycle);
+    if (!kernel || !ctx || kernel->astar(graph, ctx, start, goal, &dist, heuristic) != 0) {
         *out_distance = -1;
         return 0;
     }
 
-    free(affected_by_neg_cycle);
+    int path_len = reconstruct_path(graph, start, goal, ctx->parent, out_path, max_path_len);
 
-    if (dist[goal] == INT_MAX) {
-        free(dist);
-        free(parent);
-        *out_distance = -1;
-        return 0;
-    }
+    *out_distance = path_len > 0 ? dist : -1;
+    return path_len;
+}
 
-    int *temp_path = malloc(n * sizeof(int));
-    if (!temp_path) {
-        free(dist);
-        free(parent);
-        *out_distance = -1;
+/* ============================================================================
+   Bellman-Ford – handles negative weights + detects negative cycles reachable
+   from start
+   ========================================================================== */
+
+int bellman_ford_shortest_path(Graph *graph, int start, int goal, int *out_path, int max_path_len, long long *out_distance) {
+    if (!graph || !out_path || !out_distance) {
+        if (out_distance) *out_distance = -1;
         return 0;
     }
 
-    bool *visited = calloc(n, sizeof(bool));
-    if (!visited) {
-        free(temp_path);
-        free(dist);
-        free(parent);
+    if (start < 0 || goal < 0 ||
+        start >= graph->numVertices || goal >= graph->numVertices ||
+        max_path_len <= 0) {
         *out_distance = -1;
         return 0;
     }
 
-    int path_length = 0;
-    int current = goal;
-
-    while (current != -1 && path_length < n) {
-        if (visited[current]) {
-            free(visited);
-            free(temp_path);
-            free(dist);
-            free(parent);
-            *out_distance = -1;
-            return 0;
-        }
-        visited[current] = true;
-
-        temp_path[path_length++] = current;
-        if (current == start) {
-            break;
-        }
-        current = parent[current];
+    if (start == goal) {
+        out_path[0] = start;
+        *out_distance = 0;
+        return 1;
     }
 
-    free(visited);
-
-    if (path_length == 0 || temp_path[path_length - 1] != start) {
-        free(temp_path);
-        free(dist);
-        free(parent);
+    if (graph_freeze(graph) != 0) {
         *out_distance = -1;
         return 0;
     }
 
-    if (path_length > max_path_len) {
-        free(temp_path);
-        free(dist);
-        free(parent);
+    start = graph_to_internal(graph, start);
+    goal  = graph_to_internal(graph, goal);
+
+    const SsspKernel *kernel = sssp_kernel_for(graph);
+    SearchContext *ctx = search_context_current(graph->numVertices);
+    long long dist_goal = -1;
+
+    if (!kernel || !ctx || kernel->bellman_ford(graph, ctx, start, goal, &dist_goal) != 0) {
         *out_distance = -1;
         return 0;
     }
 
-    for (int i = 0; i < path_length; i++) {
-        out_path[i] = temp_path[path_length - 1 - i];
-    }
-
-    *out_distance = dist[goal];
-
-    free(temp_path);
-    free(dist);
-    free(parent);
-
+    /* The kernel rejects goals affected by a negative cycle; the walk also stops on a parent cycle */
+    int path_length = reconstruct_path(graph, start, goal, ctx->parent, out_path, max_path_len);
+    *out_distance = path_length > 0 ? dist_goal : -1;
     return path_length;
-}
\ No newline at end of file
+}
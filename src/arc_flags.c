@@ -0,0 +1,308 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "../include/arc_flags.h"
+#include "../include/algorithms.h"
+#include "../include/parallel.h"
+#include "../include/partition.h"
+#include "../include/pqueue.h"
+#include "../include/search_context.h"
+
+/* Distance of a vertex the current backward search has not reached */
+#define ARC_UNSEEN LLONG_MAX
+
+/* ============================================================================
+   Flag computation – one backward Dijkstra per boundary vertex
+   ========================================================================== */
+
+typedef struct {
+    Graph *graph;
+    const GraphCSR *rev;
+    const int *regionOf;
+    const unsigned char *boundary;
+    int numRegions;
+    int words;              /* 64-bit words per region row */
+    uint64_t *rows;         /* region-major: bit e of row r = flags[e] bit r */
+    long long maxWeight;
+    int *failed;            /* per team member */
+} FlagJob;
+
+static inline void flag_row_set(uint64_t *row, int e) {
+    row[e >> 6] |= 1ULL << (e & 63);
+}
+
+/*
+ * Backward Dijkstra from b over the incoming edges, then flags every edge
+ * u → v with dist(u) = w + dist(v): those are exactly the edges on some
+ * shortest path to b.
+ */
+static int flag_boundary_vertex(const FlagJob *job, PQueue *pq, long long *dist, int *settled, int b, uint64_t *row) {
+    int count = 0;
+
+    pqueue_clear(pq);
+    dist[b] = 0;
+    if (pqueue_push(pq, b, 0) != 0) {
+        return -1;
+    }
+
+    int u, popped;
+    long long du;
+    while ((popped = pqueue_pop(pq, &u, &du)) == 0) {
+        settled[count++] = u;
+
+        GraphEdgeIter it;
+        for (graph_reverse_edges_begin(job->graph, job->rev, u, &it); graph_edges_next(&it); ) {
+            long long nd = du + it.weight;
+            if (nd < dist[it.to]) {
+                dist[it.to] = nd;
+                if (pqueue_push(pq, it.to, nd) != 0) {
+                    pqueue_clear(pq);
+                    return -1;
+                }
+            }
+        }
+    }
+    if (popped == PQUEUE_NO_MEMORY) {
+        pqueue_clear(pq);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int x = settled[i];
+        GraphEdgeIter it;
+        for (graph_edges_begin(job->graph, x, &it); graph_edges_next(&it); ) {
+            if (it.edge >= 0 && dist[it.to] != ARC_UNSEEN && dist[it.to] + it.weight == dist[x]) {
+                flag_row_set(row, it.edge);
+            }
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        dist[settled[i]] = ARC_UNSEEN;
+    }
+    return 0;
+}
+
+/* Flags the regions of one team member's slice */
+static void flag_member(void *ctx, ParallelTeam *team, int member, int size) {
+    const FlagJob *job = ctx;
+    int n = job->graph->numVertices;
+    int first, last, failed = 0;
+    (void)team;
+    parallel_slice(job->numRegions, member, size, &first, &last);
+    long long *dist = malloc(n * sizeof(long long));
+    int *settled = malloc(n * sizeof(int));
+    PQueue *pq = pqueue_create(pqueue_kind_for_max_weight(job->maxWeight), n, job->maxWeight);
+
+    if (!dist || !settled || !pq) {
+        failed = 1;
+    } else {
+        for (int v = 0; v < n; v++) {
+            dist[v] = ARC_UNSEEN;
+        }
+    }
+
+    for (int r = first; !failed && r < last; r++) {
+        uint64_t *row = job->rows + (size_t)r * job->words;
+        for (int v = 0; v < n && !failed; v++) {
+            if (job->regionOf[v] == r && job->boundary[v] &&
+                flag_boundary_vertex(job, pq, dist, settled, v, row) != 0) {
+                failed = 1;
+            }
+        }
+    }
+
+    free(dist);
+    free(settled);
+    pqueue_destroy(pq);
+    job->failed[member] = failed;
+}
+
+/* Splits the regions across a team of up to num_threads members */
+static int flag_regions(FlagJob *job, int num_threads) {
+    int members = parallel_threads(num_threads, job->numRegions);
+    job->failed = calloc(members, sizeof(int));
+    if (!job->failed) {
+        return -1;
+    }
+
+    parallel_run(members, flag_member, job);
+
+    int failed = 0;
+    for (int t = 0; t < members; t++) {
+        failed |= job->failed[t];
+    }
+    free(job->failed);
+    job->failed = NULL;
+    return failed ? -1 : 0;
+}
+
+ArcFlags *arc_flags_build(Graph *graph, int num_regions, int num_threads) {
+    if (!graph || num_regions < 1 || num_regions > ARC_FLAGS_MAX_REGIONS || graph_freeze(graph) != 0) {
+        return NULL;
+    }
+    if (num_threads <= 0) {
+        num_threads = ARC_FLAGS_DEFAULT_THREADS;
+    }
+
+    int n = graph->numVertices;
+    int m = graph->csr.numEdges;
+    int k = num_regions < n ? num_regions : n;
+    int words = (m + 63) / 64;
+    const GraphCSR *rev = graph_reverse(graph);
+
+    ArcFlags *af = calloc(1, sizeof(ArcFlags));
+    unsigned char *boundary = calloc(n, 1);
+    uint64_t *rows = calloc((size_t)k * (words > 0 ? words : 1), sizeof(uint64_t));
+    if (af) {
+        af->numVertices = n;
+        af->numEdges = m;
+        af->graphVersion = graph_version(graph);
+        af->numRegions = k;
+        af->regionOf = malloc(n * sizeof(int));
+        af->flags = calloc(m > 0 ? m : 1, sizeof(uint64_t));
+    }
+
+    int ok = rev && af && af->regionOf && af->flags && boundary && rows;
+    if (ok) {
+        memset(af->regionOf, 0, n * sizeof(int));
+        ok = graph_partition_bisect(graph, af->regionOf, 1, k, 1) == k;
+    }
+
+    /* Edges inside a region carry its flag; heads of edges entering a region are its boundary */
+    for (int u = 0; ok && u < n; u++) {
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            int r = af->regionOf[it.to];
+            if (it.weight < 0) {
+                ok = 0;
+                break;
+            }
+            if (af->regionOf[u] != r) {
+                boundary[it.to] = 1;
+            } else if (it.edge >= 0) {
+                flag_row_set(rows + (size_t)r * words, it.edge);
+            }
+        }
+    }
+
+    if (ok) {
+        FlagJob job = { graph, rev, af->regionOf, boundary, k, words, rows, graph_max_weight(graph), NULL };
+        ok = flag_regions(&job, num_threads) == 0;
+    }
+
+    /* Region-major rows (one writer each) → one mask per edge */
+    for (int r = 0; ok && r < k; r++) {
+        const uint64_t *row = rows + (size_t)r * words;
+        for (int w = 0; w < words; w++) {
+            for (uint64_t bits = row[w]; bits; bits &= bits - 1) {
+                af->flags[w * 64 + __builtin_ctzll(bits)] |= 1ULL << r;
+            }
+        }
+    }
+
+    free(boundary);
+    free(rows);
+    if (!ok) {
+        arc_flags_free(af);
+        return NULL;
+    }
+    return af;
+}
+
+void arc_flags_free(ArcFlags *af) {
+    if (!af) {
+        return;
+    }
+    free(af->regionOf);
+    free(af->flags);
+    free(af);
+}
+
+/* ============================================================================
+   Query – Dijkstra restricted to edges flagged for the goal's region
+   ========================================================================== */
+
+int arc_flags_shortest_path(const ArcFlags *af, Graph *graph, int start, int goal,
+                            int *out_path, int max_path_len, long long *out_distance) {
+    if (!af || !graph || !out_path || !out_distance || af->numVertices != graph->numVertices ||
+        start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices || max_path_len < 1) {
+        if (out_distance) *out_distance = -1;
+        return 0;
+    }
+    *out_distance = -1;
+
+    if (graph_freeze(graph) != 0 || graph_version(graph) != af->graphVersion) {
+        return 0;
+    }
+
+    long long max_weight = graph_max_weight(graph);
+    PQueueKind kind = search_get_queue();
+    if (kind == PQ_AUTO) {
+        kind = pqueue_kind_for_max_weight(max_weight);
+    }
+    SearchContext *ctx = search_context_current(graph->numVertices);
+    if (!ctx || !search_context_queue(ctx, kind, max_weight)) {
+        return 0;
+    }
+    unsigned int gen = search_context_begin(ctx);
+
+    int s = graph_to_internal(graph, start);
+    int t = graph_to_internal(graph, goal);
+    uint64_t bit = 1ULL << af->regionOf[t];
+    long long *dist = ctx->dist;
+    int *parent = ctx->parent;
+    unsigned int *stamp = ctx->stamp;
+    PQueue *pq = ctx->queue;
+
+    stamp[s] = gen;
+    dist[s] = 0;
+    parent[s] = -1;
+    int failed = pqueue_push(pq, s, 0) != 0;
+
+    int u, popped = 0;
+    long long du;
+    while (!failed && (popped = pqueue_pop(pq, &u, &du)) == 0) {
+        ctx->settled++;
+        if (u == t) break;
+
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            if ((it.edge >= 0 && !(af->flags[it.edge] & bit)) || it.weight < 0) {
+                continue;
+            }
+            long long nd = du + it.weight;
+            if (stamp[it.to] == gen && nd >= dist[it.to]) {
+                continue;
+            }
+            stamp[it.to] = gen;
+            dist[it.to] = nd;
+            parent[it.to] = u;
+            if (pqueue_push(pq, it.to, nd) != 0) {
+                failed = 1;
+                break;
+            }
+        }
+    }
+    failed = failed || popped == PQUEUE_NO_MEMORY;
+    pqueue_clear(pq);
+
+    if (failed || stamp[t] != gen) {
+        return 0;
+    }
+
+    /* Count, then fill the path backwards from the goal */
+    int len = 0;
+    for (int x = t; x != -1 && len <= graph->numVertices; x = parent[x]) len++;
+    if (len > max_path_len || len > graph->numVertices) {
+        return 0;
+    }
+    int x = t;
+    for (int i = len - 1; i >= 0; i--) {
+        out_path[i] = graph_to_external(graph, x);
+        x = parent[x];
+    }
+
+    *out_distance = dist[t];
+    return len;
+}
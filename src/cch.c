@@ -0,0 +1,479 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cch.h"
+#include "../include/parallel.h"
+
+/* Subsets this small are not dissected further; their vertices are ranked as they come */
+#define ND_LEAF_SIZE 8
+
+/* Rounds with fewer ranks than this run on the calling thread */
+#define CCH_PARALLEL_MIN 256
+
+/* ============================================================================
+   Nested dissection order – topology only, edges taken in both directions
+   ========================================================================== */
+
+typedef struct {
+    const Graph *graph;
+    const GraphCSR *rev;
+    int *label;         /* subset id per vertex; BFS only walks the current subset */
+    int nextLabel;
+    int *level;         /* BFS level, -1 = not reached */
+    int *queue;         /* BFS order */
+    int *rankOf;
+    int nextRank;       /* ranks are handed out top-down */
+} NdState;
+
+static void nd_dissect(NdState *st, int *verts, int count);
+
+/* Appends the vertices of subset id reachable from root to queue[*tail..] */
+static void nd_bfs(NdState *st, int root, int id, int *tail) {
+    int head = *tail;
+    st->level[root] = 0;
+    st->queue[(*tail)++] = root;
+
+    while (head < *tail) {
+        int u = st->queue[head++];
+        GraphEdgeIter it;
+        for (int pass = 0; pass < 2; pass++) {
+            if (pass == 0) {
+                graph_edges_begin(st->graph, u, &it);
+            } else {
+                graph_reverse_edges_begin(st->graph, st->rev, u, &it);
+            }
+            while (graph_edges_next(&it)) {
+                int x = it.to;
+                if (st->label[x] == id && st->level[x] < 0) {
+                    st->level[x] = st->level[u] + 1;
+                    st->queue[(*tail)++] = x;
+                }
+            }
+        }
+    }
+}
+
+static void nd_rank_all(NdState *st, const int *verts, int count) {
+    for (int i = 0; i < count; i++) {
+        st->rankOf[verts[i]] = st->nextRank--;
+    }
+}
+
+/* Splits a connected subset at the middle BFS level from a pseudo-peripheral vertex */
+static void nd_component(NdState *st, int *verts, int count) {
+    if (count <= ND_LEAF_SIZE) {
+        nd_rank_all(st, verts, count);
+        return;
+    }
+
+    int id = ++st->nextLabel;
+    for (int i = 0; i < count; i++) {
+        st->label[verts[i]] = id;
+        st->level[verts[i]] = -1;
+    }
+    int tail = 0;
+    nd_bfs(st, verts[0], id, &tail);
+    int root = st->queue[count - 1];
+
+    for (int i = 0; i < count; i++) st->level[verts[i]] = -1;
+    tail = 0;
+    nd_bfs(st, root, id, &tail);
+
+    int depth = st->level[st->queue[count - 1]];
+    if (depth < 2) {
+        nd_rank_all(st, verts, count);
+        return;
+    }
+    int cut = st->level[st->queue[count / 2]];
+    if (cut == 0) cut = 1;
+    if (cut == depth) cut = depth - 1;
+
+    /* Separator above both halves; the halves are dissected on their own */
+    int low = 0, high = count;
+    for (int i = 0; i < count; i++) {
+        int v = st->queue[i];
+        if (st->level[v] < cut) {
+            verts[low++] = v;
+        } else if (st->level[v] > cut) {
+            verts[--high] = v;
+        } else {
+            st->rankOf[v] = st->nextRank--;
+        }
+    }
+    nd_dissect(st, verts, low);
+    nd_dissect(st, verts + high, count - high);
+}
+
+/* Dissects every connected component of the subset */
+static void nd_dissect(NdState *st, int *verts, int count) {
+    if (count <= ND_LEAF_SIZE) {
+        nd_rank_all(st, verts, count);
+        return;
+    }
+
+    int id = ++st->nextLabel;
+    for (int i = 0; i < count; i++) {
+        st->label[verts[i]] = id;
+        st->level[verts[i]] = -1;
+    }
+
+    /* Group verts by component, then handle one component at a time */
+    int tail = 0;
+    for (int i = 0; i < count; i++) {
+        if (st->level[verts[i]] < 0) {
+            nd_bfs(st, verts[i], id, &tail);
+        }
+    }
+    memcpy(verts, st->queue, count * sizeof(int));
+
+    int begin = 0;
+    while (begin < count) {
+        int end = begin + 1;
+        while (end < count && st->level[verts[end]] != 0) end++;
+        nd_component(st, verts + begin, end - begin);
+        begin = end;
+    }
+}
+
+/* ============================================================================
+   Metric-independent contraction (symbolic elimination)
+   ========================================================================== */
+
+typedef struct {
+    int *items;
+    int size;
+    int capacity;
+} RankList;
+
+static int rank_list_push(RankList *list, int r) {
+    if (list->size == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 4;
+        int *items = realloc(list->items, capacity * sizeof(int));
+        if (!items) return -1;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->size++] = r;
+    return 0;
+}
+
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void rank_list_sort_unique(RankList *list) {
+    if (list->size < 2) return;
+    qsort(list->items, list->size, sizeof(int), compare_int);
+    int k = 1;
+    for (int i = 1; i < list->size; i++) {
+        if (list->items[i] != list->items[k - 1]) list->items[k++] = list->items[i];
+    }
+    list->size = k;
+}
+
+/*
+ * Upward neighbours per rank after contracting every vertex in rank order.
+ * Contracting r must connect all of its upward neighbours; handing them to the
+ * lowest one (r's parent in the elimination tree) is enough, because the
+ * parent is contracted next among them and passes them on in turn.
+ */
+static int cch_symbolic(const Graph *graph, const int *rank_of, RankList *up) {
+    int n = graph->numVertices;
+    for (int u = 0; u < n; u++) {
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            int a = rank_of[u], b = rank_of[it.to];
+            if (a == b) continue;
+            if (rank_list_push(&up[a < b ? a : b], a < b ? b : a) != 0) return -1;
+        }
+    }
+
+    for (int r = 0; r < n; r++) {
+        rank_list_sort_unique(&up[r]);
+        if (up[r].size < 2) continue;
+        RankList *parent = &up[up[r].items[0]];
+        for (int i = 1; i < up[r].size; i++) {
+            if (rank_list_push(parent, up[r].items[i]) != 0) return -1;
+        }
+    }
+    return 0;
+}
+
+/* ============================================================================
+   Build / free
+   ========================================================================== */
+
+static int cch_index(CustomizableCH *cch) {
+    const ContractionHierarchy *h = cch->hierarchy;
+    int n = h->numVertices;
+
+    /* Lower neighbours of each rank, ascending, with the arc that links them */
+    cch->lowerOffsets = calloc(n + 1, sizeof(int));
+    cch->lowerVertex = malloc((cch->numArcs ? cch->numArcs : 1) * sizeof(int));
+    cch->lowerArc = malloc((cch->numArcs ? cch->numArcs : 1) * sizeof(int));
+    int *fill = malloc(n * sizeof(int));
+    int *round = malloc(n * sizeof(int));
+    if (!cch->lowerOffsets || !cch->lowerVertex || !cch->lowerArc || !fill || !round) {
+        free(fill);
+        free(round);
+        return -1;
+    }
+
+    for (int e = 0; e < cch->numArcs; e++) cch->lowerOffsets[h->upTargets[e] + 1]++;
+    for (int r = 0; r < n; r++) cch->lowerOffsets[r + 1] += cch->lowerOffsets[r];
+    memcpy(fill, cch->lowerOffsets, n * sizeof(int));
+    for (int v = 0; v < n; v++) {
+        for (int e = h->upOffsets[v]; e < h->upOffsets[v + 1]; e++) {
+            int slot = fill[h->upTargets[e]]++;
+            cch->lowerVertex[slot] = v;
+            cch->lowerArc[slot] = e;
+        }
+    }
+
+    /* Round of a rank: one past the latest round among its lower neighbours */
+    cch->numLevels = 0;
+    for (int a = 0; a < n; a++) {
+        round[a] = 0;
+        for (int i = cch->lowerOffsets[a]; i < cch->lowerOffsets[a + 1]; i++) {
+            if (round[cch->lowerVertex[i]] + 1 > round[a]) round[a] = round[cch->lowerVertex[i]] + 1;
+        }
+        if (round[a] + 1 > cch->numLevels) cch->numLevels = round[a] + 1;
+    }
+
+    cch->levelOffsets = calloc(cch->numLevels + 1, sizeof(int));
+    cch->levelRanks = malloc(n * sizeof(int));
+    if (!cch->levelOffsets || !cch->levelRanks) {
+        free(fill);
+        free(round);
+        return -1;
+    }
+    for (int a = 0; a < n; a++) cch->levelOffsets[round[a] + 1]++;
+    for (int l = 0; l < cch->numLevels; l++) cch->levelOffsets[l + 1] += cch->levelOffsets[l];
+    memcpy(fill, cch->levelOffsets, cch->numLevels * sizeof(int));
+    for (int a = 0; a < n; a++) cch->levelRanks[fill[round[a]]++] = a;
+
+    free(fill);
+    free(round);
+    return 0;
+}
+
+CustomizableCH *cch_build(Graph *graph) {
+    if (!graph || graph->numVertices <= 0 || graph_freeze(graph) != 0) {
+        return NULL;
+    }
+
+    const GraphCSR *rev = graph_reverse(graph);
+    int n = graph->numVertices;
+    CustomizableCH *cch = calloc(1, sizeof(CustomizableCH));
+    ContractionHierarchy *h = calloc(1, sizeof(ContractionHierarchy));
+    NdState st = {0};
+    int *verts = malloc(n * sizeof(int));
+    RankList *up = calloc(n, sizeof(RankList));
+
+    st.graph = graph;
+    st.rev = rev;
+    st.label = calloc(n, sizeof(int));
+    st.level = malloc(n * sizeof(int));
+    st.queue = malloc(n * sizeof(int));
+    st.nextRank = n - 1;
+    if (h) {
+        h->numVertices = n;
+        h->rankOf = malloc(n * sizeof(int));
+        h->vertexAt = malloc(n * sizeof(int));
+        st.rankOf = h->rankOf;
+    }
+
+    int ok = rev && cch && h && verts && up && st.label && st.level && st.queue && h->rankOf && h->vertexAt;
+    if (ok) {
+        cch->hierarchy = h;
+        h = NULL;
+        for (int v = 0; v < n; v++) verts[v] = v;
+        nd_dissect(&st, verts, n);
+        for (int v = 0; v < n; v++) cch->hierarchy->vertexAt[cch->hierarchy->rankOf[v]] = v;
+        ok = cch_symbolic(graph, cch->hierarchy->rankOf, up) == 0;
+    }
+
+    /* Upward and downward arcs share one topology: downward arc e of rank r comes from upTargets[e] */
+    if (ok) {
+        ContractionHierarchy *hc = cch->hierarchy;
+        hc->upOffsets = malloc((n + 1) * sizeof(int));
+        hc->downOffsets = malloc((n + 1) * sizeof(int));
+        ok = hc->upOffsets && hc->downOffsets;
+        if (ok) {
+            hc->upOffsets[0] = 0;
+            for (int r = 0; r < n; r++) hc->upOffsets[r + 1] = hc->upOffsets[r] + up[r].size;
+            memcpy(hc->downOffsets, hc->upOffsets, (n + 1) * sizeof(int));
+            int m = cch->numArcs = hc->upOffsets[n];
+            size_t slots = m ? m : 1;
+            hc->upTargets = malloc(slots * sizeof(int));
+            hc->downSources = malloc(slots * sizeof(int));
+            hc->upWeights = malloc(slots * sizeof(long long));
+            hc->downWeights = malloc(slots * sizeof(long long));
+            hc->upMiddle = malloc(slots * sizeof(int));
+            hc->downMiddle = malloc(slots * sizeof(int));
+            ok = hc->upTargets && hc->downSources && hc->upWeights && hc->downWeights && hc->upMiddle && hc->downMiddle;
+        }
+        for (int r = 0; ok && r < n; r++) {
+            if (up[r].size == 0) continue;
+            memcpy(hc->upTargets + hc->upOffsets[r], up[r].items, up[r].size * sizeof(int));
+            memcpy(hc->downSources + hc->upOffsets[r], up[r].items, up[r].size * sizeof(int));
+        }
+    }
+
+    if (ok) {
+        cch->orderVersion = graph_order_version(graph);
+    }
+    ok = ok && cch_index(cch) == 0 && cch_customize(cch, graph, 0) == 0;
+
+    for (int r = 0; up && r < n; r++) free(up[r].items);
+    free(up);
+    free(verts);
+    free(st.label);
+    free(st.level);
+    free(st.queue);
+    ch_free(h);
+    if (!ok) {
+        cch_free(cch);
+        return NULL;
+    }
+    return cch;
+}
+
+void cch_free(CustomizableCH *cch) {
+    if (!cch) {
+        return;
+    }
+    ch_free(cch->hierarchy);
+    free(cch->lowerOffsets);
+    free(cch->lowerVertex);
+    free(cch->lowerArc);
+    free(cch->levelOffsets);
+    free(cch->levelRanks);
+    free(cch);
+}
+
+/* ============================================================================
+   Customization
+   ========================================================================== */
+
+/* Index of arc {a, b} (a < b) in a's upward arcs, -1 if the topology lacks it */
+static int cch_find_arc(const ContractionHierarchy *h, int a, int b) {
+    int lo = h->upOffsets[a], hi = h->upOffsets[a + 1] - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (h->upTargets[mid] == b) return mid;
+        if (h->upTargets[mid] < b) lo = mid + 1; else hi = mid - 1;
+    }
+    return -1;
+}
+
+/*
+ * Finalizes the arcs {a, b} of rank a from its lower triangles {v, a, b}:
+ * a → v → b and b → v → a. Only a's own arcs are written, and every arc read
+ * belongs to a lower neighbour from an earlier round.
+ */
+static void cch_customize_rank(const CustomizableCH *cch, int a) {
+    ContractionHierarchy *h = cch->hierarchy;
+    int a_end = h->upOffsets[a + 1];
+
+    for (int i = cch->lowerOffsets[a]; i < cch->lowerOffsets[a + 1]; i++) {
+        int v = cch->lowerVertex[i];
+        int va = cch->lowerArc[i];
+        long long a_to_v = h->downWeights[va];
+        long long v_to_a = h->upWeights[va];
+        if (a_to_v == CH_NO_ARC && v_to_a == CH_NO_ARC) continue;
+
+        /* v's arcs after {v, a} lead to ranks above a, all of which a links to as well */
+        int ab = h->upOffsets[a];
+        for (int vb = va + 1; vb < h->upOffsets[v + 1]; vb++) {
+            int b = h->upTargets[vb];
+            while (ab < a_end && h->upTargets[ab] < b) ab++;
+            if (ab == a_end) break;
+
+            if (a_to_v != CH_NO_ARC && h->upWeights[vb] != CH_NO_ARC &&
+                a_to_v + h->upWeights[vb] < h->upWeights[ab]) {
+                h->upWeights[ab] = a_to_v + h->upWeights[vb];
+                h->upMiddle[ab] = v;
+            }
+            if (v_to_a != CH_NO_ARC && h->downWeights[vb] != CH_NO_ARC &&
+                h->downWeights[vb] + v_to_a < h->downWeights[ab]) {
+                h->downWeights[ab] = h->downWeights[vb] + v_to_a;
+                h->downMiddle[ab] = v;
+            }
+        }
+    }
+}
+
+/*
+ * Runs every round on one team member. Small rounds go to member 0 alone;
+ * the barrier after each round makes its arcs visible to the next one, so
+ * the workers are started once instead of once per round.
+ */
+static void cch_customize_rounds(void *ctx, ParallelTeam *team, int member, int size) {
+    const CustomizableCH *cch = ctx;
+
+    for (int l = 0; l < cch->numLevels; l++) {
+        const int *ranks = cch->levelRanks + cch->levelOffsets[l];
+        int count = cch->levelOffsets[l + 1] - cch->levelOffsets[l];
+        int first = 0, last = member == 0 ? count : 0;
+        if (count >= CCH_PARALLEL_MIN) {
+            parallel_slice(count, member, size, &first, &last);
+        }
+        for (int i = first; i < last; i++) {
+            cch_customize_rank(cch, ranks[i]);
+        }
+        parallel_barrier(team);
+    }
+}
+
+int cch_customize(CustomizableCH *cch, Graph *graph, int num_threads) {
+    if (!cch || !graph || graph->numVertices != cch->hierarchy->numVertices || graph_freeze(graph) != 0 ||
+        graph_order_version(graph) != cch->orderVersion) {
+        return -1;
+    }
+    if (num_threads <= 0) {
+        num_threads = CCH_DEFAULT_THREADS;
+    }
+
+    /* Queries stay refused until every arc is filled again */
+    ContractionHierarchy *h = cch->hierarchy;
+    h->graphVersion = 0;
+    for (int e = 0; e < cch->numArcs; e++) {
+        h->upWeights[e] = CH_NO_ARC;
+        h->downWeights[e] = CH_NO_ARC;
+        h->upMiddle[e] = -1;
+        h->downMiddle[e] = -1;
+    }
+
+    /* Original edges; parallel edges keep the lightest */
+    for (int u = 0; u < graph->numVertices; u++) {
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            int a = h->rankOf[u], b = h->rankOf[it.to];
+            if (a == b) continue;
+            if (it.weight < 0) return -1;
+
+            int e = cch_find_arc(h, a < b ? a : b, a < b ? b : a);
+            if (e < 0) return -1;
+            long long *w = a < b ? &h->upWeights[e] : &h->downWeights[e];
+            if (it.weight < *w) *w = it.weight;
+        }
+    }
+
+    /* Threads only pay off if some round is large enough to split */
+    int widest = 0;
+    for (int l = 0; l < cch->numLevels; l++) {
+        int count = cch->levelOffsets[l + 1] - cch->levelOffsets[l];
+        if (count > widest) widest = count;
+    }
+    parallel_run(widest >= CCH_PARALLEL_MIN ? parallel_threads(num_threads, widest) : 1,
+                 cch_customize_rounds, cch);
+
+    h->numShortcuts = 0;
+    for (int e = 0; e < cch->numArcs; e++) {
+        h->numShortcuts += (h->upMiddle[e] >= 0) + (h->downMiddle[e] >= 0);
+    }
+    h->graphVersion = graph_version(graph);
+    return 0;
+}
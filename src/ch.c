@@ -0,0 +1,522 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "../include/ch.h"
+#include "../include/pqueue.h"
+#include "../include/search_context.h"
+
+/* Settled-vertex limits of the witness searches: small while only estimating
+   a vertex's priority, larger when its shortcuts are actually inserted */
+#define CH_WITNESS_LIMIT_SIMULATE  64
+#define CH_WITNESS_LIMIT_CONTRACT  512
+
+/* ============================================================================
+   Remaining graph – per-vertex arc lists, at most one arc per (from, to) pair
+   ========================================================================== */
+
+typedef struct {
+    int to;             /* other endpoint (internal ID) */
+    long long weight;
+    int middle;         /* contracted middle vertex, -1 for an original edge */
+} ChArc;
+
+typedef struct {
+    ChArc *arcs;
+    int size;
+    int capacity;
+} ChArcList;
+
+typedef struct {
+    int n;
+    ChArcList *out;             /* arcs leaving v; frozen as v's upward arcs once contracted */
+    ChArcList *in;              /* arcs entering v; frozen as v's downward arcs */
+    int *deletedNeighbours;
+    int *rankOf;
+    int numShortcuts;
+
+    /* witness search workspace */
+    PQueue *witnessQueue;
+    unsigned int *stamp;
+    unsigned int generation;
+    long long *dist;
+} ChBuilder;
+
+static int arc_list_find(const ChArcList *list, int to) {
+    for (int i = 0; i < list->size; i++) {
+        if (list->arcs[i].to == to) return i;
+    }
+    return -1;
+}
+
+/* Adds the arc, or lowers the weight of an existing one; 1 if the list changed, -1 on allocation failure */
+static int arc_list_put(ChArcList *list, int to, long long weight, int middle) {
+    int i = arc_list_find(list, to);
+    if (i >= 0) {
+        if (weight >= list->arcs[i].weight) return 0;
+        list->arcs[i].weight = weight;
+        list->arcs[i].middle = middle;
+        return 1;
+    }
+
+    if (list->size == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 4;
+        ChArc *arcs = realloc(list->arcs, capacity * sizeof(ChArc));
+        if (!arcs) return -1;
+        list->arcs = arcs;
+        list->capacity = capacity;
+    }
+    list->arcs[list->size++] = (ChArc){ to, weight, middle };
+    return 1;
+}
+
+static void arc_list_remove(ChArcList *list, int to) {
+    int i = arc_list_find(list, to);
+    if (i >= 0) {
+        list->arcs[i] = list->arcs[--list->size];
+    }
+}
+
+/* Arc u → x in both lists; returns 1 if added or shortened */
+static int builder_add_arc(ChBuilder *b, int u, int x, long long weight, int middle) {
+    int changed = arc_list_put(&b->out[u], x, weight, middle);
+    if (changed <= 0) return changed;
+    return arc_list_put(&b->in[x], u, weight, middle) < 0 ? -1 : 1;
+}
+
+/* ============================================================================
+   Witness search and contraction
+   ========================================================================== */
+
+/* Local Dijkstra from source in the remaining graph without `skip`, up to max_dist */
+static int witness_search(ChBuilder *b, int source, int skip, long long max_dist, int limit) {
+    if (++b->generation == 0) {
+        memset(b->stamp, 0, b->n * sizeof(unsigned int));
+        b->generation = 1;
+    }
+    unsigned int gen = b->generation;
+
+    b->stamp[source] = gen;
+    b->dist[source] = 0;
+    if (pqueue_push(b->witnessQueue, source, 0) != 0) return -1;
+
+    int u, settled = 0;
+    long long du;
+    while (settled < limit && pqueue_pop(b->witnessQueue, &u, &du) == 0) {
+        if (du > max_dist) break;
+        settled++;
+
+        const ChArcList *out = &b->out[u];
+        for (int i = 0; i < out->size; i++) {
+            int x = out->arcs[i].to;
+            if (x == skip) continue;
+            long long nd = du + out->arcs[i].weight;
+            if (b->stamp[x] == gen && nd >= b->dist[x]) continue;
+            b->stamp[x] = gen;
+            b->dist[x] = nd;
+            if (pqueue_push(b->witnessQueue, x, nd) != 0) return -1;
+        }
+    }
+    pqueue_clear(b->witnessQueue);
+    return 0;
+}
+
+/*
+ * Finds the shortcuts contracting v needs and, unless simulating, inserts them.
+ * @return Number of shortcuts, -1 on allocation failure
+ */
+static int contract_shortcuts(ChBuilder *b, int v, int simulate) {
+    const ChArcList *in = &b->in[v];
+    const ChArcList *out = &b->out[v];
+    int limit = simulate ? CH_WITNESS_LIMIT_SIMULATE : CH_WITNESS_LIMIT_CONTRACT;
+    int shortcuts = 0;
+
+    long long max_out = 0;
+    for (int j = 0; j < out->size; j++) {
+        if (out->arcs[j].weight > max_out) max_out = out->arcs[j].weight;
+    }
+
+    for (int i = 0; i < in->size; i++) {
+        int u = in->arcs[i].to;
+        long long wu = in->arcs[i].weight;
+        if (witness_search(b, u, v, wu + max_out, limit) != 0) return -1;
+
+        for (int j = 0; j < out->size; j++) {
+            int x = out->arcs[j].to;
+            long long via = wu + out->arcs[j].weight;
+            if (x == u || (b->stamp[x] == b->generation && b->dist[x] <= via)) {
+                continue;
+            }
+            shortcuts++;
+            if (!simulate) {
+                int added = builder_add_arc(b, u, x, via, v);
+                if (added < 0) return -1;
+                b->numShortcuts += added;
+            }
+        }
+    }
+    return shortcuts;
+}
+
+/* Edge difference plus contracted neighbours; LLONG_MAX on failure */
+static long long contraction_priority(ChBuilder *b, int v) {
+    int shortcuts = contract_shortcuts(b, v, 1);
+    if (shortcuts < 0) return LLONG_MAX;
+    return (long long)shortcuts - b->in[v].size - b->out[v].size + b->deletedNeighbours[v];
+}
+
+static int contract_vertex(ChBuilder *b, int v) {
+    if (contract_shortcuts(b, v, 0) < 0) {
+        return -1;
+    }
+
+    /* v's lists now only hold higher-ranked neighbours and stay as they are */
+    for (int i = 0; i < b->out[v].size; i++) {
+        int x = b->out[v].arcs[i].to;
+        arc_list_remove(&b->in[x], v);
+        b->deletedNeighbours[x]++;
+    }
+    for (int i = 0; i < b->in[v].size; i++) {
+        int u = b->in[v].arcs[i].to;
+        arc_list_remove(&b->out[u], v);
+        b->deletedNeighbours[u]++;
+    }
+    return 0;
+}
+
+/* ============================================================================
+   Build / free
+   ========================================================================== */
+
+static void builder_free(ChBuilder *b) {
+    for (int v = 0; b->out && v < b->n; v++) free(b->out[v].arcs);
+    for (int v = 0; b->in && v < b->n; v++) free(b->in[v].arcs);
+    free(b->out);
+    free(b->in);
+    free(b->deletedNeighbours);
+    free(b->stamp);
+    free(b->dist);
+    pqueue_destroy(b->witnessQueue);
+}
+
+/* Copies the frozen per-vertex lists into rank-ordered CSR arrays */
+static int ch_store_arcs(const ChBuilder *b, const ChArcList *lists, int **offsets_out, int **ends,
+                         long long **weights, int **middles, const int *vertex_at) {
+    int n = b->n;
+    int *offsets = malloc((n + 1) * sizeof(int));
+    if (!offsets) return -1;
+
+    offsets[0] = 0;
+    for (int r = 0; r < n; r++) {
+        offsets[r + 1] = offsets[r] + lists[vertex_at[r]].size;
+    }
+
+    int m = offsets[n];
+    *offsets_out = offsets;
+    *ends = malloc((m ? m : 1) * sizeof(int));
+    *weights = malloc((m ? m : 1) * sizeof(long long));
+    *middles = malloc((m ? m : 1) * sizeof(int));
+    if (!*ends || !*weights || !*middles) return -1;
+
+    for (int r = 0; r < n; r++) {
+        const ChArcList *list = &lists[vertex_at[r]];
+        for (int i = 0; i < list->size; i++) {
+            int e = offsets[r] + i;
+            (*ends)[e] = b->rankOf[list->arcs[i].to];
+            (*weights)[e] = list->arcs[i].weight;
+            (*middles)[e] = list->arcs[i].middle >= 0 ? b->rankOf[list->arcs[i].middle] : -1;
+        }
+    }
+    return 0;
+}
+
+ContractionHierarchy *ch_build(Graph *graph) {
+    if (!graph || graph->numVertices <= 0 || graph_freeze(graph) != 0) {
+        return NULL;
+    }
+
+    int n = graph->numVertices;
+    ContractionHierarchy *ch = calloc(1, sizeof(ContractionHierarchy));
+    ChBuilder b = {0};
+    PQueue *order_queue = pqueue_create(PQ_BINARY_HEAP, n, 0);
+    if (!ch || !order_queue) {
+        free(ch);
+        pqueue_destroy(order_queue);
+        return NULL;
+    }
+
+    ch->numVertices = n;
+    ch->rankOf = malloc(n * sizeof(int));
+    ch->vertexAt = malloc(n * sizeof(int));
+
+    b.n = n;
+    b.out = calloc(n, sizeof(ChArcList));
+    b.in = calloc(n, sizeof(ChArcList));
+    b.deletedNeighbours = calloc(n, sizeof(int));
+    b.stamp = calloc(n, sizeof(unsigned int));
+    b.dist = malloc(n * sizeof(long long));
+    b.witnessQueue = pqueue_create(PQ_BINARY_HEAP, n, 0);
+    b.rankOf = ch->rankOf;
+
+    int ok = ch->rankOf && ch->vertexAt && b.out && b.in && b.deletedNeighbours &&
+             b.stamp && b.dist && b.witnessQueue;
+
+    /* Parallel edges collapse to the lightest; self-loops never lie on a shortest path */
+    for (int u = 0; ok && u < n; u++) {
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); ok && graph_edges_next(&it); ) {
+            if (it.weight < 0) {
+                ok = 0;
+            } else if (it.to != u) {
+                ok = builder_add_arc(&b, u, it.to, it.weight, -1) >= 0;
+            }
+        }
+    }
+
+    for (int v = 0; ok && v < n; v++) {
+        long long priority = contraction_priority(&b, v);
+        ok = priority != LLONG_MAX && pqueue_push(order_queue, v, priority) == 0;
+    }
+
+    /* Lazy updates: a vertex whose priority grew since it was queued goes back in */
+    int rank = 0;
+    int v;
+    long long key;
+    while (ok && pqueue_pop(order_queue, &v, &key) == 0) {
+        long long priority = contraction_priority(&b, v);
+        if (priority == LLONG_MAX) {
+            ok = 0;
+        } else if (priority > key) {
+            ok = pqueue_push(order_queue, v, priority) == 0;
+        } else if (contract_vertex(&b, v) != 0) {
+            ok = 0;
+        } else {
+            ch->rankOf[v] = rank;
+            ch->vertexAt[rank] = v;
+            rank++;
+        }
+    }
+
+    ok = ok && rank == n &&
+         ch_store_arcs(&b, b.out, &ch->upOffsets, &ch->upTargets, &ch->upWeights, &ch->upMiddle, ch->vertexAt) == 0 &&
+         ch_store_arcs(&b, b.in, &ch->downOffsets, &ch->downSources, &ch->downWeights, &ch->downMiddle, ch->vertexAt) == 0;
+    ch->numShortcuts = b.numShortcuts;
+    ch->graphVersion = graph_version(graph);
+
+    builder_free(&b);
+    pqueue_destroy(order_queue);
+    if (!ok) {
+        ch_free(ch);
+        return NULL;
+    }
+    return ch;
+}
+
+void ch_free(ContractionHierarchy *ch) {
+    if (!ch) {
+        return;
+    }
+    free(ch->rankOf);
+    free(ch->vertexAt);
+    free(ch->upOffsets);
+    free(ch->upTargets);
+    free(ch->upWeights);
+    free(ch->upMiddle);
+    free(ch->downOffsets);
+    free(ch->downSources);
+    free(ch->downWeights);
+    free(ch->downMiddle);
+    free(ch);
+}
+
+/* ============================================================================
+   Query – upward bidirectional search with stall-on-demand
+   ========================================================================== */
+
+/* A vertex reached more cheaply through a higher-ranked neighbour cannot lie on
+   a shortest up-down path, so its arcs need not be relaxed */
+static int ch_stalled(const ContractionHierarchy *ch, const SearchContext *ctx, int backward, int u) {
+    unsigned int gen = ctx->generation;
+    const unsigned int *stamp = backward ? ctx->stampBack : ctx->stamp;
+    const long long *dist = backward ? ctx->distBack : (const long long *)ctx->dist;
+    const int *offsets = backward ? ch->upOffsets : ch->downOffsets;
+    const int *ends = backward ? ch->upTargets : ch->downSources;
+    const long long *weights = backward ? ch->upWeights : ch->downWeights;
+
+    for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+        int w = ends[e];
+        if (weights[e] != CH_NO_ARC && stamp[w] == gen && dist[w] + weights[e] < dist[u]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Middle rank of the arc a → b, -1 for an original edge, -2 if there is no such arc */
+static int ch_arc_middle(const ContractionHierarchy *ch, int a, int b) {
+    if (a < b) {
+        for (int e = ch->upOffsets[a]; e < ch->upOffsets[a + 1]; e++) {
+            if (ch->upTargets[e] == b) return ch->upMiddle[e];
+        }
+    } else {
+        for (int e = ch->downOffsets[b]; e < ch->downOffsets[b + 1]; e++) {
+            if (ch->downSources[e] == a) return ch->downMiddle[e];
+        }
+    }
+    return -2;
+}
+
+/*
+ * Appends the original vertices after a on the arc a → b (ranks) to out_path.
+ * stack holds pending arc heads; middles have lower rank than both endpoints,
+ * so it never holds more than numVertices entries.
+ */
+static int ch_unpack_arc(const ContractionHierarchy *ch, const Graph *graph, int a, int b, int *stack,
+                         int *out_path, int len, int max_len) {
+    int top = 0;
+    stack[top++] = b;
+    while (top > 0) {
+        int x = stack[top - 1];
+        int middle = ch_arc_middle(ch, a, x);
+        if (middle == -2) {
+            return -1;
+        }
+        if (middle >= 0) {
+            stack[top++] = middle;
+            continue;
+        }
+        if (len >= max_len) {
+            return -1;
+        }
+        out_path[len++] = graph_to_external(graph, ch->vertexAt[x]);
+        a = x;
+        top--;
+    }
+    return len;
+}
+
+int ch_shortest_path(const ContractionHierarchy *ch, Graph *graph, int start, int goal,
+                     int *out_path, int max_path_len, long long *out_distance) {
+    if (!ch || !graph || !out_path || !out_distance || ch->numVertices != graph->numVertices ||
+        start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices || max_path_len < 1) {
+        if (out_distance) *out_distance = -1;
+        return 0;
+    }
+    if (graph_freeze(graph) != 0 || graph_version(graph) != ch->graphVersion) {
+        *out_distance = -1;
+        return 0;
+    }
+
+    SearchContext *ctx = search_context_current(ch->numVertices);
+    if (!ctx || search_context_enable_backward(ctx) != 0 ||
+        !search_context_queue(ctx, PQ_BINARY_HEAP, 0)) {
+        *out_distance = -1;
+        return 0;
+    }
+    unsigned int gen = search_context_begin(ctx);
+
+    int s = ch->rankOf[graph_to_internal(graph, start)];
+    int t = ch->rankOf[graph_to_internal(graph, goal)];
+    long long *dist_fwd = ctx->dist;
+    long long *dist_bwd = ctx->distBack;
+
+    ctx->stamp[s] = gen;
+    dist_fwd[s] = 0;
+    ctx->parent[s] = -1;
+    ctx->stampBack[t] = gen;
+    dist_bwd[t] = 0;
+    ctx->parentBack[t] = -1;
+
+    long long mu = s == t ? 0 : LLONG_MAX;
+    int meet = s == t ? s : -1;
+    int failed = pqueue_push(ctx->queue, s, 0) != 0 || pqueue_push(ctx->queueBack, t, 0) != 0;
+
+    /* Alternate directions; a direction is done once its minimum reaches mu */
+    int active[2] = { 1, 1 };
+    int backward = 0;
+    while (!failed && (active[0] || active[1])) {
+        if (!active[backward]) backward = !backward;
+
+        int u;
+        long long du;
+        PQueue *queue = backward ? ctx->queueBack : ctx->queue;
+        int popped = pqueue_pop(queue, &u, &du);
+        if (popped == PQUEUE_NO_MEMORY) {
+            failed = 1;
+            break;
+        }
+        if (popped != 0 || du >= mu) {
+            active[backward] = 0;
+            backward = !backward;
+            continue;
+        }
+
+        if (!ch_stalled(ch, ctx, backward, u)) {
+            ctx->settled++;
+
+            unsigned int *stamp = backward ? ctx->stampBack : ctx->stamp;
+            long long *dist = backward ? dist_bwd : dist_fwd;
+            int *parent = backward ? ctx->parentBack : ctx->parent;
+            const unsigned int *other_stamp = backward ? ctx->stamp : ctx->stampBack;
+            const long long *other_dist = backward ? dist_fwd : dist_bwd;
+            const int *offsets = backward ? ch->downOffsets : ch->upOffsets;
+            const int *ends = backward ? ch->downSources : ch->upTargets;
+            const long long *weights = backward ? ch->downWeights : ch->upWeights;
+
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                int x = ends[e];
+                if (weights[e] == CH_NO_ARC) continue;
+                long long nd = du + weights[e];
+                if (stamp[x] == gen && nd >= dist[x]) continue;
+
+                stamp[x] = gen;
+                dist[x] = nd;
+                parent[x] = u;
+                if (other_stamp[x] == gen && nd + other_dist[x] < mu) {
+                    mu = nd + other_dist[x];
+                    meet = x;
+                }
+                if (pqueue_push(queue, x, nd) != 0) {
+                    failed = 1;
+                    break;
+                }
+            }
+        }
+        backward = !backward;
+    }
+
+    pqueue_clear(ctx->queue);
+    pqueue_clear(ctx->queueBack);
+
+    if (failed || meet < 0) {
+        *out_distance = -1;
+        return 0;
+    }
+
+    /* Up-down path s → meet → t in ranks: forward parents reversed, then backward successors */
+    int up_len = 0;
+    for (int r = meet; r != -1; r = ctx->parent[r]) up_len++;
+    int hops = up_len;
+    for (int r = ctx->parentBack[meet]; r != -1; r = ctx->parentBack[r]) hops++;
+
+    int *ranks = malloc(hops * sizeof(int));
+    if (!ranks) {
+        *out_distance = -1;
+        return 0;
+    }
+    int i = up_len;
+    for (int r = meet; r != -1; r = ctx->parent[r]) ranks[--i] = r;
+    i = up_len;
+    for (int r = ctx->parentBack[meet]; r != -1; r = ctx->parentBack[r]) ranks[i++] = r;
+
+    int len = 0;
+    out_path[len++] = start;
+    for (i = 0; i + 1 < hops && len > 0; i++) {
+        len = ch_unpack_arc(ch, graph, ranks[i], ranks[i + 1], ctx->scratch, out_path, len, max_path_len);
+        if (len < 0) len = 0;
+    }
+    free(ranks);
+
+    *out_distance = len > 0 ? mu : -1;
+    return len;
+}
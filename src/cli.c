@@ -6,6 +6,13 @@
 #include "../include/graph.h"
 #include "../include/io.h"
 #include "../include/algorithms.h"
+#include "../include/landmarks.h"
+#include "../include/ch.h"
+#include "../include/cch.h"
+#include "../include/hub_labels.h"
+#include "../include/arc_flags.h"
+#include "../include/crp.h"
+#include "../include/tnr.h"
 
 Algorithm cli_select_algorithm(void) {
     int choice = -1;
@@ -19,9 +26,21 @@ Algorithm cli_select_algorithm(void) {
         printf("     4.1) No heuristic (same as Dijkstra)\n");
         printf("     4.2) Manhattan heuristic\n");
         printf("     4.3) Euclidean heuristic\n");
+        printf("     4.4) Landmark (ALT) heuristic\n");
         printf("  5) Shortest time with negative weights (Bellman-Ford)\n");
+        printf("  6) Shortest travel time, searching from both ends (bidirectional Dijkstra)\n");
+        printf("  7) Shortest travel time with heuristic, from both ends (bidirectional A*)\n");
+        printf("     7.1) Manhattan heuristic\n");
+        printf("     7.2) Euclidean heuristic\n");
+        printf("     7.3) Landmark (ALT) heuristic\n");
+        printf("  8) Shortest travel time, precomputed hierarchy (Contraction Hierarchies)\n");
+        printf("  9) Shortest travel time, customizable hierarchy (CCH)\n");
+        printf(" 10) Shortest travel time, precomputed labels (hub labeling)\n");
+        printf(" 11) Shortest travel time, region-pruned Dijkstra (arc flags)\n");
+        printf(" 12) Shortest travel time, multi-level overlay (CRP)\n");
+        printf(" 13) Shortest travel time, transit-node routing\n");
         printf("  0) Exit\n");
-        printf("Enter choice (0–5 or 4.1–4.3): ");
+        printf("Enter choice (0–13, 4.1–4.4 or 7.1–7.3): ");
 
         char input[16];
         if (!fgets(input, sizeof(input), stdin)) {
@@ -35,15 +54,33 @@ Algorithm cli_select_algorithm(void) {
             choice = ALGO_ASTAR_MANHATTAN;
         } else if (strncmp(input, "4.3", 3) == 0) {
             choice = ALGO_ASTAR_EUCLIDEAN;
+        } else if (strncmp(input, "4.4", 3) == 0) {
+            choice = ALGO_ASTAR_LANDMARKS;
+        } else if (strncmp(input, "7.1", 3) == 0) {
+            choice = ALGO_BIASTAR_MANHATTAN;
+        } else if (strncmp(input, "7.2", 3) == 0) {
+            choice = ALGO_BIASTAR_EUCLIDEAN;
+        } else if (strncmp(input, "7.3", 3) == 0) {
+            choice = ALGO_BIASTAR_LANDMARKS;
         } else if (sscanf(input, "%d", &choice) == 1) {
-            // normal 0-5
+            /* Menu numbers 0-3 match the enum; 4-13 do not */
+            if (choice == 4) choice = ALGO_ASTAR_NONE;
+            else if (choice == 5) choice = ALGO_BELLMAN_FORD;
+            else if (choice == 6) choice = ALGO_BIDIJKSTRA;
+            else if (choice == 7) choice = ALGO_BIASTAR_MANHATTAN;
+            else if (choice == 8) choice = ALGO_CH;
+            else if (choice == 9) choice = ALGO_CCH;
+            else if (choice == 10) choice = ALGO_HUB_LABELS;
+            else if (choice == 11) choice = ALGO_ARC_FLAGS;
+            else if (choice == 12) choice = ALGO_CRP;
+            else if (choice == 13) choice = ALGO_TNR;
+            else if (choice < 0 || choice > 3) choice = -1;
         } else {
             printf("Invalid input.\n");
             continue;
         }
 
-        if (choice >= 0 && choice <= 5) break;
-        if (choice >= ALGO_ASTAR_NONE && choice <= ALGO_ASTAR_EUCLIDEAN) break;
+        if (choice >= 0) break;
 
         printf("Please enter a valid choice.\n");
     }
@@ -146,6 +183,14 @@ void cli_main_loop(Graph *g) {
         return;
     }
 
+    /* Built on the first query that needs them and kept for the rest of the session */
+    ContractionHierarchy *ch = NULL;
+    CustomizableCH *cch = NULL;
+    HubLabels *hl = NULL;
+    ArcFlags *af = NULL;
+    CrpOverlay *crp = NULL;
+    TransitNodeRouting *tnr = NULL;
+
     while (1) {
         Algorithm algo = cli_select_algorithm();
 
@@ -154,6 +199,73 @@ void cli_main_loop(Graph *g) {
             break;
         }
 
+        if ((algo == ALGO_ASTAR_LANDMARKS || algo == ALGO_BIASTAR_LANDMARKS) && !landmarks_active()) {
+            io_print_error("No landmarks loaded (start with --landmarks <k> or --load-landmarks <file>)");
+            continue;
+        }
+
+        if ((algo == ALGO_CH || algo == ALGO_HUB_LABELS || algo == ALGO_TNR) && !ch) {
+            printf("Contracting graph (one-time preprocessing)...\n");
+            ch = ch_build(g);
+            if (!ch) {
+                io_print_error("Contraction failed (weights must be non-negative)");
+                continue;
+            }
+            printf("Hierarchy ready: %d shortcuts added\n", ch->numShortcuts);
+        }
+
+        if (algo == ALGO_CCH && !cch) {
+            printf("Ordering and customizing graph (one-time preprocessing)...\n");
+            cch = cch_build(g);
+            if (!cch) {
+                io_print_error("Customization failed (weights must be non-negative)");
+                continue;
+            }
+            printf("Hierarchy ready: %d arcs, %d customization rounds\n", cch->numArcs, cch->numLevels);
+        }
+
+        if (algo == ALGO_HUB_LABELS && !hl) {
+            printf("Labeling graph in hierarchy order (one-time preprocessing)...\n");
+            hl = hub_labels_build(g, ch);
+            if (!hl) {
+                io_print_error("Labeling failed (weights must be non-negative)");
+                continue;
+            }
+            printf("Labels ready: %.1f entries per vertex\n", (double)hl->numEntries / g->numVertices);
+        }
+
+        if (algo == ALGO_ARC_FLAGS && !af) {
+            printf("Partitioning graph and computing arc flags (one-time preprocessing)...\n");
+            af = arc_flags_build(g, ARC_FLAGS_DEFAULT_REGIONS, 0);
+            if (!af) {
+                io_print_error("Arc flag preprocessing failed (weights must be non-negative)");
+                continue;
+            }
+            printf("Arc flags ready: %d regions\n", af->numRegions);
+        }
+
+        if (algo == ALGO_CRP && !crp) {
+            printf("Partitioning graph and customizing cells (one-time preprocessing)...\n");
+            crp = crp_build(g, CRP_DEFAULT_LEVELS, CRP_DEFAULT_CELL_SIZE);
+            if (!crp) {
+                io_print_error("Overlay preprocessing failed (weights must be non-negative)");
+                continue;
+            }
+            printf("Overlay ready: %d levels, %d cells at the top\n", crp->numLevels,
+                   crp->levels[crp->numLevels - 1].numCells);
+        }
+
+        if (algo == ALGO_TNR && !tnr) {
+            printf("Selecting transit nodes and access nodes (one-time preprocessing)...\n");
+            tnr = tnr_build(g, ch, 0);
+            if (!tnr) {
+                io_print_error("Transit-node preprocessing failed (weights must be non-negative)");
+                continue;
+            }
+            printf("Transit nodes ready: %d transit nodes, %.1f access nodes per vertex\n", tnr->numTransit,
+                   (double)(tnr->fwdOffsets[g->numVertices] + tnr->bwdOffsets[g->numVertices]) / (2.0 * g->numVertices));
+        }
+
         int start = cli_prompt_vertex(g, "Start vertex");
         if (start < 0) continue;
 
@@ -198,6 +310,50 @@ void cli_main_loop(Graph *g) {
                 res = pathresult_from_bellman_ford(g, start, goal);
                 break;
 
+            case ALGO_BIDIJKSTRA:
+                res = pathresult_from_bidirectional_dijkstra(g, start, goal);
+                break;
+
+            case ALGO_BIASTAR_MANHATTAN:
+                res = pathresult_from_bidirectional_astar(g, start, goal, simple_manhattan_heuristic);
+                break;
+
+            case ALGO_BIASTAR_EUCLIDEAN:
+                res = pathresult_from_bidirectional_astar(g, start, goal, simple_euclidean_heuristic);
+                break;
+
+            case ALGO_ASTAR_LANDMARKS:
+                res = pathresult_from_astar(g, start, goal, landmark_heuristic);
+                break;
+
+            case ALGO_BIASTAR_LANDMARKS:
+                res = pathresult_from_bidirectional_astar(g, start, goal, landmark_heuristic);
+                break;
+
+            case ALGO_CH:
+                res = pathresult_from_ch(g, ch, start, goal);
+                break;
+
+            case ALGO_CCH:
+                res = pathresult_from_ch(g, cch->hierarchy, start, goal);
+                break;
+
+            case ALGO_HUB_LABELS:
+                res = pathresult_from_hub_labels(g, hl, start, goal);
+                break;
+
+            case ALGO_ARC_FLAGS:
+                res = pathresult_from_arc_flags(g, af, start, goal);
+                break;
+
+            case ALGO_CRP:
+                res = pathresult_from_crp(g, crp, start, goal);
+                break;
+
+            case ALGO_TNR:
+                res = pathresult_from_tnr(g, tnr, ch, start, goal);
+                break;
+
             default:
                 io_print_error("Algorithm not implemented in CLI");
                 continue;
@@ -206,4 +362,11 @@ void cli_main_loop(Graph *g) {
         print_path_result(g, &res, algo);
         pathresult_free(&res);
     }
+
+    tnr_free(tnr);
+    crp_free(crp);
+    arc_flags_free(af);
+    hub_labels_free(hl);
+    ch_free(ch);
+    cch_free(cch);
 }
\ No newline at end of file
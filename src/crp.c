@@ -0,0 +1,546 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "../include/crp.h"
+#include "../include/parallel.h"
+#include "../include/partition.h"
+#include "../include/pqueue.h"
+#include "../include/search_context.h"
+
+/* Cells per level below which customization stays on the calling thread */
+#define CRP_PARALLEL_MIN 8
+
+/* ============================================================================
+   Nested partition and boundary vertices
+   ========================================================================== */
+
+/* Fills boundaryOffsets / boundary / boundaryIndex from the per-vertex marks and sizes the matrices */
+static int crp_collect_boundary(CrpLevel *lvl, const unsigned char *is_boundary, int n) {
+    int cells = lvl->numCells;
+    lvl->boundaryOffsets = calloc(cells + 1, sizeof(int));
+    lvl->boundaryIndex = malloc(n * sizeof(int));
+    lvl->matrixOffsets = malloc((cells + 1) * sizeof(long long));
+    if (!lvl->boundaryOffsets || !lvl->boundaryIndex || !lvl->matrixOffsets) {
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) {
+        if (is_boundary[v]) lvl->boundaryOffsets[lvl->cellOf[v] + 1]++;
+    }
+    for (int c = 0; c < cells; c++) {
+        lvl->boundaryOffsets[c + 1] += lvl->boundaryOffsets[c];
+    }
+
+    lvl->boundary = malloc((lvl->boundaryOffsets[cells] > 0 ? lvl->boundaryOffsets[cells] : 1) * sizeof(int));
+    int *fill = malloc(cells * sizeof(int));
+    if (!lvl->boundary || !fill) {
+        free(fill);
+        return -1;
+    }
+    memcpy(fill, lvl->boundaryOffsets, cells * sizeof(int));
+    for (int v = 0; v < n; v++) {
+        int c = lvl->cellOf[v];
+        lvl->boundaryIndex[v] = is_boundary[v] ? fill[c] - lvl->boundaryOffsets[c] : -1;
+        if (is_boundary[v]) lvl->boundary[fill[c]++] = v;
+    }
+    free(fill);
+
+    lvl->matrixOffsets[0] = 0;
+    for (int c = 0; c < cells; c++) {
+        long long b = lvl->boundaryOffsets[c + 1] - lvl->boundaryOffsets[c];
+        lvl->matrixOffsets[c + 1] = lvl->matrixOffsets[c] + b * b;
+    }
+    lvl->matrices = malloc((lvl->matrixOffsets[cells] > 0 ? lvl->matrixOffsets[cells] : 1) * sizeof(long long));
+    return lvl->matrices ? 0 : -1;
+}
+
+CrpOverlay *crp_build(Graph *graph, int num_levels, int cell_size) {
+    if (!graph || num_levels < 1 || cell_size < 1 || graph_freeze(graph) != 0) {
+        return NULL;
+    }
+
+    int n = graph->numVertices;
+    CrpOverlay *crp = calloc(1, sizeof(CrpOverlay));
+    int *region = calloc(n, sizeof(int));
+    unsigned char *marks = malloc((size_t)num_levels * n);
+    if (crp) {
+        crp->numVertices = n;
+        crp->orderVersion = graph_order_version(graph);
+        crp->numLevels = num_levels;
+        crp->levels = calloc(num_levels, sizeof(CrpLevel));
+    }
+    int ok = crp && crp->levels && region && marks;
+
+    /* Top level first, so every split only divides a cell of the level above */
+    int count = 1;
+    for (int l = num_levels; ok && l >= 1; l--) {
+        long long max_size = cell_size;
+        for (int i = 1; i < l && max_size < n; i++) {
+            max_size *= CRP_LEVEL_FANOUT;
+        }
+        count = graph_partition_bisect(graph, region, count, INT_MAX, max_size < n ? (int)max_size : n);
+
+        CrpLevel *lvl = &crp->levels[l - 1];
+        lvl->numCells = count;
+        lvl->cellOf = malloc(n * sizeof(int));
+        ok = count > 0 && lvl->cellOf;
+        if (ok) memcpy(lvl->cellOf, region, n * sizeof(int));
+    }
+
+    /* Both ends of an edge between two cells are boundary vertices of their level */
+    if (ok) memset(marks, 0, (size_t)num_levels * n);
+    for (int u = 0; ok && u < n; u++) {
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            for (int l = 0; l < num_levels; l++) {
+                const int *cell = crp->levels[l].cellOf;
+                if (cell[u] != cell[it.to]) {
+                    marks[(size_t)l * n + u] = 1;
+                    marks[(size_t)l * n + it.to] = 1;
+                }
+            }
+        }
+    }
+    for (int l = 0; ok && l < num_levels; l++) {
+        ok = crp_collect_boundary(&crp->levels[l], marks + (size_t)l * n, n) == 0;
+    }
+
+    free(region);
+    free(marks);
+    if (!ok || crp_customize(crp, graph, 0) != 0) {
+        crp_free(crp);
+        return NULL;
+    }
+    return crp;
+}
+
+void crp_free(CrpOverlay *crp) {
+    if (!crp) {
+        return;
+    }
+    for (int l = 0; crp->levels && l < crp->numLevels; l++) {
+        CrpLevel *lvl = &crp->levels[l];
+        free(lvl->cellOf);
+        free(lvl->boundaryOffsets);
+        free(lvl->boundary);
+        free(lvl->boundaryIndex);
+        free(lvl->matrixOffsets);
+        free(lvl->matrices);
+    }
+    free(crp->levels);
+    free(crp);
+}
+
+/* ============================================================================
+   Customization – one Dijkstra per boundary vertex, cell by cell
+   ========================================================================== */
+
+typedef struct {
+    const CrpOverlay *crp;
+    const Graph *graph;
+    int level;              /* index into crp->levels */
+    int *failed;            /* per team member */
+} CustomizeJob;
+
+/*
+ * Dijkstra inside cell c of level index l from boundary vertex root. Level 0
+ * cells use their own edges; higher cells the cliques of the level below plus
+ * the edges between its cells.
+ */
+static int crp_cell_search(const CustomizeJob *job, int c, int root, PQueue *pq, long long *dist, int *touched) {
+    const CrpLevel *lvl = &job->crp->levels[job->level];
+    const CrpLevel *sub = job->level > 0 ? &job->crp->levels[job->level - 1] : NULL;
+    int num_touched = 0;
+
+    dist[root] = 0;
+    touched[num_touched++] = root;
+    if (pqueue_push(pq, root, 0) != 0) {
+        dist[root] = CRP_NO_PATH;
+        return -1;
+    }
+
+    int u;
+    long long du;
+    while (pqueue_pop(pq, &u, &du) == 0) {
+        int sc = sub ? sub->cellOf[u] : -1;
+
+        if (sub) {
+            int b = sub->boundaryOffsets[sc + 1] - sub->boundaryOffsets[sc];
+            const long long *row = sub->matrices + sub->matrixOffsets[sc] + (long long)sub->boundaryIndex[u] * b;
+            const int *ends = sub->boundary + sub->boundaryOffsets[sc];
+            for (int j = 0; j < b; j++) {
+                int x = ends[j];
+                if (row[j] == CRP_NO_PATH || du + row[j] >= dist[x]) continue;
+                if (dist[x] == CRP_NO_PATH) touched[num_touched++] = x;
+                dist[x] = du + row[j];
+                if (pqueue_push(pq, x, dist[x]) != 0) return -1;
+            }
+        }
+
+        GraphEdgeIter it;
+        for (graph_edges_begin(job->graph, u, &it); graph_edges_next(&it); ) {
+            int x = it.to;
+            if (lvl->cellOf[x] != c || (sub && sub->cellOf[x] == sc) || du + it.weight >= dist[x]) continue;
+            if (dist[x] == CRP_NO_PATH) touched[num_touched++] = x;
+            dist[x] = du + it.weight;
+            if (pqueue_push(pq, x, dist[x]) != 0) return -1;
+        }
+    }
+
+    /* The caller reads the row, then resets what this search touched */
+    return num_touched;
+}
+
+/* Fills the cliques of one team member's slice of cells */
+static void customize_member(void *ctx, ParallelTeam *team, int member, int size) {
+    const CustomizeJob *job = ctx;
+    const CrpLevel *lvl = &job->crp->levels[job->level];
+    int n = job->graph->numVertices;
+    int first, last, failed = 0;
+    (void)team;
+    parallel_slice(lvl->numCells, member, size, &first, &last);
+    long long *dist = malloc(n * sizeof(long long));
+    int *touched = malloc(n * sizeof(int));
+    PQueue *pq = pqueue_create(PQ_BINARY_HEAP, n, 0);
+
+    if (!dist || !touched || !pq) {
+        failed = 1;
+    } else {
+        for (int v = 0; v < n; v++) {
+            dist[v] = CRP_NO_PATH;
+        }
+    }
+
+    for (int c = first; !failed && c < last; c++) {
+        const int *ends = lvl->boundary + lvl->boundaryOffsets[c];
+        int b = lvl->boundaryOffsets[c + 1] - lvl->boundaryOffsets[c];
+        long long *matrix = lvl->matrices + lvl->matrixOffsets[c];
+
+        for (int i = 0; i < b && !failed; i++) {
+            int num_touched = crp_cell_search(job, c, ends[i], pq, dist, touched);
+            if (num_touched < 0) {
+                pqueue_clear(pq);
+                failed = 1;
+                break;
+            }
+            for (int j = 0; j < b; j++) {
+                matrix[(long long)i * b + j] = dist[ends[j]];
+            }
+            for (int k = 0; k < num_touched; k++) {
+                dist[touched[k]] = CRP_NO_PATH;
+            }
+        }
+    }
+
+    free(dist);
+    free(touched);
+    pqueue_destroy(pq);
+    job->failed[member] = failed;
+}
+
+/* Splits the cells of one level across a team; small levels run on the caller */
+static int crp_customize_level(const CrpOverlay *crp, const Graph *graph, int level, int num_threads) {
+    int cells = crp->levels[level].numCells;
+    int members = cells < CRP_PARALLEL_MIN ? 1 : parallel_threads(num_threads, cells);
+    CustomizeJob job = { crp, graph, level, calloc(members, sizeof(int)) };
+    if (!job.failed) {
+        return -1;
+    }
+
+    parallel_run(members, customize_member, &job);
+
+    int failed = 0;
+    for (int t = 0; t < members; t++) {
+        failed |= job.failed[t];
+    }
+    free(job.failed);
+    return failed ? -1 : 0;
+}
+
+int crp_customize(CrpOverlay *crp, Graph *graph, int num_threads) {
+    if (!crp || !graph || graph->numVertices != crp->numVertices || graph_freeze(graph) != 0) {
+        return -1;
+    }
+    if (graph_order_version(graph) != crp->orderVersion) {
+        return -1;
+    }
+    if (num_threads <= 0) {
+        num_threads = CRP_DEFAULT_THREADS;
+    }
+
+    /* Queries stay refused until every level is filled again */
+    crp->customizedVersion = 0;
+
+    /* The partition fixed the boundary; an edge between cells elsewhere needs a rebuild */
+    for (int u = 0; u < graph->numVertices; u++) {
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            if (it.weight < 0) return -1;
+            for (int l = 0; l < crp->numLevels; l++) {
+                const CrpLevel *lvl = &crp->levels[l];
+                if (lvl->cellOf[u] != lvl->cellOf[it.to] &&
+                    (lvl->boundaryIndex[u] < 0 || lvl->boundaryIndex[it.to] < 0)) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    for (int l = 0; l < crp->numLevels; l++) {
+        if (crp_customize_level(crp, graph, l, num_threads) != 0) {
+            return -1;
+        }
+    }
+    crp->customizedVersion = graph_version(graph);
+    return 0;
+}
+
+/* ============================================================================
+   Query – bidirectional search over the overlay graph
+   ========================================================================== */
+
+/* Highest level whose cell of v holds neither endpoint, 0 if v shares a level-1 cell with one */
+static int crp_query_level(const CrpOverlay *crp, int v, int s, int t) {
+    for (int l = crp->numLevels; l >= 1; l--) {
+        const int *cell = crp->levels[l - 1].cellOf;
+        if (cell[v] != cell[s] && cell[v] != cell[t]) {
+            return l;
+        }
+    }
+    return 0;
+}
+
+/* Relaxes u → x (x → u backwards) at distance d and updates the meeting point */
+static int crp_relax(SearchContext *ctx, int backward, int u, int x, long long d, long long *mu, int *meet) {
+    unsigned int gen = ctx->generation;
+    unsigned int *stamp = backward ? ctx->stampBack : ctx->stamp;
+    long long *dist = backward ? ctx->distBack : (long long *)ctx->dist;
+    int *parent = backward ? ctx->parentBack : ctx->parent;
+    const unsigned int *other_stamp = backward ? ctx->stamp : ctx->stampBack;
+    const long long *other_dist = backward ? (const long long *)ctx->dist : ctx->distBack;
+
+    if ((stamp[x] == gen && d >= dist[x]) || d >= *mu) {
+        return 0;
+    }
+    stamp[x] = gen;
+    dist[x] = d;
+    parent[x] = u;
+    if (other_stamp[x] == gen && d + other_dist[x] < *mu) {
+        *mu = d + other_dist[x];
+        *meet = x;
+    }
+    return pqueue_push(backward ? ctx->queueBack : ctx->queue, x, d);
+}
+
+/* Scans u: the graph's edges at level 0, else its cell's clique and the edges leaving the cell */
+static int crp_scan(const CrpOverlay *crp, const Graph *graph, const GraphCSR *rev, SearchContext *ctx,
+                    int backward, int u, long long du, int level, long long *mu, int *meet) {
+    const CrpLevel *lvl = level > 0 ? &crp->levels[level - 1] : NULL;
+    int c = lvl ? lvl->cellOf[u] : -1;
+
+    if (lvl) {
+        int b = lvl->boundaryOffsets[c + 1] - lvl->boundaryOffsets[c];
+        int i = lvl->boundaryIndex[u];
+        const long long *matrix = lvl->matrices + lvl->matrixOffsets[c];
+        const int *ends = lvl->boundary + lvl->boundaryOffsets[c];
+        for (int j = 0; j < b; j++) {
+            long long w = backward ? matrix[(long long)j * b + i] : matrix[(long long)i * b + j];
+            if (j != i && w != CRP_NO_PATH && crp_relax(ctx, backward, u, ends[j], du + w, mu, meet) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    GraphEdgeIter it;
+    if (backward) {
+        graph_reverse_edges_begin(graph, rev, u, &it);
+    } else {
+        graph_edges_begin(graph, u, &it);
+    }
+    while (graph_edges_next(&it)) {
+        if (lvl && lvl->cellOf[it.to] == c) continue;
+        if (crp_relax(ctx, backward, u, it.to, du + it.weight, mu, meet) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Appends the vertices after a on a shortest a → b path inside their cell of
+ * the given level. The search runs over the same arcs customization used for
+ * that cell; clique arcs of the level below are unpacked recursively.
+ */
+static int crp_unpack(const CrpOverlay *crp, const Graph *graph, SearchContext *ctx, int level, int a, int b,
+                      int *out_path, int len, int max_len) {
+    const CrpLevel *lvl = &crp->levels[level - 1];
+    const CrpLevel *sub = level > 1 ? &crp->levels[level - 2] : NULL;
+    int c = lvl->cellOf[a];
+    unsigned int gen = search_context_begin(ctx);
+    long long *dist = ctx->dist;
+
+    ctx->stamp[a] = gen;
+    dist[a] = 0;
+    ctx->parent[a] = -1;
+    int failed = pqueue_push(ctx->queue, a, 0) != 0;
+
+    int u, popped = 0;
+    long long du;
+    while (!failed && (popped = pqueue_pop(ctx->queue, &u, &du)) == 0 && u != b) {
+        int sc = sub ? sub->cellOf[u] : -1;
+        if (sub) {
+            int nb = sub->boundaryOffsets[sc + 1] - sub->boundaryOffsets[sc];
+            const long long *row = sub->matrices + sub->matrixOffsets[sc] + (long long)sub->boundaryIndex[u] * nb;
+            const int *ends = sub->boundary + sub->boundaryOffsets[sc];
+            for (int j = 0; j < nb && !failed; j++) {
+                int x = ends[j];
+                if (row[j] == CRP_NO_PATH || (ctx->stamp[x] == gen && du + row[j] >= dist[x])) continue;
+                ctx->stamp[x] = gen;
+                dist[x] = du + row[j];
+                ctx->parent[x] = u;
+                failed = pqueue_push(ctx->queue, x, dist[x]) != 0;
+            }
+        }
+
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); !failed && graph_edges_next(&it); ) {
+            int x = it.to;
+            if (lvl->cellOf[x] != c || (sub && sub->cellOf[x] == sc) ||
+                (ctx->stamp[x] == gen && du + it.weight >= dist[x])) continue;
+            ctx->stamp[x] = gen;
+            dist[x] = du + it.weight;
+            ctx->parent[x] = u;
+            failed = pqueue_push(ctx->queue, x, dist[x]) != 0;
+        }
+    }
+    failed = failed || popped == PQUEUE_NO_MEMORY;
+    pqueue_clear(ctx->queue);
+    if (failed || ctx->stamp[b] != gen) {
+        return -1;
+    }
+
+    /* Copy the steps out before the recursive searches reuse the context */
+    int hops = 0;
+    for (int x = b; x != a; x = ctx->parent[x]) hops++;
+    int *steps = malloc((hops + 1) * sizeof(int));
+    if (!steps) {
+        return -1;
+    }
+    int x = b;
+    for (int i = hops; i >= 0; i--) {
+        steps[i] = x;
+        x = ctx->parent[x];
+    }
+
+    for (int i = 0; i < hops && len >= 0; i++) {
+        if (sub && sub->cellOf[steps[i]] == sub->cellOf[steps[i + 1]]) {
+            len = crp_unpack(crp, graph, ctx, level - 1, steps[i], steps[i + 1], out_path, len, max_len);
+        } else if (len < max_len) {
+            out_path[len++] = graph_to_external(graph, steps[i + 1]);
+        } else {
+            len = -1;
+        }
+    }
+    free(steps);
+    return len;
+}
+
+int crp_shortest_path(const CrpOverlay *crp, Graph *graph, int start, int goal,
+                      int *out_path, int max_path_len, long long *out_distance) {
+    if (!crp || !graph || !out_path || !out_distance || crp->numVertices != graph->numVertices ||
+        start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices || max_path_len < 1) {
+        if (out_distance) *out_distance = -1;
+        return 0;
+    }
+    *out_distance = -1;
+
+    if (graph_freeze(graph) != 0 || graph_version(graph) != crp->customizedVersion) {
+        return 0;
+    }
+    const GraphCSR *rev = graph_reverse(graph);
+    SearchContext *ctx = search_context_current(graph->numVertices);
+    if (!rev || !ctx || search_context_enable_backward(ctx) != 0 ||
+        !search_context_queue(ctx, PQ_RADIX_HEAP, 0)) {
+        return 0;
+    }
+    unsigned int gen = search_context_begin(ctx);
+
+    int s = graph_to_internal(graph, start);
+    int t = graph_to_internal(graph, goal);
+
+    ctx->stamp[s] = gen;
+    ((long long *)ctx->dist)[s] = 0;
+    ctx->parent[s] = -1;
+    ctx->stampBack[t] = gen;
+    ctx->distBack[t] = 0;
+    ctx->parentBack[t] = -1;
+
+    long long mu = s == t ? 0 : LLONG_MAX;
+    int meet = s == t ? s : -1;
+    long long radius_fwd = 0, radius_bwd = 0;
+    int failed = pqueue_push(ctx->queue, s, 0) != 0 || pqueue_push(ctx->queueBack, t, 0) != 0;
+
+    /* Same stopping rule as bidirectional Dijkstra, on the overlay graph */
+    while (!failed && ctx->queue->size > 0 && ctx->queueBack->size > 0) {
+        int backward = radius_bwd < radius_fwd;
+        int u;
+        long long du;
+        if (pqueue_pop(backward ? ctx->queueBack : ctx->queue, &u, &du) != 0) {
+            failed = 1;     /* Both queues are non-empty, so only PQUEUE_NO_MEMORY */
+            break;
+        }
+
+        if (backward) radius_bwd = du; else radius_fwd = du;
+        if (mu != LLONG_MAX && radius_fwd + radius_bwd >= mu) {
+            break;
+        }
+        ctx->settled++;
+
+        int level = crp_query_level(crp, u, s, t);
+        failed = crp_scan(crp, graph, rev, ctx, backward, u, du, level, &mu, &meet) != 0;
+    }
+
+    pqueue_clear(ctx->queue);
+    pqueue_clear(ctx->queueBack);
+    if (failed || meet < 0) {
+        return 0;
+    }
+
+    /* Overlay path s → meet → t, copied out before the unpacking searches reuse the context */
+    int hops = 0;
+    for (int x = meet; x != -1; x = ctx->parent[x]) hops++;
+    int up = hops;
+    for (int x = ctx->parentBack[meet]; x != -1; x = ctx->parentBack[x]) hops++;
+
+    int *overlay = malloc(hops * sizeof(int));
+    if (!overlay) {
+        return 0;
+    }
+    int i = up;
+    for (int x = meet; x != -1; x = ctx->parent[x]) overlay[--i] = x;
+    i = up;
+    for (int x = ctx->parentBack[meet]; x != -1; x = ctx->parentBack[x]) overlay[i++] = x;
+
+    /* A step within one cell of a's query level is a clique arc; every other step is an edge */
+    int settled = ctx->settled;
+    int len = 0;
+    out_path[len++] = start;
+    for (i = 0; i + 1 < hops && len > 0; i++) {
+        int a = overlay[i], b = overlay[i + 1];
+        int level = crp_query_level(crp, a, s, t);
+        if (level > 0 && crp->levels[level - 1].cellOf[a] == crp->levels[level - 1].cellOf[b]) {
+            len = crp_unpack(crp, graph, ctx, level, a, b, out_path, len, max_path_len);
+            if (len < 0) len = 0;
+        } else if (len < max_path_len) {
+            out_path[len++] = graph_to_external(graph, b);
+        } else {
+            len = 0;
+        }
+    }
+    ctx->settled = settled;
+    free(overlay);
+
+    *out_distance = len > 0 ? mu : -1;
+    return len;
+}
@@ -0,0 +1,556 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../include/graph.h"
+
+/* ============================================================================
+   Delta overlay: live edge updates on top of the frozen base adjacency
+
+   Every changed edge (from, to) owns one DeltaEdge. Entries of the same source
+   are chained through nextOfSource and entries of the same target through
+   nextOfTarget, so both the forward and the reverse iterator only leave the
+   fast path for vertices that actually have pending changes. A linear-probing
+   index over (from, to) finds the entry of one edge without walking a chain.
+   ========================================================================== */
+
+#define DELTA_MIN_CAPACITY 16
+
+enum { DELTA_INSERT, DELTA_DELETE, DELTA_REWEIGHT };
+
+struct DeltaCompaction {
+    pthread_t thread;
+    int threaded;                  /* thread was started and must be joined */
+    atomic_int done;               /* set by the worker when result is ready */
+    int failed;
+    const Graph *graph;            /* base is read-only while the job runs */
+    DeltaEdge *entries;            /* overlay as of sealedSeq */
+    int *heads;
+    int *slots;                    /* index over entries, slotMask + 1 of them */
+    int slotMask;
+    int count;
+    unsigned int sealedSeq;
+    GraphCSR result;
+    int distBits;
+    unsigned long long bound;
+};
+
+static unsigned long long abs_weight(long long w) {
+    return w < 0 ? 0ULL - (unsigned long long)w : (unsigned long long)w;
+}
+
+static unsigned long long add_saturating(unsigned long long a, unsigned long long b) {
+    return a > ULLONG_MAX - b ? ULLONG_MAX : a + b;
+}
+
+static int delta_slot(int from, int to, int mask) {
+    uint64_t h = ((uint64_t)(uint32_t)from << 32 | (uint32_t)to) * 0x9E3779B97F4A7C15ULL;
+    return (int)(h >> 32) & mask;
+}
+
+static int delta_find(const DeltaEdge *entries, const int *slots, int mask, int from, int to) {
+    if (!slots) {
+        return -1;
+    }
+    for (int i = delta_slot(from, to, mask); slots[i] >= 0; i = (i + 1) & mask) {
+        const DeltaEdge *e = &entries[slots[i]];
+        if (e->from == from && e->to == to) {
+            return slots[i];
+        }
+    }
+    return -1;
+}
+
+static void delta_index_insert(GraphDelta *d, int k) {
+    int i = delta_slot(d->entries[k].from, d->entries[k].to, d->slotMask);
+    while (d->slots[i] >= 0) {
+        i = (i + 1) & d->slotMask;
+    }
+    d->slots[i] = k;
+}
+
+/* Sizes the index for capacity entries and reinserts the ones in use */
+static int delta_index_build(GraphDelta *d, int capacity) {
+    int size = 2 * DELTA_MIN_CAPACITY;
+    while (size < 2 * capacity) {
+        size *= 2;
+    }
+
+    if (!d->slots || d->slotMask != size - 1) {
+        int *slots = malloc(size * sizeof(int));
+        if (!slots) {
+            return -1;
+        }
+        free(d->slots);
+        d->slots = slots;
+        d->slotMask = size - 1;
+    }
+
+    for (int i = 0; i < size; i++) {
+        d->slots[i] = -1;
+    }
+    for (int k = 0; k < d->count; k++) {
+        delta_index_insert(d, k);
+    }
+    return 0;
+}
+
+/*
+ * Starts iterating the base edges of v. Unlike graph_edges_begin() it never
+ * reads graph->delta, whose head array the main thread keeps writing while a
+ * background compaction walks the base.
+ */
+static void base_edges_begin(const Graph *graph, int v, GraphEdgeIter *it) {
+    if (graph->compressed) {
+        const GraphCompressed *cg = graph->compressed;
+        it->first = graph->csr.offsets[v];
+        it->edge = it->first - 1;
+        it->end = graph->csr.offsets[v + 1];
+        it->to = v;
+        it->targets = NULL;
+        it->weights = NULL;
+        it->cursor = cg->data + cg->byteOffsets[v];
+        it->weightBytes = cg->weightBytes;
+        it->source = v;
+        it->deltaNext = -2;
+        it->delta = NULL;
+        return;
+    }
+    graph_csr_edges_begin(&graph->csr, v, it);
+}
+
+static int base_has_edge(const Graph *graph, int from, int to) {
+    GraphEdgeIter it;
+    for (base_edges_begin(graph, from, &it); graph_base_edges_next(&it); ) {
+        if (it.to == to) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Sum of each vertex's largest |weight| in the base (see graph_freeze) */
+static unsigned long long base_bound(const Graph *graph) {
+    unsigned long long bound = 0;
+    GraphEdgeIter it;
+
+    for (int v = 0; v < graph->numVertices; v++) {
+        unsigned long long max_abs = 0;
+        for (base_edges_begin(graph, v, &it); graph_base_edges_next(&it); ) {
+            unsigned long long a = abs_weight(it.weight);
+            if (a > max_abs) max_abs = a;
+        }
+        bound = add_saturating(bound, max_abs);
+    }
+    return bound;
+}
+
+static GraphDelta *delta_get(Graph *graph) {
+    if (graph->delta) {
+        return graph->delta;
+    }
+
+    GraphDelta *d = calloc(1, sizeof(GraphDelta));
+    int *heads = malloc(graph->numVertices * sizeof(int));
+    int *tails = malloc(graph->numVertices * sizeof(int));
+    if (!d || !heads || !tails) {
+        free(d);
+        free(heads);
+        free(tails);
+        return NULL;
+    }
+
+    for (int v = 0; v < graph->numVertices; v++) {
+        heads[v] = -1;
+        tails[v] = -1;
+    }
+    d->headOfSource = heads;
+    d->headOfTarget = tails;
+    d->baseBound = base_bound(graph);
+    graph->delta = d;
+    return d;
+}
+
+static int delta_append(GraphDelta *d, int from, int to, int in_base) {
+    if (d->count == d->capacity) {
+        int capacity = d->capacity ? d->capacity * 2 : DELTA_MIN_CAPACITY;
+        DeltaEdge *grown = realloc(d->entries, capacity * sizeof(DeltaEdge));
+        if (!grown) {
+            return -1;
+        }
+        d->entries = grown;
+        if (delta_index_build(d, capacity) != 0) {
+            return -1;
+        }
+        d->capacity = capacity;
+    }
+
+    int k = d->count++;
+    DeltaEdge *e = &d->entries[k];
+    e->from = from;
+    e->to = to;
+    e->weight = 0;
+    e->seq = 0;
+    e->deleted = 1;
+    e->inBase = (uint8_t)in_base;
+    e->nextOfSource = d->headOfSource[from];
+    d->headOfSource[from] = k;
+    e->nextOfTarget = d->headOfTarget[to];
+    d->headOfTarget[to] = k;
+    delta_index_insert(d, k);
+    return k;
+}
+
+static int delta_update(Graph *graph, int source, int destination, long long weight, int op) {
+    if (!graph || source < 0 || destination < 0 ||
+        source >= graph->numVertices || destination >= graph->numVertices ||
+        graph_freeze(graph) != 0) {
+        return -1;
+    }
+
+    GraphDelta *d = delta_get(graph);
+    if (!d) {
+        return -1;
+    }
+
+    int u = graph_to_internal(graph, source);
+    int v = graph_to_internal(graph, destination);
+    int k = delta_find(d->entries, d->slots, d->slotMask, u, v);
+    int in_base = k >= 0 ? d->entries[k].inBase : base_has_edge(graph, u, v);
+    int live = k >= 0 ? !d->entries[k].deleted : in_base;
+
+    if (op == DELTA_INSERT ? live : !live) {
+        return -1;
+    }
+
+    if (k < 0 && (k = delta_append(d, u, v, in_base)) < 0) {
+        return -1;
+    }
+
+    DeltaEdge *e = &d->entries[k];
+    e->deleted = (op == DELTA_DELETE);
+    if (op != DELTA_DELETE) {
+        e->weight = weight;
+        d->absWeightSum = add_saturating(d->absWeightSum, abs_weight(weight));
+        if (weight > d->maxWeight) d->maxWeight = weight;
+    }
+    e->seq = ++d->seq;
+    graph->version++;
+    return 0;
+}
+
+int graph_insert_edge(Graph *graph, int source, int destination, long long weight) {
+    return delta_update(graph, source, destination, weight, DELTA_INSERT);
+}
+
+int graph_delete_edge(Graph *graph, int source, int destination) {
+    return delta_update(graph, source, destination, 0, DELTA_DELETE);
+}
+
+int graph_set_edge_weight(Graph *graph, int source, int destination, long long weight) {
+    return delta_update(graph, source, destination, weight, DELTA_REWEIGHT);
+}
+
+int graph_delta_size(const Graph *graph) {
+    return (graph && graph->delta) ? graph->delta->count : 0;
+}
+
+/* ============================================================================
+   Iteration over base ⊕ overlay
+   ========================================================================== */
+
+int graph_delta_edges_next(GraphEdgeIter *it) {
+    const GraphDelta *d = it->delta;
+
+    /* Base edges first, dropping deleted ones and applying new weights */
+    while (it->deltaNext == -2) {
+        if (!graph_base_edges_next(it)) {
+            it->deltaNext = it->reverse ? d->headOfTarget[it->source] : d->headOfSource[it->source];
+            break;
+        }
+
+        int k = it->reverse ? delta_find(d->entries, d->slots, d->slotMask, it->to, it->source)
+                            : delta_find(d->entries, d->slots, d->slotMask, it->source, it->to);
+        if (k < 0) {
+            return 1;
+        }
+        if (!d->entries[k].deleted) {
+            it->weight = d->entries[k].weight;
+            return 1;
+        }
+    }
+
+    /* Then edges that exist only in the overlay */
+    while (it->deltaNext >= 0) {
+        const DeltaEdge *e = &d->entries[it->deltaNext];
+        it->deltaNext = it->reverse ? e->nextOfTarget : e->nextOfSource;
+        if (!e->inBase && !e->deleted) {
+            it->to = it->reverse ? e->from : e->to;
+            it->weight = e->weight;
+            it->edge = -1;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* ============================================================================
+   Compaction
+   ========================================================================== */
+
+/*
+ * Merges the base edges of v with the sealed overlay. Only counts when
+ * csr->targets is NULL, otherwise writes the edges from index pos on.
+ */
+static int compaction_vertex(const struct DeltaCompaction *job, int v, GraphCSR *csr, int pos,
+                             long long *min_w, long long *max_w, unsigned long long *max_abs) {
+    const DeltaEdge *entries = job->entries;
+    GraphEdgeIter it;
+    int written = 0;
+
+    for (base_edges_begin(job->graph, v, &it); graph_base_edges_next(&it); ) {
+        long long w = it.weight;
+        int k = delta_find(entries, job->slots, job->slotMask, v, it.to);
+        if (k >= 0) {
+            if (entries[k].deleted) continue;
+            w = entries[k].weight;
+        }
+
+        if (csr->targets) {
+            csr->targets[pos + written] = it.to;
+            graph_csr_set_weight(csr, pos + written, w);
+        } else {
+            if (w < *min_w) *min_w = w;
+            if (w > *max_w) *max_w = w;
+            if (abs_weight(w) > *max_abs) *max_abs = abs_weight(w);
+        }
+        written++;
+    }
+
+    for (int k = job->heads[v]; k >= 0; k = entries[k].nextOfSource) {
+        if (entries[k].inBase || entries[k].deleted) continue;
+        long long w = entries[k].weight;
+
+        if (csr->targets) {
+            csr->targets[pos + written] = entries[k].to;
+            graph_csr_set_weight(csr, pos + written, w);
+        } else {
+            if (w < *min_w) *min_w = w;
+            if (w > *max_w) *max_w = w;
+            if (abs_weight(w) > *max_abs) *max_abs = abs_weight(w);
+        }
+        written++;
+    }
+
+    return written;
+}
+
+static int compaction_build(struct DeltaCompaction *job) {
+    const Graph *graph = job->graph;
+    int n = graph->numVertices;
+    GraphCSR csr = {0};
+
+    csr.offsets = malloc((n + 1) * sizeof(int));
+    if (!csr.offsets) {
+        return -1;
+    }
+
+    long long min_w = 0, max_w = 0;
+    unsigned long long bound = 0;
+    long long m = 0;
+    for (int v = 0; v < n; v++) {
+        unsigned long long max_abs = 0;
+        csr.offsets[v] = (int)m;
+        m += compaction_vertex(job, v, &csr, 0, &min_w, &max_w, &max_abs);
+        bound = add_saturating(bound, max_abs);
+        if (m > INT_MAX) {
+            free(csr.offsets);
+            return -1;
+        }
+    }
+    csr.offsets[n] = (int)m;
+    csr.numEdges = (int)m;
+
+    csr.weightBits = graph_weight_bits_for_range(min_w, max_w);
+    if (csr.weightBits < graph->minWeightBits) csr.weightBits = graph->minWeightBits;
+    int dist_bits = graph_dist_bits_for_bound(bound);
+    if (dist_bits < graph->minDistBits) dist_bits = graph->minDistBits;
+    if (dist_bits < csr.weightBits) dist_bits = csr.weightBits;
+
+    int *targets = malloc((m > 0 ? m : 1) * sizeof(int));
+    csr.weights = malloc((size_t)(m > 0 ? m : 1) * (size_t)(csr.weightBits / 8));
+    if (!targets || !csr.weights) {
+        free(targets);
+        free(csr.weights);
+        free(csr.offsets);
+        return -1;
+    }
+
+    csr.targets = targets;
+    for (int v = 0; v < n; v++) {
+        compaction_vertex(job, v, &csr, csr.offsets[v], &min_w, &max_w, NULL);
+    }
+
+    job->result = csr;
+    job->distBits = dist_bits;
+    job->bound = bound;
+    return 0;
+}
+
+static void *compaction_thread(void *arg) {
+    struct DeltaCompaction *job = arg;
+    job->failed = compaction_build(job) != 0;
+    atomic_store(&job->done, 1);
+    return NULL;
+}
+
+static void compaction_free(struct DeltaCompaction *job) {
+    free(job->entries);
+    free(job->heads);
+    free(job->slots);
+    free(job->result.offsets);
+    free(job->result.targets);
+    free(job->result.weights);
+    free(job);
+}
+
+/* Swaps in the finished base and keeps only the updates made after sealing */
+static int compaction_install(Graph *graph) {
+    GraphDelta *d = graph->delta;
+    struct DeltaCompaction *job = d->job;
+
+    if (job->threaded) {
+        pthread_join(job->thread, NULL);
+    }
+    d->job = NULL;
+
+    if (job->failed || graph_install_csr(graph, &job->result, job->distBits) != 0) {
+        compaction_free(job);
+        return -1;
+    }
+
+    int kept = 0;
+    d->absWeightSum = 0;
+    d->maxWeight = 0;
+    for (int v = 0; v < graph->numVertices; v++) {
+        d->headOfSource[v] = -1;
+        d->headOfTarget[v] = -1;
+    }
+    for (int k = 0; k < d->count; k++) {
+        DeltaEdge e = d->entries[k];
+        if (e.seq <= job->sealedSeq) continue;
+
+        e.inBase = (uint8_t)base_has_edge(graph, e.from, e.to);
+        if (e.deleted && !e.inBase) continue;
+        if (!e.deleted) {
+            d->absWeightSum = add_saturating(d->absWeightSum, abs_weight(e.weight));
+            if (e.weight > d->maxWeight) d->maxWeight = e.weight;
+        }
+
+        e.nextOfSource = d->headOfSource[e.from];
+        d->headOfSource[e.from] = kept;
+        e.nextOfTarget = d->headOfTarget[e.to];
+        d->headOfTarget[e.to] = kept;
+        d->entries[kept++] = e;
+    }
+    d->count = kept;
+    d->baseBound = job->bound;
+    delta_index_build(d, d->capacity);   /* same size as before, cannot fail */
+
+    /* One-way inserts folded into the base may break symmetry */
+    graph->symmetric = 0;
+
+    compaction_free(job);
+    return 0;
+}
+
+int graph_compact(Graph *graph, int background) {
+    if (!graph || graph_freeze(graph) != 0 || graph_compact_wait(graph) != 0) {
+        return -1;
+    }
+
+    GraphDelta *d = graph->delta;
+    if (!d || d->count == 0) {
+        return 0;
+    }
+
+    int n = graph->numVertices;
+    struct DeltaCompaction *job = calloc(1, sizeof(struct DeltaCompaction));
+    if (job) {
+        job->entries = malloc(d->count * sizeof(DeltaEdge));
+        job->heads = malloc(n * sizeof(int));
+        job->slots = malloc((d->slotMask + 1) * sizeof(int));
+    }
+    if (!job || !job->entries || !job->heads || !job->slots) {
+        if (job) compaction_free(job);
+        return -1;
+    }
+
+    memcpy(job->entries, d->entries, d->count * sizeof(DeltaEdge));
+    memcpy(job->heads, d->headOfSource, n * sizeof(int));
+    memcpy(job->slots, d->slots, (d->slotMask + 1) * sizeof(int));
+    job->slotMask = d->slotMask;
+    job->count = d->count;
+    job->sealedSeq = d->seq;
+    job->graph = graph;
+    atomic_init(&job->done, 0);
+    d->job = job;
+
+    if (background && pthread_create(&job->thread, NULL, compaction_thread, job) == 0) {
+        job->threaded = 1;
+        return 0;
+    }
+
+    compaction_thread(job);
+    return compaction_install(graph);
+}
+
+int graph_compact_wait(Graph *graph) {
+    if (!graph || !graph->delta || !graph->delta->job) {
+        return 0;
+    }
+    return compaction_install(graph);
+}
+
+int graph_delta_poll(Graph *graph) {
+    if (!graph || !graph->delta || !graph->delta->job ||
+        !atomic_load(&graph->delta->job->done)) {
+        return 0;
+    }
+    return compaction_install(graph) == 0;
+}
+
+void graph_delta_rebase(Graph *graph) {
+    GraphDelta *d = graph ? graph->delta : NULL;
+    if (!d) {
+        return;
+    }
+
+    for (int k = 0; k < d->count; k++) {
+        d->entries[k].inBase = (uint8_t)base_has_edge(graph, d->entries[k].from, d->entries[k].to);
+    }
+    d->baseBound = base_bound(graph);
+}
+
+void graph_delta_free(Graph *graph) {
+    GraphDelta *d = graph ? graph->delta : NULL;
+    if (!d) {
+        return;
+    }
+
+    if (d->job) {
+        if (d->job->threaded) {
+            pthread_join(d->job->thread, NULL);
+        }
+        compaction_free(d->job);
+    }
+
+    free(d->entries);
+    free(d->headOfSource);
+    free(d->headOfTarget);
+    free(d->slots);
+    free(d);
+    graph->delta = NULL;
+}
@@ -0,0 +1,323 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "../include/distance_matrix.h"
+#include "../include/parallel.h"
+#include "../include/pqueue.h"
+
+/* Tentative distance of a rank the current search has not reached */
+#define MATRIX_UNSEEN LLONG_MAX
+
+/* ============================================================================
+   Upward searches with stall-on-demand
+   ========================================================================== */
+
+typedef struct {
+    const ContractionHierarchy *ch;
+    PQueue *pq;
+    long long *dist;        /* per rank, MATRIX_UNSEEN outside the current search */
+    int *touched;           /* ranks whose dist must be reset */
+    int *settled;           /* unstalled ranks in settling order */
+    long long *settledDist;
+    int numSettled;
+} MatrixSearch;
+
+/*
+ * Dijkstra from rank root over upward arcs (forward) or reversed downward
+ * arcs (backward). A vertex that a higher neighbour already reaches more
+ * cheaply through the opposite arc direction is stalled: its distance is not
+ * a shortest one, so it is neither expanded nor reported.
+ */
+static int matrix_search(MatrixSearch *s, int root, int backward) {
+    const ContractionHierarchy *ch = s->ch;
+    int num_touched = 0, failed = 0;
+
+    s->numSettled = 0;
+    pqueue_clear(s->pq);
+    s->dist[root] = 0;
+    s->touched[num_touched++] = root;
+    failed = pqueue_push(s->pq, root, 0) != 0;
+
+    int u;
+    long long du;
+    while (!failed && pqueue_pop(s->pq, &u, &du) == 0) {
+        int stalled = 0;
+        int first = backward ? ch->upOffsets[u] : ch->downOffsets[u];
+        int last = backward ? ch->upOffsets[u + 1] : ch->downOffsets[u + 1];
+        for (int i = first; i < last && !stalled; i++) {
+            int x = backward ? ch->upTargets[i] : ch->downSources[i];
+            long long w = backward ? ch->upWeights[i] : ch->downWeights[i];
+            stalled = w != CH_NO_ARC && s->dist[x] != MATRIX_UNSEEN && s->dist[x] + w < du;
+        }
+        if (stalled) {
+            continue;
+        }
+        s->settled[s->numSettled] = u;
+        s->settledDist[s->numSettled++] = du;
+
+        first = backward ? ch->downOffsets[u] : ch->upOffsets[u];
+        last = backward ? ch->downOffsets[u + 1] : ch->upOffsets[u + 1];
+        for (int i = first; i < last; i++) {
+            int x = backward ? ch->downSources[i] : ch->upTargets[i];
+            long long w = backward ? ch->downWeights[i] : ch->upWeights[i];
+            if (w == CH_NO_ARC) {
+                continue;
+            }
+            long long nd = du + w;
+            if (s->dist[x] != MATRIX_UNSEEN && nd >= s->dist[x]) {
+                continue;
+            }
+            if (s->dist[x] == MATRIX_UNSEEN) {
+                s->touched[num_touched++] = x;
+            }
+            s->dist[x] = nd;
+            if (pqueue_push(s->pq, x, nd) != 0) {
+                failed = 1;
+                break;
+            }
+        }
+    }
+
+    pqueue_clear(s->pq);
+    for (int i = 0; i < num_touched; i++) {
+        s->dist[s->touched[i]] = MATRIX_UNSEEN;
+    }
+    return failed ? -1 : 0;
+}
+
+static int matrix_search_init(MatrixSearch *s, const ContractionHierarchy *ch) {
+    int n = ch->numVertices > 0 ? ch->numVertices : 1;
+    s->ch = ch;
+    s->pq = pqueue_create(PQ_BINARY_HEAP, n, 0);
+    s->dist = malloc(n * sizeof(long long));
+    s->touched = malloc(n * sizeof(int));
+    s->settled = malloc(n * sizeof(int));
+    s->settledDist = malloc(n * sizeof(long long));
+    s->numSettled = 0;
+    if (!s->pq || !s->dist || !s->touched || !s->settled || !s->settledDist) {
+        return -1;
+    }
+    for (int r = 0; r < n; r++) {
+        s->dist[r] = MATRIX_UNSEEN;
+    }
+    return 0;
+}
+
+static void matrix_search_free(MatrixSearch *s) {
+    pqueue_destroy(s->pq);
+    free(s->dist);
+    free(s->touched);
+    free(s->settled);
+    free(s->settledDist);
+}
+
+/* ============================================================================
+   Jobs – backward searches fill bucket entries, forward searches fill rows
+   ========================================================================== */
+
+typedef struct {
+    const ContractionHierarchy *ch;
+    const int *roots;           /* rank per target (backward) or source (forward) */
+    int first;
+    int last;                   /* exclusive */
+    int backward;
+    /* Backward: entries (rank, column, distance) of this slice */
+    int *entryRank;
+    int *entryCol;
+    long long *entryDist;
+    int numEntries;
+    int capacity;
+    /* Forward: shared buckets and output */
+    const int *bucketOffsets;   /* bucket of rank r: [bucketOffsets[r], bucketOffsets[r + 1]) */
+    const int *bucketCol;
+    const long long *bucketDist;
+    long long *out;
+    int numTargets;
+    int failed;
+} MatrixJob;
+
+static int matrix_entries_reserve(MatrixJob *job, int extra) {
+    if (job->numEntries + extra <= job->capacity) {
+        return 0;
+    }
+    int capacity = (job->numEntries + extra) * 2;
+    int *ranks = realloc(job->entryRank, capacity * sizeof(int));
+    if (ranks) job->entryRank = ranks;
+    int *cols = realloc(job->entryCol, capacity * sizeof(int));
+    if (cols) job->entryCol = cols;
+    long long *dists = realloc(job->entryDist, capacity * sizeof(long long));
+    if (dists) job->entryDist = dists;
+    if (!ranks || !cols || !dists) return -1;
+    job->capacity = capacity;
+    return 0;
+}
+
+typedef struct {
+    const MatrixJob *proto;
+    MatrixJob *jobs;            /* one per team member */
+    int count;                  /* roots to split */
+} MatrixRun;
+
+static void matrix_member(void *ctx, ParallelTeam *team, int member, int size) {
+    const MatrixRun *run = ctx;
+    MatrixJob *job = &run->jobs[member];
+    MatrixSearch s;
+    (void)team;
+
+    *job = *run->proto;
+    parallel_slice(run->count, member, size, &job->first, &job->last);
+
+    if (matrix_search_init(&s, job->ch) != 0) {
+        job->failed = 1;
+    }
+
+    for (int i = job->first; !job->failed && i < job->last; i++) {
+        if (matrix_search(&s, job->roots[i], job->backward) != 0) {
+            job->failed = 1;
+            break;
+        }
+
+        if (job->backward) {
+            if (matrix_entries_reserve(job, s.numSettled) != 0) {
+                job->failed = 1;
+                break;
+            }
+            for (int x = 0; x < s.numSettled; x++) {
+                job->entryRank[job->numEntries] = s.settled[x];
+                job->entryCol[job->numEntries] = i;
+                job->entryDist[job->numEntries++] = s.settledDist[x];
+            }
+            continue;
+        }
+
+        long long *row = job->out + (size_t)i * job->numTargets;
+        for (int j = 0; j < job->numTargets; j++) {
+            row[j] = LLONG_MAX;
+        }
+        for (int x = 0; x < s.numSettled; x++) {
+            int r = s.settled[x];
+            long long d = s.settledDist[x];
+            for (int e = job->bucketOffsets[r]; e < job->bucketOffsets[r + 1]; e++) {
+                long long nd = d + job->bucketDist[e];
+                if (nd < row[job->bucketCol[e]]) {
+                    row[job->bucketCol[e]] = nd;
+                }
+            }
+        }
+        for (int j = 0; j < job->numTargets; j++) {
+            if (row[j] == LLONG_MAX) row[j] = -1;
+        }
+    }
+
+    matrix_search_free(&s);
+}
+
+/* Splits count roots across a team of up to members threads, one job each */
+static int matrix_run(MatrixJob *jobs, const MatrixJob *proto, int count, int members) {
+    MatrixRun run = { proto, jobs, count };
+    parallel_run(members, matrix_member, &run);
+
+    /* Jobs of members that did not start stay zeroed */
+    int failed = 0;
+    for (int t = 0; t < members; t++) {
+        failed |= jobs[t].failed;
+    }
+    return failed ? -1 : 0;
+}
+
+int distance_matrix(Graph *graph, const ContractionHierarchy *ch, const int *sources, int num_sources,
+                    const int *targets, int num_targets, long long *out, int num_threads) {
+    if (!graph || !ch || num_sources < 0 || num_targets < 0 || (num_sources > 0 && (!sources || !out)) ||
+        (num_targets > 0 && !targets) || graph_freeze(graph) != 0 || ch->numVertices != graph->numVertices ||
+        ch->graphVersion != graph_version(graph)) {
+        return -1;
+    }
+    if (num_threads <= 0) {
+        num_threads = MATRIX_DEFAULT_THREADS;
+    }
+
+    int n = graph->numVertices;
+    int *source_ranks = malloc((num_sources > 0 ? num_sources : 1) * sizeof(int));
+    int *target_ranks = malloc((num_targets > 0 ? num_targets : 1) * sizeof(int));
+    int ok = source_ranks && target_ranks;
+    for (int i = 0; ok && i < num_sources; i++) {
+        ok = sources[i] >= 0 && sources[i] < n;
+        if (ok) source_ranks[i] = ch->rankOf[graph_to_internal(graph, sources[i])];
+    }
+    for (int j = 0; ok && j < num_targets; j++) {
+        ok = targets[j] >= 0 && targets[j] < n;
+        if (ok) target_ranks[j] = ch->rankOf[graph_to_internal(graph, targets[j])];
+    }
+
+    int threads_back = parallel_threads(num_threads, num_targets);
+    int threads_fwd = parallel_threads(num_threads, num_sources);
+    MatrixJob *back = calloc(threads_back, sizeof(MatrixJob));
+    MatrixJob *fwd = calloc(threads_fwd, sizeof(MatrixJob));
+    MatrixJob proto = { 0 };
+    proto.ch = ch;
+    proto.numTargets = num_targets;
+    proto.out = out;
+    ok = ok && back && fwd;
+
+    /* Backward searches from the targets */
+    if (ok) {
+        proto.roots = target_ranks;
+        proto.backward = 1;
+        ok = matrix_run(back, &proto, num_targets, threads_back) == 0;
+    }
+
+    /* Group every slice's entries by rank */
+    int total = 0;
+    for (int t = 0; ok && t < threads_back; t++) {
+        total += back[t].numEntries;
+    }
+    int *offsets = ok ? calloc(n + 1, sizeof(int)) : NULL;
+    int *cols = ok ? malloc((total > 0 ? total : 1) * sizeof(int)) : NULL;
+    long long *dists = ok ? malloc((total > 0 ? total : 1) * sizeof(long long)) : NULL;
+    ok = ok && offsets && cols && dists;
+    if (ok) {
+        for (int t = 0; t < threads_back; t++) {
+            for (int e = 0; e < back[t].numEntries; e++) {
+                offsets[back[t].entryRank[e] + 1]++;
+            }
+        }
+        for (int r = 0; r < n; r++) {
+            offsets[r + 1] += offsets[r];
+        }
+        for (int t = 0; t < threads_back; t++) {
+            for (int e = 0; e < back[t].numEntries; e++) {
+                int at = offsets[back[t].entryRank[e]]++;
+                cols[at] = back[t].entryCol[e];
+                dists[at] = back[t].entryDist[e];
+            }
+        }
+        /* The fill pass moved each offset to the end of its bucket */
+        memmove(offsets + 1, offsets, n * sizeof(int));
+        offsets[0] = 0;
+    }
+    for (int t = 0; back && t < threads_back; t++) {
+        free(back[t].entryRank);
+        free(back[t].entryCol);
+        free(back[t].entryDist);
+    }
+    free(back);
+
+    /* Forward searches from the sources, one row each */
+    if (ok) {
+        proto.roots = source_ranks;
+        proto.backward = 0;
+        proto.bucketOffsets = offsets;
+        proto.bucketCol = cols;
+        proto.bucketDist = dists;
+        ok = matrix_run(fwd, &proto, num_sources, threads_fwd) == 0;
+    }
+
+    free(fwd);
+    free(source_ranks);
+    free(target_ranks);
+    free(offsets);
+    free(cols);
+    free(dists);
+    return ok ? 0 : -1;
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "../include/graph.h"
 
 Graph *createGraph(int vertices) {
@@ -14,32 +15,94 @@ Graph *createGraph(int vertices) {
     }
 
     graph->numVertices = vertices;
+    graph->edgeChunks = NULL;
+    graph->csr = (GraphCSR){0};
+    graph->frozen = 0;
+    graph->symmetric = 1;
+    graph->distBits = 16;
+    graph->minWeightBits = 0;
+    graph->minDistBits = 0;
+    graph->maxWeight = -1;
+    graph->reverse = NULL;
+    graph->compressed = NULL;
+    graph->delta = NULL;
+    graph->csrInMapping = 0;
+    graph->nameIndex = NULL;
+    graph->nameIndexMask = 0;
+    graph->toInternal = NULL;
+    graph->toExternal = NULL;
+    graph->version = 1;
+    graph->orderVersion = 1;
+    graph->coords = NULL;
+    graph->mapping = NULL;
+    graph->mappingSize = 0;
+    graph->unmap = NULL;
     graph->array = calloc(vertices, sizeof(AdjList));
-    graph->names = calloc(vertices, sizeof(char *));
-    if (!graph->array || !graph->names) {
+    memset(&graph->names, 0, sizeof(graph->names));
+    graph->nameOffsets = malloc(vertices * sizeof(uint32_t));
+    if (!graph->array || !graph->nameOffsets) {
         free(graph->array);
-        free(graph->names);
+        free(graph->nameOffsets);
         free(graph);
         return NULL;
     }
 
+    for (int i = 0; i < vertices; i++) {
+        graph->nameOffsets[i] = GRAPH_NO_NAME;
+    }
+
     return graph;
 }
 
-static Edge *createEdge(int destination, int weight) {
-    Edge *e = malloc(sizeof(Edge));
-    if (!e) {
+#define EDGE_CHUNK_MIN 256
+
+static EdgeChunk *edge_chunk_push(Graph *graph, int capacity) {
+    EdgeChunk *chunk = malloc(sizeof(EdgeChunk) + (size_t)capacity * sizeof(Edge));
+    if (!chunk) {
         return NULL;
     }
 
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    chunk->next = graph->edgeChunks;
+    graph->edgeChunks = chunk;
+    return chunk;
+}
+
+int graph_reserve_edges(Graph *graph, int count) {
+    if (!graph || !graph->array || count < 0) {
+        return -1;
+    }
+
+    EdgeChunk *chunk = graph->edgeChunks;
+    if (chunk && chunk->capacity - chunk->used >= count) {
+        return 0;
+    }
+
+    /* Grow geometrically so unreserved loads still need few chunks */
+    int capacity = chunk ? chunk->capacity : EDGE_CHUNK_MIN / 2;
+    capacity = (capacity <= INT_MAX / 2) ? capacity * 2 : INT_MAX;
+    if (capacity < count) {
+        capacity = count;
+    }
+
+    return edge_chunk_push(graph, capacity) ? 0 : -1;
+}
+
+/* Caller must have reserved room with graph_reserve_edges() */
+static Edge *createEdge(Graph *graph, int destination, long long weight) {
+    EdgeChunk *chunk = graph->edgeChunks;
+    Edge *e = &chunk->edges[chunk->used++];
+
     e->to = destination;
     e->weight = weight;
     e->next = NULL;
     return e;
 }
 
-void addWeightedEdge(Graph *graph, int source, int destination, int weight, int undirected) {
-    if (!graph) {
+void addWeightedEdge(Graph *graph, int source, int destination, long long weight, int undirected) {
+    /* A running compaction will replace the builder; use graph_insert_edge() instead */
+    if (!graph || !graph->array || (graph->delta && graph->delta->job)) {
         return;
     }
 
@@ -47,19 +110,13 @@ void addWeightedEdge(Graph *graph, int source, int destination, int weight, int
         return;
     }
 
-    Edge *v1 = createEdge(destination, weight);
-    if (!v1) {
+    /* Reserve both halves up front so an undirected edge is never half-inserted */
+    if (graph_reserve_edges(graph, undirected ? 2 : 1) != 0) {
         return;
     }
 
-    Edge *v2 = NULL;
-    if (undirected) {
-        v2 = createEdge(source, weight);
-        if (!v2) {
-            free(v1);
-            return;
-        }
-    }
+    Edge *v1 = createEdge(graph, destination, weight);
+    Edge *v2 = undirected ? createEdge(graph, source, weight) : NULL;
 
     v1->next = graph->array[source].head;
     graph->array[source].head = v1;
@@ -67,20 +124,809 @@ void addWeightedEdge(Graph *graph, int source, int destination, int weight, int
     if (undirected) {
         v2->next = graph->array[destination].head;
         graph->array[destination].head = v2;
+    } else {
+        graph->symmetric = 0;
     }
+
+    graph->frozen = 0;
 }
 
 void addEdge(Graph *graph, int source, int destination, int undirected) {
     addWeightedEdge(graph, source, destination, 1, undirected);
 }
 
+static void csr_free(GraphCSR *csr) {
+    free(csr->offsets);
+    free(csr->targets);
+    free(csr->weights);
+    *csr = (GraphCSR){0};
+}
+
+static void compressed_drop(Graph *graph) {
+    if (graph->compressed) {
+        free(graph->compressed->data);
+        free(graph->compressed->byteOffsets);
+        free(graph->compressed);
+        graph->compressed = NULL;
+    }
+}
+
+static void reverse_drop(Graph *graph) {
+    if (graph->reverse && graph->reverse != &graph->csr) {
+        csr_free(graph->reverse);
+        free(graph->reverse);
+    }
+    graph->reverse = NULL;
+}
+
+/* ============================================================================
+   Weight and distance widths
+   ========================================================================== */
+
+int graph_weight_bits_for_range(long long lo, long long hi) {
+    if (lo >= INT16_MIN && hi <= INT16_MAX) return 16;
+    if (lo >= INT32_MIN && hi <= INT32_MAX) return 32;
+    return 64;
+}
+
+int graph_dist_bits_for_bound(unsigned long long bound) {
+    if (bound < INT16_MAX) return 16;
+    if (bound < INT32_MAX) return 32;
+    return 64;
+}
+
+/* Allocates m weights of the given width (at least one slot) */
+static void *weights_alloc(int bits, int m) {
+    return malloc((size_t)(m > 0 ? m : 1) * (size_t)(bits / 8));
+}
+
+/* Builds a copy of csr where vertex v becomes new_of_old[v], keeping edge order */
+static int csr_permute(const GraphCSR *csr, int n, const int *new_of_old, GraphCSR *out) {
+    int m = csr->numEdges;
+    size_t wsize = (size_t)csr->weightBits / 8;
+    GraphCSR res = {0};
+
+    res.numEdges = m;
+    res.weightBits = csr->weightBits;
+    res.offsets = calloc(n + 1, sizeof(int));
+    res.targets = malloc((m > 0 ? m : 1) * sizeof(int));
+    res.weights = weights_alloc(res.weightBits, m);
+    if (!res.offsets || !res.targets || !res.weights) {
+        csr_free(&res);
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) {
+        res.offsets[new_of_old[v] + 1] = csr->offsets[v + 1] - csr->offsets[v];
+    }
+    for (int v = 0; v < n; v++) {
+        res.offsets[v + 1] += res.offsets[v];
+    }
+
+    for (int v = 0; v < n; v++) {
+        int j = res.offsets[new_of_old[v]];
+        for (int i = csr->offsets[v]; i < csr->offsets[v + 1]; i++, j++) {
+            res.targets[j] = new_of_old[csr->targets[i]];
+            memcpy((char *)res.weights + j * wsize, (const char *)csr->weights + i * wsize, wsize);
+        }
+    }
+
+    *out = res;
+    return 0;
+}
+
+int graph_freeze(Graph *graph) {
+    if (!graph) {
+        return -1;
+    }
+
+    if (graph->delta) {
+        graph_delta_poll(graph);
+    }
+
+    if (graph->frozen) {
+        return 0;
+    }
+
+    /* Unfrozen means the builder changed, which is refused while a compaction runs */
+    if (!graph->array) {
+        return -1;
+    }
+
+    int n = graph->numVertices;
+    GraphCSR csr = {0};
+
+    csr.offsets = malloc((n + 1) * sizeof(int));
+    if (!csr.offsets) {
+        return -1;
+    }
+
+    /*
+     * A shortest path leaves every vertex at most once, so the sum of each
+     * vertex's largest |weight| bounds any distance a kernel has to hold.
+     */
+    int m = 0;
+    long long min_w = 0, max_w = 0;
+    unsigned long long dist_bound = 0;
+    for (int v = 0; v < n; v++) {
+        unsigned long long max_abs = 0;
+        csr.offsets[v] = m;
+        for (Edge *e = graph->array[v].head; e != NULL; e = e->next) {
+            unsigned long long a = e->weight < 0 ? 0ULL - (unsigned long long)e->weight
+                                                 : (unsigned long long)e->weight;
+            if (a > max_abs) max_abs = a;
+            if (e->weight < min_w) min_w = e->weight;
+            if (e->weight > max_w) max_w = e->weight;
+            m++;
+        }
+        dist_bound = (dist_bound > ULLONG_MAX - max_abs) ? ULLONG_MAX : dist_bound + max_abs;
+    }
+    csr.offsets[n] = m;
+    csr.numEdges = m;
+
+    int dist_bits = graph_dist_bits_for_bound(dist_bound);
+    csr.weightBits = graph_weight_bits_for_range(min_w, max_w);
+    if (csr.weightBits < graph->minWeightBits) csr.weightBits = graph->minWeightBits;
+    if (dist_bits < graph->minDistBits) dist_bits = graph->minDistBits;
+    if (dist_bits < csr.weightBits) dist_bits = csr.weightBits;
+
+    /* Allocate at least one slot so an edgeless graph still has valid arrays */
+    csr.targets = malloc((m > 0 ? m : 1) * sizeof(int));
+    csr.weights = weights_alloc(csr.weightBits, m);
+    if (!csr.targets || !csr.weights) {
+        csr_free(&csr);
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) {
+        int i = csr.offsets[v];
+        for (Edge *e = graph->array[v].head; e != NULL; e = e->next) {
+            csr.targets[i] = e->to;
+            graph_csr_set_weight(&csr, i, e->weight);
+            i++;
+        }
+    }
+
+    /* Lists are in external order; reapply a previously chosen vertex order */
+    if (graph->toInternal) {
+        GraphCSR permuted;
+        int rc = csr_permute(&csr, n, graph->toInternal, &permuted);
+        csr_free(&csr);
+        if (rc != 0) {
+            return -1;
+        }
+        csr = permuted;
+    }
+
+    reverse_drop(graph);
+    compressed_drop(graph);
+    csr_free(&graph->csr);
+    graph->csr = csr;
+    graph->distBits = dist_bits;
+    graph->maxWeight = max_w;
+    graph->frozen = 1;
+    graph->version++;
+    graph_delta_rebase(graph);
+    return 0;
+}
+
+int graph_select_widths(Graph *graph, int weight_bits, int dist_bits) {
+    if (!graph || graph_compact_wait(graph) != 0 || !graph->array) {
+        return -1;
+    }
+
+    if ((weight_bits != 0 && weight_bits != 16 && weight_bits != 32 && weight_bits != 64) ||
+        (dist_bits != 0 && dist_bits != 16 && dist_bits != 32 && dist_bits != 64)) {
+        return -1;
+    }
+
+    graph->minWeightBits = weight_bits;
+    graph->minDistBits = dist_bits;
+    graph->frozen = 0;
+    return graph_freeze(graph);
+}
+
+long long graph_max_weight(Graph *graph) {
+    if (!graph || graph_freeze(graph) != 0) {
+        return -1;
+    }
+
+    if (graph->maxWeight < 0) {
+        long long max_w = 0;
+        GraphEdgeIter it;
+        for (int v = 0; v < graph->numVertices; v++) {
+            graph_edges_begin(graph, v, &it);
+            it.delta = NULL;    /* base edges only, the overlay keeps its own maximum */
+            while (graph_base_edges_next(&it)) {
+                if (it.weight > max_w) max_w = it.weight;
+            }
+        }
+        graph->maxWeight = max_w;
+    }
+
+    if (graph->delta && graph->delta->maxWeight > graph->maxWeight) {
+        return graph->delta->maxWeight;
+    }
+    return graph->maxWeight;
+}
+
+int graph_install_csr(Graph *graph, GraphCSR *csr, int dist_bits) {
+    if (!graph || !csr || !csr->offsets || !csr->targets || !csr->weights) {
+        return -1;
+    }
+
+    EdgeChunk *chunk = graph->edgeChunks;
+    while (chunk) {
+        EdgeChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    graph->edgeChunks = NULL;
+    free(graph->array);
+    graph->array = NULL;
+
+    reverse_drop(graph);
+    compressed_drop(graph);
+    if (!graph->csrInMapping) {
+        csr_free(&graph->csr);
+    }
+
+    graph->csr = *csr;
+    graph->csrInMapping = 0;
+    graph->distBits = dist_bits;
+    graph->maxWeight = -1;
+    graph->frozen = 1;
+    graph->version++;
+    *csr = (GraphCSR){0};
+    return 0;
+}
+
+const GraphCSR *graph_reverse(Graph *graph) {
+    if (!graph || graph_freeze(graph) != 0) {
+        return NULL;
+    }
+
+    /* Every change of the base drops the cache; the overlay is merged while iterating */
+    if (graph->reverse) {
+        return graph->reverse;
+    }
+
+    /* A compressed base has no targets/weights arrays to share */
+    if (graph->symmetric && !graph->compressed) {
+        graph->reverse = &graph->csr;
+        return graph->reverse;
+    }
+
+    int n = graph->numVertices;
+    GraphEdgeIter it;
+
+    GraphCSR *rev = calloc(1, sizeof(GraphCSR));
+    if (!rev) {
+        return NULL;
+    }
+
+    rev->offsets = calloc(n + 1, sizeof(int));
+    if (!rev->offsets) {
+        free(rev);
+        return NULL;
+    }
+
+    /* Counting sort of the base edges by destination */
+    long long min_w = 0, max_w = 0;
+    for (int u = 0; u < n; u++) {
+        graph_edges_begin(graph, u, &it);
+        while (graph_base_edges_next(&it)) {
+            rev->offsets[it.to + 1]++;
+            if (it.weight < min_w) min_w = it.weight;
+            if (it.weight > max_w) max_w = it.weight;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        rev->offsets[v + 1] += rev->offsets[v];
+    }
+
+    int m = rev->offsets[n];
+    rev->numEdges = m;
+    rev->weightBits = graph_weight_bits_for_range(min_w, max_w);
+    if (rev->weightBits < graph->csr.weightBits) rev->weightBits = graph->csr.weightBits;
+    rev->targets = malloc((m > 0 ? m : 1) * sizeof(int));
+    rev->weights = weights_alloc(rev->weightBits, m);
+    if (!rev->targets || !rev->weights) {
+        csr_free(rev);
+        free(rev);
+        return NULL;
+    }
+
+    int *fill = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (!fill) {
+        csr_free(rev);
+        free(rev);
+        return NULL;
+    }
+    memcpy(fill, rev->offsets, n * sizeof(int));
+
+    for (int u = 0; u < n; u++) {
+        graph_edges_begin(graph, u, &it);
+        while (graph_base_edges_next(&it)) {
+            int j = fill[it.to]++;
+            rev->targets[j] = u;
+            graph_csr_set_weight(rev, j, it.weight);
+        }
+    }
+
+    free(fill);
+    graph->reverse = rev;
+    return rev;
+}
+
+int graph_apply_permutation(Graph *graph, const int *new_of_old) {
+    if (!graph || !new_of_old || graph->mapping || graph_freeze(graph) != 0 ||
+        graph->compressed || graph_compact_wait(graph) != 0 || graph_delta_size(graph) > 0) {
+        return -1;
+    }
+
+    int n = graph->numVertices;
+    char *seen = calloc(n, 1);
+    int *to_internal = malloc(n * sizeof(int));
+    int *to_external = malloc(n * sizeof(int));
+    if (!seen || !to_internal || !to_external) {
+        free(seen);
+        free(to_internal);
+        free(to_external);
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) {
+        int nv = new_of_old[v];
+        if (nv < 0 || nv >= n || seen[nv]) {
+            free(seen);
+            free(to_internal);
+            free(to_external);
+            return -1;
+        }
+        seen[nv] = 1;
+    }
+    free(seen);
+
+    GraphCSR permuted;
+    if (csr_permute(&graph->csr, n, new_of_old, &permuted) != 0) {
+        free(to_internal);
+        free(to_external);
+        return -1;
+    }
+
+    /* Compose with the existing order so external IDs keep their meaning */
+    for (int v = 0; v < n; v++) {
+        int ext = graph->toExternal ? graph->toExternal[v] : v;
+        to_external[new_of_old[v]] = ext;
+        to_internal[ext] = new_of_old[v];
+    }
+
+    reverse_drop(graph);
+    csr_free(&graph->csr);
+    graph->csr = permuted;
+    free(graph->toInternal);
+    free(graph->toExternal);
+    graph->toInternal = to_internal;
+    graph->toExternal = to_external;
+    graph->version++;
+    graph->orderVersion++;
+    return 0;
+}
+
+/* ============================================================================
+   Compressed adjacency
+   ========================================================================== */
+
+typedef struct {
+    int to;
+    long long weight;
+} EdgePair;
+
+static int compare_edge_pairs(const void *a, const void *b) {
+    const EdgePair *ea = a, *eb = b;
+    if (ea->to != eb->to) return (ea->to > eb->to) - (ea->to < eb->to);
+    return (ea->weight > eb->weight) - (ea->weight < eb->weight);
+}
+
+static size_t varint_put(uint8_t *out, uint32_t x) {
+    size_t len = 0;
+    while (x >= 0x80) {
+        out[len++] = (uint8_t)(x | 0x80);
+        x >>= 7;
+    }
+    out[len++] = (uint8_t)x;
+    return len;
+}
+
+int graph_compress(Graph *graph) {
+    if (!graph || graph->mapping || graph_freeze(graph) != 0 || graph_compact_wait(graph) != 0) {
+        return -1;
+    }
+
+    if (graph->compressed) {
+        return 0;
+    }
+
+    int n = graph->numVertices;
+    GraphCSR *csr = &graph->csr;
+    int m = csr->numEdges;
+
+    long long min_w = 0, max_w = 0;
+    for (int i = 0; i < m; i++) {
+        long long w = graph_csr_weight(csr, i);
+        if (w < min_w) min_w = w;
+        if (w > max_w) max_w = w;
+    }
+    int weight_bytes = (min_w >= INT8_MIN && max_w <= INT8_MAX) ? 1 :
+                       graph_weight_bits_for_range(min_w, max_w) / 8;
+
+    GraphCompressed *cg = calloc(1, sizeof(GraphCompressed));
+    int max_deg = 0;
+    for (int v = 0; v < n; v++) {
+        int deg = csr->offsets[v + 1] - csr->offsets[v];
+        if (deg > max_deg) max_deg = deg;
+    }
+    EdgePair *pairs = malloc((max_deg > 0 ? max_deg : 1) * sizeof(EdgePair));
+    /* Worst case: 5 varint bytes plus the weight per edge */
+    size_t capacity = (size_t)m * (5 + weight_bytes) + 1;
+    if (cg) {
+        cg->data = malloc(capacity);
+        cg->byteOffsets = malloc((n + 1) * sizeof(size_t));
+    }
+    if (!cg || !pairs || !cg->data || !cg->byteOffsets) {
+        if (cg) {
+            free(cg->data);
+            free(cg->byteOffsets);
+        }
+        free(cg);
+        free(pairs);
+        return -1;
+    }
+
+    size_t pos = 0;
+    for (int v = 0; v < n; v++) {
+        int begin = csr->offsets[v];
+        int deg = csr->offsets[v + 1] - begin;
+        for (int k = 0; k < deg; k++) {
+            pairs[k].to = csr->targets[begin + k];
+            pairs[k].weight = graph_csr_weight(csr, begin + k);
+        }
+        qsort(pairs, deg, sizeof(EdgePair), compare_edge_pairs);
+
+        cg->byteOffsets[v] = pos;
+        int prev = v;
+        for (int k = 0; k < deg; k++) {
+            int delta = pairs[k].to - prev;
+            uint32_t code = (k == 0) ? ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31)
+                                     : (uint32_t)delta;
+            pos += varint_put(cg->data + pos, code);
+
+            int64_t w64 = pairs[k].weight;
+            int32_t w32 = (int32_t)w64;
+            int16_t w16 = (int16_t)w64;
+            int8_t  w8  = (int8_t)w64;
+            const void *wp = weight_bytes == 1 ? (const void *)&w8 :
+                             weight_bytes == 2 ? (const void *)&w16 :
+                             weight_bytes == 4 ? (const void *)&w32 : (const void *)&w64;
+            memcpy(cg->data + pos, wp, weight_bytes);
+            pos += weight_bytes;
+            prev = pairs[k].to;
+        }
+    }
+    cg->byteOffsets[n] = pos;
+    free(pairs);
+
+    uint8_t *shrunk = realloc(cg->data, pos > 0 ? pos : 1);
+    if (shrunk) {
+        cg->data = shrunk;
+    }
+    cg->dataSize = pos;
+    cg->weightBytes = weight_bytes;
+
+    /* Edge IDs now follow the sorted order, so per-edge caches are stale */
+    reverse_drop(graph);
+    free(csr->targets);
+    free(csr->weights);
+    csr->targets = NULL;
+    csr->weights = NULL;
+    graph->compressed = cg;
+    graph->version++;
+    return 0;
+}
+
+size_t graph_adjacency_bytes(const Graph *graph) {
+    if (!graph || !graph->frozen) {
+        return 0;
+    }
+
+    size_t n = (size_t)graph->numVertices;
+    size_t bytes = (n + 1) * sizeof(int);
+    if (graph->compressed) {
+        bytes += (n + 1) * sizeof(size_t) + graph->compressed->dataSize;
+    } else {
+        bytes += (size_t)graph->csr.numEdges * (sizeof(int) + (size_t)graph->csr.weightBits / 8);
+    }
+    return bytes;
+}
+
+int graph_drop_builder(Graph *graph) {
+    if (!graph || graph_freeze(graph) != 0) {
+        return -1;
+    }
+
+    EdgeChunk *chunk = graph->edgeChunks;
+    while (chunk) {
+        EdgeChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    graph->edgeChunks = NULL;
+
+    free(graph->array);
+    graph->array = NULL;
+    return 0;
+}
+
+unsigned int graph_version(const Graph *graph) {
+    return graph ? graph->version : 0;
+}
+
+unsigned int graph_order_version(const Graph *graph) {
+    return graph ? graph->orderVersion : 0;
+}
+
+int graph_to_internal(const Graph *graph, int id) {
+    if (!graph || id < 0 || id >= graph->numVertices) {
+        return -1;
+    }
+
+    return graph->toInternal ? graph->toInternal[id] : id;
+}
+
+int graph_to_external(const Graph *graph, int v) {
+    if (!graph || v < 0 || v >= graph->numVertices) {
+        return -1;
+    }
+
+    return graph->toExternal ? graph->toExternal[v] : v;
+}
+
+/* ============================================================================
+   Name index – linear probing, sized once for numVertices names so it never
+   grows; deletions use backward shifting instead of tombstones
+   ========================================================================== */
+
+static unsigned int name_hash(const char *name) {
+    /* FNV-1a */
+    unsigned int h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* Chunk holding a pool offset: the k with chunk_start(k) ≤ offset < chunk_start(k + 1) */
+static int name_chunk_of(uint32_t offset) {
+    return 31 - __builtin_clz(offset / GRAPH_NAME_CHUNK_MIN + 1);
+}
+
+static const char *name_pool_get(const NamePool *pool, uint32_t offset) {
+    int k = name_chunk_of(offset);
+    return pool->chunks[k] + (offset - graph_name_chunk_start(k));
+}
+
+static const char *name_at(const Graph *graph, int id) {
+    return name_pool_get(&graph->names, graph->nameOffsets[id]);
+}
+
+static void name_pool_free(NamePool *pool) {
+    for (int k = 0; k < GRAPH_NAME_CHUNKS; k++) {
+        free(pool->chunks[k]);
+    }
+    memset(pool, 0, sizeof(*pool));
+}
+
+/*
+ * Appends a string to the pool; returns its offset or GRAPH_NO_NAME on failure.
+ * A name that does not fit the rest of the current chunk starts the next one
+ * (a long name skips ahead to the first chunk it fits in), so existing chunks
+ * are never reallocated. Chunks are zeroed, so skipped tails save as zeros.
+ */
+static uint32_t name_pool_append(NamePool *pool, const char *name) {
+    size_t len = strlen(name) + 1;
+    uint64_t offset = pool->size;
+    int k = name_chunk_of(pool->size);
+
+    while (offset + len > graph_name_chunk_start(k + 1)) {
+        offset = graph_name_chunk_start(++k);
+        if (k >= GRAPH_NAME_CHUNKS) {
+            return GRAPH_NO_NAME;
+        }
+    }
+
+    for (int j = name_chunk_of(pool->size); j <= k; j++) {
+        if (!pool->chunks[j] && !(pool->chunks[j] = calloc(GRAPH_NAME_CHUNK_MIN << j, 1))) {
+            return GRAPH_NO_NAME;
+        }
+    }
+
+    memcpy(pool->chunks[k] + (offset - graph_name_chunk_start(k)), name, len);
+    pool->size = (uint32_t)(offset + len);
+    return (uint32_t)offset;
+}
+
+static int name_index_alloc(Graph *graph) {
+    size_t cap = 2;
+    while (cap < 2 * (size_t)graph->numVertices) {
+        cap <<= 1;
+    }
+    if (cap > (size_t)INT_MAX + 1) {
+        return -1;
+    }
+
+    NameSlot *slots = malloc(cap * sizeof(NameSlot));
+    if (!slots) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < cap; i++) {
+        slots[i].vertex = -1;
+    }
+
+    free(graph->nameIndex);
+    graph->nameIndex = slots;
+    graph->nameIndexMask = (int)(cap - 1);
+    return 0;
+}
+
+static void name_index_insert(Graph *graph, int id) {
+    unsigned int h = name_hash(name_at(graph, id));
+    int i = (int)(h & (unsigned int)graph->nameIndexMask);
+
+    while (graph->nameIndex[i].vertex != -1) {
+        i = (i + 1) & graph->nameIndexMask;
+    }
+
+    graph->nameIndex[i].hash = h;
+    graph->nameIndex[i].vertex = id;
+}
+
+static void name_index_remove(Graph *graph, int id) {
+    unsigned int mask = (unsigned int)graph->nameIndexMask;
+    unsigned int i = name_hash(name_at(graph, id)) & mask;
+
+    while (graph->nameIndex[i].vertex != id) {
+        if (graph->nameIndex[i].vertex == -1) {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+
+    /* Shift later members of the probe run back into the hole */
+    unsigned int hole = i;
+    for (unsigned int j = (i + 1) & mask; graph->nameIndex[j].vertex != -1; j = (j + 1) & mask) {
+        unsigned int home = graph->nameIndex[j].hash & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            graph->nameIndex[hole] = graph->nameIndex[j];
+            hole = j;
+        }
+    }
+    graph->nameIndex[hole].vertex = -1;
+}
+
+int graph_build_name_index(Graph *graph) {
+    if (!graph) {
+        return -1;
+    }
+
+    if (graph->mapping) {
+        /* Snapshots carry their index; it cannot be rebuilt in read-only memory */
+        return graph->nameIndex ? 0 : -1;
+    }
+
+    /* Failure keeps the old pool, which is still correct */
+    graph_compact_names(graph);
+
+    if (name_index_alloc(graph) != 0) {
+        free(graph->nameIndex);
+        graph->nameIndex = NULL;
+        return -1;
+    }
+
+    for (int i = 0; i < graph->numVertices; i++) {
+        if (graph->nameOffsets[i] != GRAPH_NO_NAME) {
+            name_index_insert(graph, i);
+        }
+    }
+    return 0;
+}
+
+int graph_compact_names(Graph *graph) {
+    if (!graph || graph->mapping) {
+        return -1;
+    }
+    if (graph->names.garbage == 0) {
+        return 0;
+    }
+
+    int n = graph->numVertices;
+    uint32_t *offsets = malloc(n * sizeof(uint32_t));
+    NamePool fresh = {0};
+    if (!offsets) {
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) {
+        uint32_t old = graph->nameOffsets[v];
+        if (old == GRAPH_NO_NAME) {
+            offsets[v] = GRAPH_NO_NAME;
+            continue;
+        }
+
+        /* Vertices sharing a pooled name keep sharing its copy */
+        int twin = graph->nameIndex ? graph_find_vertex_by_name(graph, name_at(graph, v)) : -1;
+        offsets[v] = twin >= 0 && twin < v && graph->nameOffsets[twin] == old
+                     ? offsets[twin] : name_pool_append(&fresh, name_at(graph, v));
+        if (offsets[v] == GRAPH_NO_NAME) {
+            name_pool_free(&fresh);
+            free(offsets);
+            return -1;
+        }
+    }
+
+    name_pool_free(&graph->names);
+    graph->names = fresh;
+    free(graph->nameOffsets);
+    graph->nameOffsets = offsets;
+    return 0;
+}
+
+/* Counts a replaced name as garbage once no vertex uses its pooled copy */
+static void name_release(Graph *graph, uint32_t offset) {
+    const char *name = name_pool_get(&graph->names, offset);
+    int twin = graph_find_vertex_by_name(graph, name);
+    if (twin < 0 || graph->nameOffsets[twin] != offset) {
+        graph->names.garbage += (uint32_t)strlen(name) + 1;
+    }
+}
+
 void graphSetName(Graph *graph, int id, const char *name) {
-    if (!graph || !name || id < 0 || id >= graph->numVertices) {
+    if (!graph || id < 0 || id >= graph->numVertices || graph->mapping) {
+        return;
+    }
+
+    uint32_t old = graph->nameOffsets[id];
+    uint32_t offset = GRAPH_NO_NAME;
+    if (name) {
+        /* Reuse the pooled copy if another vertex already has this name */
+        int twin = graph_find_vertex_by_name(graph, name);
+        offset = twin >= 0 ? graph->nameOffsets[twin] : name_pool_append(&graph->names, name);
+        if (offset == GRAPH_NO_NAME) {
+            return;
+        }
+    }
+    if (offset == old) {
         return;
     }
 
-    free(graph->names[id]);
-    graph->names[id] = strdup(name);
+    if (!graph->nameIndex && name_index_alloc(graph) != 0) {
+        /* Keep names correct; lookups fall back to scanning */
+        graph->nameOffsets[id] = offset;
+        return;
+    }
+
+    if (old != GRAPH_NO_NAME) {
+        name_index_remove(graph, id);
+    }
+    graph->nameOffsets[id] = offset;
+    if (offset != GRAPH_NO_NAME) {
+        name_index_insert(graph, id);
+    }
+    if (old != GRAPH_NO_NAME) {
+        name_release(graph, old);
+    }
 }
 
 const char *graphGetName(const Graph *graph, int id) {
@@ -88,7 +934,38 @@ const char *graphGetName(const Graph *graph, int id) {
         return NULL;
     }
 
-    return graph->names[id];
+    uint32_t offset = graph->nameOffsets[id];
+    if (offset == GRAPH_NO_NAME || offset >= graph->names.size) {
+        return NULL;
+    }
+
+    return name_pool_get(&graph->names, offset);
+}
+
+void graphSetCoordinates(Graph *graph, int id, double x, double y) {
+    if (!graph || id < 0 || id >= graph->numVertices || graph->mapping) {
+        return;
+    }
+
+    if (!graph->coords) {
+        graph->coords = calloc(2 * (size_t)graph->numVertices, sizeof(double));
+        if (!graph->coords) {
+            return;
+        }
+    }
+
+    graph->coords[2 * id] = x;
+    graph->coords[2 * id + 1] = y;
+}
+
+int graphGetCoordinates(const Graph *graph, int id, double *x, double *y) {
+    if (!graph || !graph->coords || id < 0 || id >= graph->numVertices) {
+        return 0;
+    }
+
+    if (x) *x = graph->coords[2 * id];
+    if (y) *y = graph->coords[2 * id + 1];
+    return 1;
 }
 
 int graph_find_vertex_by_name(const Graph *graph, const char *name) {
@@ -96,14 +973,30 @@ int graph_find_vertex_by_name(const Graph *graph, const char *name) {
         return -1;
     }
 
-    for (int i = 0; i < graph->numVertices; i++) {
-        if (graph->names[i] &&
-            strcmp(graph->names[i], name) == 0) {
-            return i;
+    if (!graph->nameIndex) {
+        for (int i = 0; i < graph->numVertices; i++) {
+            const char *candidate = graphGetName(graph, i);
+            if (candidate && strcmp(candidate, name) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    unsigned int h = name_hash(name);
+    int i = (int)(h & (unsigned int)graph->nameIndexMask);
+    int found = -1;
+
+    /* Duplicate names share a probe run; report the lowest ID like a scan would */
+    for (; graph->nameIndex[i].vertex != -1; i = (i + 1) & graph->nameIndexMask) {
+        int v = graph->nameIndex[i].vertex;
+        if (graph->nameIndex[i].hash == h && (found == -1 || v < found) &&
+            strcmp(name_at(graph, v), name) == 0) {
+            found = v;
         }
     }
 
-    return -1;
+    return found;
 }
 
 void printGraph(const Graph *graph) {
@@ -117,13 +1010,24 @@ void printGraph(const Graph *graph) {
         }
 
         printf(": ");
-        int first = 1;
-        for (Edge *e = graph->array[i].head; e != NULL; e = e->next) {
-            if (!first) {
-                printf(" ");
+        if (graph->frozen) {
+            GraphEdgeIter it;
+            int v = graph_to_internal(graph, i);
+            int first = 1;
+            for (graph_edges_begin(graph, v, &it); graph_edges_next(&it); ) {
+                printf("%s-> %d(w=%lld)", first ? "" : " ",
+                       graph_to_external(graph, it.to), it.weight);
+                first = 0;
+            }
+        } else {
+            int first = 1;
+            for (Edge *e = graph->array[i].head; e != NULL; e = e->next) {
+                if (!first) {
+                    printf(" ");
+                }
+                printf("-> %d(w=%lld)", e->to, e->weight);
+                first = 0;
             }
-            printf("-> %d(w=%d)", e->to, e->weight);
-            first = 0;
         }
         printf("\n");
     }
@@ -132,17 +1036,35 @@ void printGraph(const Graph *graph) {
 void graph_free(Graph *graph) {
     if (!graph) return;
 
-    for (int i = 0; i < graph->numVertices; i++) {
-        Edge *current = graph->array[i].head;
-        while (current) {
-            Edge *temp = current;
-            current = current->next;
-            free(temp);
+    EdgeChunk *chunk = graph->edgeChunks;
+    while (chunk) {
+        EdgeChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    graph_delta_free(graph);
+    reverse_drop(graph);
+    compressed_drop(graph);
+
+    if (!graph->csrInMapping) {
+        csr_free(&graph->csr);
+    }
+
+    if (graph->mapping) {
+        /* Names and the name index live inside the mapping */
+        if (graph->unmap) {
+            graph->unmap(graph->mapping, graph->mappingSize);
         }
-        free(graph->names[i]);
+    } else {
+        name_pool_free(&graph->names);
+        free(graph->nameOffsets);
+        free(graph->nameIndex);
+        free(graph->toInternal);
+        free(graph->toExternal);
+        free(graph->coords);
     }
 
     free(graph->array);
-    free(graph->names);
     free(graph);
 }
\ No newline at end of file
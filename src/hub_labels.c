@@ -0,0 +1,380 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "../include/hub_labels.h"
+#include "../include/pqueue.h"
+
+/* Tentative distance of a vertex the current search has not reached */
+#define HUB_UNSEEN LLONG_MAX
+
+/* ============================================================================
+   Pruned landmark labeling
+   ========================================================================== */
+
+typedef struct {
+    int *hubs;
+    long long *dists;
+    int *link;          /* next (forward labels) / prev (backward labels) */
+    int size;
+    int capacity;
+} LabelList;
+
+typedef struct {
+    Graph *graph;
+    const GraphCSR *rev;
+    PQueue *pq;
+    long long *dist;
+    int *parent;
+    int *touched;       /* vertices whose dist must be reset after a search */
+    long long *rootLabel; /* per hub ID: the root's own entry, HUB_UNSEEN if none */
+    LabelList *fwd;
+    LabelList *bwd;
+} HubBuilder;
+
+static int label_push(LabelList *label, int hub, long long dist, int link) {
+    if (label->size == label->capacity) {
+        int capacity = label->capacity ? label->capacity * 2 : 4;
+        int *hubs = realloc(label->hubs, capacity * sizeof(int));
+        if (hubs) label->hubs = hubs;
+        long long *dists = realloc(label->dists, capacity * sizeof(long long));
+        if (dists) label->dists = dists;
+        int *links = realloc(label->link, capacity * sizeof(int));
+        if (links) label->link = links;
+        if (!hubs || !dists || !links) return -1;
+        label->capacity = capacity;
+    }
+    label->hubs[label->size] = hub;
+    label->dists[label->size] = dist;
+    label->link[label->size] = link;
+    label->size++;
+    return 0;
+}
+
+/* Whether the labels built so far already give a path of length ≤ d */
+static int hub_covered(const HubBuilder *b, const LabelList *label, long long d) {
+    for (int i = 0; i < label->size; i++) {
+        long long r = b->rootLabel[label->hubs[i]];
+        if (r != HUB_UNSEEN && label->dists[i] + r <= d) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Adds hub `hub` (vertex root) to every label it is needed in. The backward
+ * search finds dist(v, root) for forward labels, the forward search
+ * dist(root, v) for backward labels. A vertex already covered by earlier hubs
+ * is neither labelled nor expanded, so every labelled vertex's link is
+ * labelled with the same hub.
+ */
+static int hub_pruned_search(HubBuilder *b, int hub, int root, int backward) {
+    LabelList *own = backward ? b->fwd : b->bwd;
+    const LabelList *other = backward ? &b->bwd[root] : &b->fwd[root];
+    int num_touched = 0, failed = 0;
+
+    for (int i = 0; i < other->size; i++) {
+        b->rootLabel[other->hubs[i]] = other->dists[i];
+    }
+
+    pqueue_clear(b->pq);
+    b->dist[root] = 0;
+    b->parent[root] = -1;
+    b->touched[num_touched++] = root;
+    failed = pqueue_push(b->pq, root, 0) != 0;
+
+    int u, popped = 0;
+    long long du;
+    while (!failed && (popped = pqueue_pop(b->pq, &u, &du)) == 0) {
+        if (hub_covered(b, &own[u], du)) {
+            continue;
+        }
+        if (label_push(&own[u], hub, du, b->parent[u]) != 0) {
+            failed = 1;
+            break;
+        }
+
+        GraphEdgeIter it;
+        if (backward) {
+            graph_reverse_edges_begin(b->graph, b->rev, u, &it);
+        } else {
+            graph_edges_begin(b->graph, u, &it);
+        }
+        while (graph_edges_next(&it)) {
+            if (it.weight < 0) {
+                failed = 1;
+                break;
+            }
+            long long nd = du + it.weight;
+            if (b->dist[it.to] != HUB_UNSEEN && nd >= b->dist[it.to]) {
+                continue;
+            }
+            if (b->dist[it.to] == HUB_UNSEEN) {
+                b->touched[num_touched++] = it.to;
+            }
+            b->dist[it.to] = nd;
+            b->parent[it.to] = u;
+            if (pqueue_push(b->pq, it.to, nd) != 0) {
+                failed = 1;
+                break;
+            }
+        }
+    }
+    failed = failed || popped == PQUEUE_NO_MEMORY;
+
+    pqueue_clear(b->pq);
+    for (int i = 0; i < num_touched; i++) {
+        b->dist[b->touched[i]] = HUB_UNSEEN;
+    }
+    for (int i = 0; i < other->size; i++) {
+        b->rootLabel[other->hubs[i]] = HUB_UNSEEN;
+    }
+    return failed ? -1 : 0;
+}
+
+/* Copies per-vertex labels into flat arrays, each label closed by HUB_LABEL_END */
+static int hub_flatten(const LabelList *lists, int n, int **offsets, int **hubs, long long **dists, int **links,
+                       long long *num_entries) {
+    long long total = 0;
+    for (int v = 0; v < n; v++) {
+        total += lists[v].size + 1;
+    }
+    if (total > INT_MAX) {
+        return -1;
+    }
+
+    *offsets = malloc((n + 1) * sizeof(int));
+    *hubs = malloc(total * sizeof(int));
+    *dists = malloc(total * sizeof(long long));
+    *links = malloc(total * sizeof(int));
+    if (!*offsets || !*hubs || !*dists || !*links) {
+        return -1;
+    }
+
+    int pos = 0;
+    for (int v = 0; v < n; v++) {
+        const LabelList *l = &lists[v];
+        (*offsets)[v] = pos;
+        if (l->size > 0) {
+            memcpy(*hubs + pos, l->hubs, l->size * sizeof(int));
+            memcpy(*dists + pos, l->dists, l->size * sizeof(long long));
+            memcpy(*links + pos, l->link, l->size * sizeof(int));
+        }
+        pos += l->size;
+        (*hubs)[pos] = HUB_LABEL_END;
+        (*dists)[pos] = 0;
+        (*links)[pos] = -1;
+        pos++;
+    }
+    (*offsets)[n] = pos;
+    *num_entries += total - n;
+    return 0;
+}
+
+HubLabels *hub_labels_build(Graph *graph, const ContractionHierarchy *order) {
+    if (!graph || !order || order->numVertices != graph->numVertices || graph->numVertices <= 0 ||
+        graph_freeze(graph) != 0) {
+        return NULL;
+    }
+
+    const GraphCSR *rev = graph_reverse(graph);
+    int n = graph->numVertices;
+    HubLabels *hl = calloc(1, sizeof(HubLabels));
+    long long max_weight = graph_max_weight(graph);
+    HubBuilder b = {0};
+    b.graph = graph;
+    b.rev = rev;
+    b.pq = pqueue_create(max_weight >= 0 ? pqueue_kind_for_max_weight(max_weight) : PQ_BINARY_HEAP, n, max_weight);
+    b.dist = malloc(n * sizeof(long long));
+    b.parent = malloc(n * sizeof(int));
+    b.touched = malloc(n * sizeof(int));
+    b.rootLabel = malloc(n * sizeof(long long));
+    b.fwd = calloc(n, sizeof(LabelList));
+    b.bwd = calloc(n, sizeof(LabelList));
+    if (hl) {
+        hl->numVertices = n;
+        hl->graphVersion = graph_version(graph);
+        hl->hubVertex = malloc(n * sizeof(int));
+    }
+
+    int ok = rev && hl && hl->hubVertex && b.pq && b.dist && b.parent && b.touched && b.rootLabel && b.fwd && b.bwd;
+    if (ok) {
+        for (int v = 0; v < n; v++) {
+            b.dist[v] = HUB_UNSEEN;
+            b.rootLabel[v] = HUB_UNSEEN;
+        }
+    }
+
+    /* Most important first: hub IDs grow as labels are appended, so labels stay sorted */
+    for (int hub = 0; ok && hub < n; hub++) {
+        int root = order->vertexAt[n - 1 - hub];
+        hl->hubVertex[hub] = root;
+        ok = hub_pruned_search(&b, hub, root, 1) == 0 && hub_pruned_search(&b, hub, root, 0) == 0;
+    }
+
+    ok = ok && hub_flatten(b.fwd, n, &hl->fwdOffsets, &hl->fwdHubs, &hl->fwdDists, &hl->fwdNext, &hl->numEntries) == 0;
+    ok = ok && hub_flatten(b.bwd, n, &hl->bwdOffsets, &hl->bwdHubs, &hl->bwdDists, &hl->bwdPrev, &hl->numEntries) == 0;
+
+    for (int v = 0; v < n && b.fwd && b.bwd; v++) {
+        free(b.fwd[v].hubs);
+        free(b.fwd[v].dists);
+        free(b.fwd[v].link);
+        free(b.bwd[v].hubs);
+        free(b.bwd[v].dists);
+        free(b.bwd[v].link);
+    }
+    free(b.fwd);
+    free(b.bwd);
+    free(b.dist);
+    free(b.parent);
+    free(b.touched);
+    free(b.rootLabel);
+    pqueue_destroy(b.pq);
+
+    if (!ok) {
+        hub_labels_free(hl);
+        return NULL;
+    }
+    return hl;
+}
+
+void hub_labels_free(HubLabels *hl) {
+    if (!hl) {
+        return;
+    }
+    free(hl->hubVertex);
+    free(hl->fwdOffsets);
+    free(hl->fwdHubs);
+    free(hl->fwdDists);
+    free(hl->fwdNext);
+    free(hl->bwdOffsets);
+    free(hl->bwdHubs);
+    free(hl->bwdDists);
+    free(hl->bwdPrev);
+    free(hl);
+}
+
+/* ============================================================================
+   Queries
+   ========================================================================== */
+
+/* Best common hub of the forward label of s and the backward label of t */
+static long long hub_merge(const HubLabels *hl, int s, int t, int *out_hub) {
+    const int *a = hl->fwdHubs + hl->fwdOffsets[s];
+    const int *b = hl->bwdHubs + hl->bwdOffsets[t];
+    const long long *da = hl->fwdDists + hl->fwdOffsets[s];
+    const long long *db = hl->bwdDists + hl->bwdOffsets[t];
+    long long best = -1;
+    int best_hub = -1;
+
+    /* Both labels end in HUB_LABEL_END, so only the equal case checks for the end */
+    int i = 0, j = 0;
+    for (;;) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            if (a[i] == HUB_LABEL_END) break;
+            long long d = da[i] + db[j];
+            if (best < 0 || d < best) {
+                best = d;
+                best_hub = a[i];
+            }
+            i++;
+            j++;
+        }
+    }
+
+    if (out_hub) *out_hub = best_hub;
+    return best;
+}
+
+/* Index of hub in the label [begin, end) (sentinel included), -1 if absent */
+static int hub_find(const int *hubs, int begin, int end, int hub) {
+    int lo = begin, hi = end - 2;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (hubs[mid] == hub) return mid;
+        if (hubs[mid] < hub) lo = mid + 1; else hi = mid - 1;
+    }
+    return -1;
+}
+
+long long hub_labels_distance(const HubLabels *hl, const Graph *graph, int start, int goal) {
+    if (!hl || !graph || hl->numVertices != graph->numVertices || graph_version(graph) != hl->graphVersion) {
+        return -1;
+    }
+    int s = graph_to_internal(graph, start);
+    int t = graph_to_internal(graph, goal);
+    if (s < 0 || t < 0) {
+        return -1;
+    }
+    if (s == t) {
+        return 0;
+    }
+    return hub_merge(hl, s, t, NULL);
+}
+
+int hub_labels_shortest_path(const HubLabels *hl, const Graph *graph, int start, int goal,
+                             int *out_path, int max_path_len, long long *out_distance) {
+    if (!hl || !graph || !out_path || !out_distance || hl->numVertices != graph->numVertices ||
+        graph_version(graph) != hl->graphVersion || max_path_len < 1) {
+        if (out_distance) *out_distance = -1;
+        return 0;
+    }
+    *out_distance = -1;
+
+    int s = graph_to_internal(graph, start);
+    int t = graph_to_internal(graph, goal);
+    if (s < 0 || t < 0) {
+        return 0;
+    }
+    if (s == t) {
+        out_path[0] = start;
+        *out_distance = 0;
+        return 1;
+    }
+
+    int hub;
+    long long d = hub_merge(hl, s, t, &hub);
+    if (d < 0) {
+        return 0;
+    }
+    int h = hl->hubVertex[hub];
+
+    /* s → hub, following the successors stored in forward labels */
+    int len = 0;
+    int x = s;
+    out_path[len++] = start;
+    while (x != h) {
+        int i = hub_find(hl->fwdHubs, hl->fwdOffsets[x], hl->fwdOffsets[x + 1], hub);
+        if (i < 0 || len >= max_path_len) {
+            return 0;
+        }
+        x = hl->fwdNext[i];
+        out_path[len++] = graph_to_external(graph, x);
+    }
+
+    /* hub → t, walked backwards from t through the predecessors: count, then fill */
+    int tail = 0;
+    for (x = t; x != h; tail++) {
+        int i = hub_find(hl->bwdHubs, hl->bwdOffsets[x], hl->bwdOffsets[x + 1], hub);
+        if (i < 0 || tail >= hl->numVertices) {
+            return 0;
+        }
+        x = hl->bwdPrev[i];
+    }
+    if (len + tail > max_path_len) {
+        return 0;
+    }
+    x = t;
+    for (int k = len + tail - 1; k >= len; k--) {
+        out_path[k] = graph_to_external(graph, x);
+        x = hl->bwdPrev[hub_find(hl->bwdHubs, hl->bwdOffsets[x], hl->bwdOffsets[x + 1], hub)];
+    }
+
+    *out_distance = d;
+    return len + tail;
+}
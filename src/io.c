@@ -2,6 +2,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "../include/graph.h"
 #include "../include/algorithms.h"
@@ -66,6 +77,15 @@ Graph *load_graph_from_file(const char *filename) {
         fclose(fp);
         return NULL;
     }
+
+    /* Undirected files store every edge twice */
+    int edge_slots = directed ? num_edges : 2 * num_edges;
+    if (num_edges > INT_MAX / 2 || graph_reserve_edges(g, edge_slots) != 0) {
+        io_print_error("Edge storage allocation failed");
+        graph_free(g);
+        fclose(fp);
+        return NULL;
+    }
     
     for (int i = 0; i < num_vertices; i++) {
         if (!read_data_line(fp, buf, sizeof(buf), &line)) {
@@ -77,20 +97,25 @@ Graph *load_graph_from_file(const char *filename) {
         
         int id;
         char name[256];
-        if (sscanf(buf, "%d %255s", &id, name) != 2 ||
-            id < 0 || id >= num_vertices) {
+        double x, y;
+        int vfields = sscanf(buf, "%d %255s %lf %lf", &id, name, &x, &y);
+        if (vfields < 2 || id < 0 || id >= num_vertices) {
             parse_error("Invalid vertex definition", line);
             graph_free(g);
             fclose(fp);
             return NULL;
         }
         graphSetName(g, id, name);
+        if (vfields == 4) {
+            graphSetCoordinates(g, id, x, y);
+        }
     }
     
     int edges_read = 0;
     while (edges_read < num_edges && read_data_line(fp, buf, sizeof(buf), &line)) {
-        int from, to, weight;
-        if (sscanf(buf, "%d %d %d", &from, &to, &weight) != 3 ||
+        int from, to;
+        long long weight;
+        if (sscanf(buf, "%d %d %lld", &from, &to, &weight) != 3 ||
             from < 0 || from >= num_vertices ||
             to < 0 || to >= num_vertices) {
             parse_error("Invalid edge definition", line);
@@ -111,9 +136,497 @@ Graph *load_graph_from_file(const char *filename) {
     }
     
     fclose(fp);
+
+    if (graph_freeze(g) != 0) {
+        io_print_error("Graph freeze failed");
+        graph_free(g);
+        return NULL;
+    }
+
     return g;
 }
 
+/* ============================================================================
+   Binary snapshot (memory-mapped)
+
+   Layout: SnapshotHeader, then 8-byte aligned sections
+     offsets[numVertices + 1]  int32
+     targets[numEdges]         int32
+     weights[numEdges]         int16/int32/int64 (weightBits)
+     name_offsets[numVertices] uint32 (GRAPH_NO_NAME if unnamed)
+     names[namesSize]          the graph's name pool, as-is
+     name_index[nameIndexCap]  NameSlot hash table over the pool
+     to_external[numVertices]  int32   (SNAPSHOT_HAS_ORDER)
+     to_internal[numVertices]  int32   (SNAPSHOT_HAS_ORDER)
+     coords[2 * numVertices]   double  (SNAPSHOT_HAS_COORDS)
+   CSR sections are stored in internal order.
+   ========================================================================== */
+
+#define SNAPSHOT_MAGIC    "RPSNAP\0\0"
+#define SNAPSHOT_VERSION  4u
+#define SNAPSHOT_ENDIAN   0x01020304u
+
+#define SNAPSHOT_HAS_ORDER   0x1u
+#define SNAPSHOT_HAS_COORDS  0x2u
+#define SNAPSHOT_SYMMETRIC   0x4u    /* every edge has its reverse twin */
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t endian;
+    int32_t  numVertices;
+    int32_t  numEdges;
+    uint64_t offsetsPos;
+    uint64_t targetsPos;
+    uint64_t weightsPos;
+    uint64_t nameOffsetsPos;
+    uint64_t namesPos;
+    uint64_t namesSize;
+    uint64_t nameIndexPos;
+    uint64_t nameIndexCap;
+    uint64_t toExternalPos;
+    uint64_t toInternalPos;
+    uint64_t coordsPos;
+    uint32_t flags;
+    uint16_t weightBits;     /* width of each stored weight: 16, 32 or 64 */
+    uint16_t distBits;       /* distance width chosen at freeze: 16, 32 or 64 */
+    uint64_t fileSize;
+} SnapshotHeader;
+
+static uint64_t align8(uint64_t pos) {
+    return (pos + 7u) & ~(uint64_t)7u;
+}
+
+static int write_padded(FILE *fp, const void *data, size_t size, uint64_t *pos) {
+    static const char zeros[8] = {0};
+    uint64_t aligned = align8(*pos);
+
+    if (aligned > *pos && fwrite(zeros, 1, (size_t)(aligned - *pos), fp) != aligned - *pos) {
+        return -1;
+    }
+    if (size > 0 && fwrite(data, 1, size, fp) != size) {
+        return -1;
+    }
+
+    *pos = aligned + size;
+    return 0;
+}
+
+int save_graph_snapshot(Graph *g, const char *filename) {
+    if (!g || !filename) {
+        io_print_error("Invalid graph or snapshot filename");
+        return -1;
+    }
+
+    if (graph_freeze(g) != 0) {
+        io_print_error("Graph freeze failed");
+        return -1;
+    }
+
+    if (g->compressed) {
+        io_print_error("Snapshots store the plain layout; save before compressing");
+        return -1;
+    }
+
+    /* The index is part of the file so loading never has to hash names */
+    if (!g->nameIndex && graph_build_name_index(g) != 0) {
+        io_print_error("Name index allocation failed");
+        return -1;
+    }
+
+    int n = g->numVertices;
+    const GraphCSR *csr = &g->csr;
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        io_print_error("Failed to open snapshot file for writing");
+        return -1;
+    }
+
+    SnapshotHeader hdr = {0};
+    memcpy(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic));
+    hdr.version     = SNAPSHOT_VERSION;
+    hdr.endian      = SNAPSHOT_ENDIAN;
+    hdr.numVertices = n;
+    hdr.numEdges    = csr->numEdges;
+    hdr.weightBits  = (uint16_t)csr->weightBits;
+    hdr.distBits    = (uint16_t)g->distBits;
+
+    /* Reserve the header, fill in section positions as they are written */
+    uint64_t pos = 0;
+    int rc = write_padded(fp, &hdr, sizeof(hdr), &pos);
+
+    hdr.offsetsPos = align8(pos);
+    if (rc == 0) rc = write_padded(fp, csr->offsets, (n + 1) * sizeof(int32_t), &pos);
+    hdr.targetsPos = align8(pos);
+    if (rc == 0) rc = write_padded(fp, csr->targets, csr->numEdges * sizeof(int32_t), &pos);
+    hdr.weightsPos = align8(pos);
+    if (rc == 0) rc = write_padded(fp, csr->weights, (size_t)csr->numEdges * (csr->weightBits / 8), &pos);
+    hdr.nameOffsetsPos = align8(pos);
+    if (rc == 0) rc = write_padded(fp, g->nameOffsets, n * sizeof(uint32_t), &pos);
+    hdr.namesPos = align8(pos);
+    hdr.namesSize = g->names.size;
+    /* Chunks are laid out end to end, so offsets into the file section match the pool's */
+    for (int k = 0; rc == 0 && graph_name_chunk_start(k) < g->names.size; k++) {
+        uint64_t end = graph_name_chunk_start(k + 1) < g->names.size ? graph_name_chunk_start(k + 1) : g->names.size;
+        rc = write_padded(fp, g->names.chunks[k], (size_t)(end - graph_name_chunk_start(k)), &pos);
+    }
+    hdr.nameIndexPos = align8(pos);
+    hdr.nameIndexCap = (uint64_t)g->nameIndexMask + 1;
+    if (rc == 0) rc = write_padded(fp, g->nameIndex, hdr.nameIndexCap * sizeof(NameSlot), &pos);
+
+    if (g->toExternal) {
+        hdr.flags |= SNAPSHOT_HAS_ORDER;
+        hdr.toExternalPos = align8(pos);
+        if (rc == 0) rc = write_padded(fp, g->toExternal, n * sizeof(int32_t), &pos);
+        hdr.toInternalPos = align8(pos);
+        if (rc == 0) rc = write_padded(fp, g->toInternal, n * sizeof(int32_t), &pos);
+    }
+    if (g->coords) {
+        hdr.flags |= SNAPSHOT_HAS_COORDS;
+        hdr.coordsPos = align8(pos);
+        if (rc == 0) rc = write_padded(fp, g->coords, 2 * n * sizeof(double), &pos);
+    }
+    if (g->symmetric) {
+        hdr.flags |= SNAPSHOT_SYMMETRIC;
+    }
+    hdr.fileSize = pos;
+
+    if (rc == 0 && (fseek(fp, 0, SEEK_SET) != 0 || fwrite(&hdr, sizeof(hdr), 1, fp) != 1)) {
+        rc = -1;
+    }
+
+    if (fclose(fp) != 0) {
+        rc = -1;
+    }
+
+    if (rc != 0) {
+        io_print_error("Failed to write snapshot file");
+    }
+    return rc;
+}
+
+#ifdef _WIN32
+
+static void *snapshot_map(const char *filename, size_t *size_out) {
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return NULL;
+    }
+
+    void *base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!base) {
+        return NULL;
+    }
+
+    *size_out = (size_t)size.QuadPart;
+    return base;
+}
+
+static void snapshot_unmap(void *base, size_t size) {
+    (void)size;
+    UnmapViewOfFile(base);
+}
+
+#else
+
+static void *snapshot_map(const char *filename, size_t *size_out) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    /* Shared read-only mapping: every planner process reuses the same page cache */
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    *size_out = (size_t)st.st_size;
+    return base;
+}
+
+static void snapshot_unmap(void *base, size_t size) {
+    munmap(base, size);
+}
+
+#endif
+
+static bool snapshot_section_ok(const SnapshotHeader *hdr, uint64_t pos, uint64_t size) {
+    return pos % 8 == 0 && pos >= sizeof(SnapshotHeader) &&
+           pos <= hdr->fileSize && size <= hdr->fileSize - pos;
+}
+
+/*
+ * One pass over the CSR: offsets must be monotone and every target a vertex.
+ * The distance width is recomputed rather than taken from the header.
+ */
+static bool snapshot_check_csr(const GraphCSR *csr, int n, int *dist_bits, long long *max_weight) {
+    long long max_w = 0;
+    unsigned long long bound = 0;
+
+    for (int v = 0; v < n; v++) {
+        if (csr->offsets[v] > csr->offsets[v + 1]) {
+            return false;
+        }
+        unsigned long long max_abs = 0;
+        for (int e = csr->offsets[v]; e < csr->offsets[v + 1]; e++) {
+            int to = csr->targets[e];
+            if (to < 0 || to >= n) {
+                return false;
+            }
+            long long w = graph_csr_weight(csr, e);
+            unsigned long long a = w < 0 ? 0ULL - (unsigned long long)w : (unsigned long long)w;
+            if (a > max_abs) max_abs = a;
+            if (w > max_w) max_w = w;
+        }
+        bound = bound > ULLONG_MAX - max_abs ? ULLONG_MAX : bound + max_abs;
+    }
+
+    int bits = graph_dist_bits_for_bound(bound);
+    *dist_bits = bits > *dist_bits ? bits : *dist_bits;
+    *max_weight = max_w;
+    return true;
+}
+
+typedef struct {
+    int32_t from;
+    int32_t to;
+    int64_t weight;
+} SnapshotEdge;
+
+static int snapshot_edge_cmp(const void *a, const void *b) {
+    const SnapshotEdge *x = a, *y = b;
+    if (x->from != y->from) return x->from < y->from ? -1 : 1;
+    if (x->to != y->to) return x->to < y->to ? -1 : 1;
+    return x->weight < y->weight ? -1 : x->weight > y->weight;
+}
+
+/*
+ * Exact check of the SNAPSHOT_SYMMETRIC claim: the edges (u, v, w) and their
+ * mirrors (v, u, w) must be the same multiset. A wrong claim would make
+ * graph_reverse() reuse the forward CSR as the transpose, so allocation
+ * failure counts as "not symmetric" (the transpose is then built).
+ */
+static bool snapshot_csr_symmetric(const GraphCSR *csr, int n) {
+    size_t m = (size_t)csr->numEdges;
+    SnapshotEdge *forward = malloc((m ? m : 1) * sizeof(SnapshotEdge));
+    SnapshotEdge *mirrored = malloc((m ? m : 1) * sizeof(SnapshotEdge));
+    bool same = forward && mirrored;
+
+    for (int v = 0; same && v < n; v++) {
+        for (int e = csr->offsets[v]; e < csr->offsets[v + 1]; e++) {
+            long long w = graph_csr_weight(csr, e);
+            forward[e] = (SnapshotEdge){ v, csr->targets[e], w };
+            mirrored[e] = (SnapshotEdge){ csr->targets[e], v, w };
+        }
+    }
+    if (same) {
+        qsort(forward, m, sizeof(SnapshotEdge), snapshot_edge_cmp);
+        qsort(mirrored, m, sizeof(SnapshotEdge), snapshot_edge_cmp);
+        for (size_t i = 0; same && i < m; i++) {
+            same = snapshot_edge_cmp(&forward[i], &mirrored[i]) == 0;
+        }
+    }
+
+    free(forward);
+    free(mirrored);
+    return same;
+}
+
+/* Names inside the pool, an index that only holds named vertices and has a free slot */
+static bool snapshot_check_names(const uint32_t *name_offsets, uint64_t names_size, const NameSlot *index,
+                                 uint64_t index_cap, int n) {
+    for (int v = 0; v < n; v++) {
+        if (name_offsets[v] != GRAPH_NO_NAME && name_offsets[v] >= names_size) {
+            return false;
+        }
+    }
+
+    bool has_free = false;
+    for (uint64_t i = 0; i < index_cap; i++) {
+        int v = index[i].vertex;
+        if (v == -1) {
+            has_free = true;
+        } else if (v < 0 || v >= n || name_offsets[v] == GRAPH_NO_NAME) {
+            return false;
+        }
+    }
+    return has_free;
+}
+
+/* to_external and to_internal must be inverse permutations */
+static bool snapshot_check_order(const int32_t *to_external, const int32_t *to_internal, int n) {
+    for (int v = 0; v < n; v++) {
+        int ext = to_external[v];
+        if (ext < 0 || ext >= n || to_internal[ext] != v) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int is_graph_snapshot_file(const char *filename) {
+    if (!filename) return 0;
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) return 0;
+
+    char magic[8];
+    int ok = fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+             memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+    fclose(fp);
+    return ok;
+}
+
+/*
+ * Maps a snapshot. The default path only checks the header and that every
+ * section lies inside the file, so loading costs O(1) no matter the graph
+ * size; checked adds the O(V + E log E) pass over the section contents.
+ */
+static Graph *snapshot_load(const char *filename, bool checked) {
+    if (!filename) {
+        io_print_error("No filename provided");
+        return NULL;
+    }
+
+    size_t size = 0;
+    unsigned char *base = snapshot_map(filename, &size);
+    if (!base) {
+        io_print_error("Failed to map snapshot file");
+        return NULL;
+    }
+
+    const SnapshotHeader *hdr = (const SnapshotHeader *)base;
+    uint64_t n = 0, m = 0;
+    bool valid = size >= sizeof(SnapshotHeader) &&
+                 memcmp(hdr->magic, SNAPSHOT_MAGIC, sizeof(hdr->magic)) == 0;
+
+    if (valid && (hdr->version != SNAPSHOT_VERSION || hdr->endian != SNAPSHOT_ENDIAN)) {
+        io_print_error("Unsupported snapshot version or byte order");
+        valid = false;
+    } else if (valid) {
+        n = hdr->numVertices > 0 ? (uint64_t)hdr->numVertices : 0;
+        m = hdr->numEdges >= 0 ? (uint64_t)hdr->numEdges : UINT64_MAX;
+        valid = n > 0 && m != UINT64_MAX && hdr->fileSize == size &&
+                (hdr->weightBits == 16 || hdr->weightBits == 32 || hdr->weightBits == 64) &&
+                (hdr->distBits == 16 || hdr->distBits == 32 || hdr->distBits == 64) &&
+                hdr->distBits >= hdr->weightBits &&
+                snapshot_section_ok(hdr, hdr->offsetsPos, (n + 1) * sizeof(int32_t)) &&
+                snapshot_section_ok(hdr, hdr->targetsPos, m * sizeof(int32_t)) &&
+                snapshot_section_ok(hdr, hdr->weightsPos, m * (hdr->weightBits / 8)) &&
+                snapshot_section_ok(hdr, hdr->nameOffsetsPos, n * sizeof(uint32_t)) &&
+                snapshot_section_ok(hdr, hdr->namesPos, hdr->namesSize) &&
+                hdr->namesSize < GRAPH_NO_NAME &&
+                (hdr->namesSize == 0 || base[hdr->namesPos + hdr->namesSize - 1] == '\0') &&
+                hdr->nameIndexCap >= 2 * n && hdr->nameIndexCap <= (uint64_t)INT_MAX + 1 &&
+                (hdr->nameIndexCap & (hdr->nameIndexCap - 1)) == 0 &&
+                snapshot_section_ok(hdr, hdr->nameIndexPos, hdr->nameIndexCap * sizeof(NameSlot)) &&
+                (!(hdr->flags & SNAPSHOT_HAS_ORDER) ||
+                 (snapshot_section_ok(hdr, hdr->toExternalPos, n * sizeof(int32_t)) &&
+                  snapshot_section_ok(hdr, hdr->toInternalPos, n * sizeof(int32_t)))) &&
+                (!(hdr->flags & SNAPSHOT_HAS_COORDS) ||
+                 snapshot_section_ok(hdr, hdr->coordsPos, 2 * n * sizeof(double)));
+    }
+
+    const int32_t *offsets = valid ? (const int32_t *)(base + hdr->offsetsPos) : NULL;
+    if (valid && (offsets[0] != 0 || (uint64_t)offsets[n] != m)) {
+        valid = false;
+    }
+
+    /* Header claims are trusted unless checked recomputes them */
+    GraphCSR csr = {0};
+    int dist_bits = valid ? hdr->distBits : 0;
+    int symmetric = valid && (hdr->flags & SNAPSHOT_SYMMETRIC) != 0;
+    long long max_weight = -1;
+    if (valid) {
+        csr.numEdges   = (int)m;
+        csr.weightBits = hdr->weightBits;
+        csr.offsets    = (int *)(base + hdr->offsetsPos);
+        csr.targets    = (int *)(base + hdr->targetsPos);
+        csr.weights    = base + hdr->weightsPos;
+    }
+    if (valid && checked) {
+        /* Everything a query indexes with */
+        valid = snapshot_check_csr(&csr, (int)n, &dist_bits, &max_weight) &&
+                snapshot_check_names((const uint32_t *)(base + hdr->nameOffsetsPos), hdr->namesSize,
+                                     (const NameSlot *)(base + hdr->nameIndexPos), hdr->nameIndexCap, (int)n) &&
+                (!(hdr->flags & SNAPSHOT_HAS_ORDER) ||
+                 snapshot_check_order((const int32_t *)(base + hdr->toExternalPos),
+                                      (const int32_t *)(base + hdr->toInternalPos), (int)n));
+        symmetric = valid && symmetric && snapshot_csr_symmetric(&csr, (int)n);
+    }
+
+    if (!valid) {
+        io_print_error("Invalid or corrupt snapshot file");
+        snapshot_unmap(base, size);
+        return NULL;
+    }
+
+    Graph *g = calloc(1, sizeof(Graph));
+    if (!g) {
+        io_print_error("Graph allocation failed");
+        snapshot_unmap(base, size);
+        return NULL;
+    }
+
+    g->numVertices    = (int)n;
+    g->array          = NULL;
+    g->names.size     = (uint32_t)hdr->namesSize;
+    g->nameOffsets    = (uint32_t *)(base + hdr->nameOffsetsPos);
+    g->nameIndex      = (NameSlot *)(base + hdr->nameIndexPos);
+    g->nameIndexMask  = (int)(hdr->nameIndexCap - 1);
+    g->csr            = csr;
+    g->toExternal     = (hdr->flags & SNAPSHOT_HAS_ORDER) ? (int *)(base + hdr->toExternalPos) : NULL;
+    g->toInternal     = (hdr->flags & SNAPSHOT_HAS_ORDER) ? (int *)(base + hdr->toInternalPos) : NULL;
+    g->coords         = (hdr->flags & SNAPSHOT_HAS_COORDS) ? (double *)(base + hdr->coordsPos) : NULL;
+    g->csrInMapping   = 1;
+    g->frozen         = 1;
+    g->version        = 1;
+    g->orderVersion   = 1;
+    g->symmetric      = symmetric;
+    g->distBits       = dist_bits;
+    g->maxWeight      = max_weight;
+    g->mapping        = base;
+    g->mappingSize    = size;
+    g->unmap          = snapshot_unmap;
+
+    /* The names section holds the pool chunks end to end; point each chunk into it */
+    for (int k = 0; k < GRAPH_NAME_CHUNKS && graph_name_chunk_start(k) < g->names.size; k++) {
+        g->names.chunks[k] = (char *)(base + hdr->namesPos + graph_name_chunk_start(k));
+    }
+    return g;
+}
+
+Graph *load_graph_snapshot(const char *filename) {
+    return snapshot_load(filename, false);
+}
+
+Graph *load_graph_snapshot_checked(const char *filename) {
+    return snapshot_load(filename, true);
+}
+
 /* ============================================================================
    PathResult wrappers for each algorithm
    ========================================================================== */
@@ -134,6 +647,7 @@ PathResult pathresult_from_bfs(Graph *g, int start, int goal) {
         res.path      = realloc(path, len * sizeof(int));
         res.path_len  = len;
         res.distance  = distance;
+        res.settled   = search_last_settled();
     } else {
         free(path);
     }
@@ -169,7 +683,7 @@ PathResult pathresult_from_dijkstra(Graph *g, int start, int goal) {
     int *path = malloc(bufsize * sizeof(int));
     if (!path) return res;
 
-    int distance = -1;
+    long long distance = -1;
     int len = dijkstra_shortest_path(g, start, goal, path, bufsize, &distance);
 
     if (len > 0 && len <= bufsize) {
@@ -177,6 +691,190 @@ PathResult pathresult_from_dijkstra(Graph *g, int start, int goal) {
         res.path      = realloc(path, len * sizeof(int));
         res.path_len  = len;
         res.distance  = distance;
+        res.settled   = search_last_settled();
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_bidirectional_dijkstra(Graph *g, int start, int goal) {
+    PathResult res = {0};
+    if (!g) return res;
+
+    int bufsize = g->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = bidirectional_dijkstra_shortest_path(g, start, goal, path, bufsize, &distance);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+        res.settled   = search_last_settled();
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_bidirectional_astar(Graph *g, int start, int goal, int (*heuristic)(int, int)) {
+    PathResult res = {0};
+    if (!g) return res;
+
+    int bufsize = g->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = bidirectional_astar_shortest_path(g, start, goal, path, bufsize, &distance, heuristic);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+        res.settled   = search_last_settled();
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_ch(Graph *g, const ContractionHierarchy *ch, int start, int goal) {
+    PathResult res = {0};
+    if (!g || !ch) return res;
+
+    int bufsize = g->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = ch_shortest_path(ch, g, start, goal, path, bufsize, &distance);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+        res.settled   = search_last_settled();
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_hub_labels(Graph *g, const HubLabels *hl, int start, int goal) {
+    PathResult res = {0};
+    if (!g || !hl) return res;
+
+    int bufsize = g->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = hub_labels_shortest_path(hl, g, start, goal, path, bufsize, &distance);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_arc_flags(Graph *g, const ArcFlags *af, int start, int goal) {
+    PathResult res = {0};
+    if (!g || !af) return res;
+
+    int bufsize = g->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = arc_flags_shortest_path(af, g, start, goal, path, bufsize, &distance);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+        res.settled   = search_last_settled();
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_crp(Graph *g, const CrpOverlay *crp, int start, int goal) {
+    PathResult res = {0};
+    if (!g || !crp) return res;
+
+    int bufsize = g->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = crp_shortest_path(crp, g, start, goal, path, bufsize, &distance);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+        res.settled   = search_last_settled();
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_tnr(Graph *g, const TransitNodeRouting *tnr, const ContractionHierarchy *ch,
+                               int start, int goal) {
+    PathResult res = {0};
+    if (!g || !tnr || !ch) return res;
+
+    int bufsize = g->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = tnr_shortest_path(tnr, ch, g, start, goal, path, bufsize, &distance);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+    } else {
+        free(path);
+    }
+    return res;
+}
+
+PathResult pathresult_from_session(SearchSession *session, int goal) {
+    PathResult res = {0};
+    if (!session) return res;
+
+    int bufsize = session->graph->numVertices + 1;
+    int *path = malloc(bufsize * sizeof(int));
+    if (!path) return res;
+
+    long long distance = -1;
+    int len = search_session_path(session, goal, path, bufsize, &distance);
+
+    if (len > 0 && len <= bufsize) {
+        res.found     = 1;
+        res.path      = realloc(path, len * sizeof(int));
+        res.path_len  = len;
+        res.distance  = distance;
+        res.settled   = session->lastSettled;
     } else {
         free(path);
     }
@@ -191,7 +889,7 @@ PathResult pathresult_from_astar(Graph *g, int start, int goal, int (*heuristic)
     int *path = malloc(bufsize * sizeof(int));
     if (!path) return res;
 
-    int distance = -1;
+    long long distance = -1;
     int len = astar_shortest_path(g, start, goal, path, bufsize, &distance, heuristic);
 
     if (len > 0 && len <= bufsize) {
@@ -199,6 +897,7 @@ PathResult pathresult_from_astar(Graph *g, int start, int goal, int (*heuristic)
         res.path      = realloc(path, len * sizeof(int));
         res.path_len  = len;
         res.distance  = distance;
+        res.settled   = search_last_settled();
     } else {
         free(path);
     }
@@ -213,7 +912,7 @@ PathResult pathresult_from_bellman_ford(Graph *g, int start, int goal) {
     int *path = malloc(bufsize * sizeof(int));
     if (!path) return res;
 
-    int distance = -1;
+    long long distance = -1;
     int len = bellman_ford_shortest_path(g, start, goal, path, bufsize, &distance);
 
     if (len > 0 && len <= bufsize) {
@@ -237,6 +936,7 @@ void pathresult_free(PathResult *res) {
     res->path = NULL;
     res->path_len = 0;
     res->distance = -1;
+    res->settled = 0;
     res->found = 0;
 }
 
@@ -261,19 +961,23 @@ void print_path_result(Graph *g, const PathResult *res, int algo_type) {
     printf("\n");
 
     if (algo_type == 1 || algo_type == 2) {
-        int hops = res->distance;
+        long long hops = res->distance;
 
-        int real_time = 0;
+        long long real_time = 0;
         bool all_edges_found = true;
+        bool frozen = graph_freeze(g) == 0;
+        GraphEdgeIter it;
 
-        for (int i = 0; i < res->path_len - 1; i++) {
+        for (int i = 0; frozen && i < res->path_len - 1; i++) {
             int u = res->path[i];
             int v = res->path[i + 1];
+            int iu = graph_to_internal(g, u);
+            int iv = graph_to_internal(g, v);
             bool edge_found = false;
 
-            for (Edge *e = g->array[u].head; e != NULL; e = e->next) {
-                if (e->to == v) {
-                    real_time += e->weight;
+            for (graph_edges_begin(g, iu, &it); graph_edges_next(&it); ) {
+                if (it.to == iv) {
+                    real_time += it.weight;
                     edge_found = true;
                     break;
                 }
@@ -286,9 +990,9 @@ void print_path_result(Graph *g, const PathResult *res, int algo_type) {
             }
         }
 
-        printf("Hops: %d → ", hops);
-        if (all_edges_found) {
-            printf("actual travel time along this path: %d minutes\n", real_time);
+        printf("Hops: %lld → ", hops);
+        if (frozen && all_edges_found) {
+            printf("actual travel time along this path: %lld minutes\n", real_time);
         } else {
             printf("could not calculate exact time (missing some edges)\n");
         }
@@ -296,7 +1000,11 @@ void print_path_result(Graph *g, const PathResult *res, int algo_type) {
         printf("Tip: For shortest travel time use Dijkstra or A* (option 3 or 4)\n");
     } 
     else {
-        printf("Travel time: %d minutes (optimal)\n", res->distance);
+        printf("Travel time: %lld minutes (optimal)\n", res->distance);
+    }
+
+    if (res->settled > 0) {
+        printf("Settled vertices: %d\n", res->settled);
     }
 }
 
@@ -0,0 +1,514 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include "../include/landmarks.h"
+#include "../include/pqueue.h"
+#include "../include/io.h"
+
+/* Set read by landmark_heuristic() */
+static const Landmarks *active_landmarks = NULL;
+
+/* ============================================================================
+   One-to-all Dijkstra – fills the distance tables and drives selection
+   ========================================================================== */
+
+/*
+ * Settles every vertex reachable from the internal sources, over outgoing edges
+ * or, if rev is set, over incoming ones. Unreached vertices get
+ * LANDMARK_UNREACHABLE. parent/order are optional: the shortest-path tree and
+ * the vertices in settling order (*num_order of them).
+ */
+static int landmark_sssp(const Graph *g, const GraphCSR *rev, const int *sources, int num_sources,
+                         PQueue *pq, long long *dist, int *parent, int *order, int *num_order) {
+    int n = g->numVertices;
+    int settled = 0;
+
+    /* Monotone queues restart at key 0 */
+    pqueue_clear(pq);
+    for (int v = 0; v < n; v++) {
+        dist[v] = LANDMARK_UNREACHABLE;
+    }
+    for (int i = 0; i < num_sources; i++) {
+        dist[sources[i]] = 0;
+        if (parent) parent[sources[i]] = -1;
+        if (pqueue_push(pq, sources[i], 0) != 0) {
+            pqueue_clear(pq);
+            return -1;
+        }
+    }
+
+    int u, popped;
+    long long du;
+    while ((popped = pqueue_pop(pq, &u, &du)) == 0) {
+        if (order) order[settled] = u;
+        settled++;
+
+        GraphEdgeIter it;
+        if (rev) {
+            graph_reverse_edges_begin(g, rev, u, &it);
+        } else {
+            graph_edges_begin(g, u, &it);
+        }
+        while (graph_edges_next(&it)) {
+            if (it.weight < 0) {
+                pqueue_clear(pq);
+                return -1;
+            }
+            long long nd = du + it.weight;
+            if (dist[it.to] != LANDMARK_UNREACHABLE && nd >= dist[it.to]) {
+                continue;
+            }
+            dist[it.to] = nd;
+            if (parent) parent[it.to] = u;
+            if (pqueue_push(pq, it.to, nd) != 0) {
+                pqueue_clear(pq);
+                return -1;
+            }
+        }
+    }
+    if (popped == PQUEUE_NO_MEMORY) {
+        pqueue_clear(pq);
+        return -1;
+    }
+
+    if (num_order) *num_order = settled;
+    return 0;
+}
+
+/* ============================================================================
+   Lower bounds
+   ========================================================================== */
+
+/* Bound from the first `filled` landmarks of tables with `stride` entries per vertex */
+static long long landmark_bound(const Landmarks *lm, int stride, int filled, int from, int to) {
+    const long long *from_l_v = lm->fromLandmark + (size_t)from * stride;
+    const long long *from_l_t = lm->fromLandmark + (size_t)to * stride;
+    const long long *to_l_v = lm->toLandmark + (size_t)from * stride;
+    const long long *to_l_t = lm->toLandmark + (size_t)to * stride;
+    long long best = 0;
+
+    for (int i = 0; i < filled; i++) {
+        /* d(L, t) ≤ d(L, v) + d(v, t) */
+        if (from_l_v[i] != LANDMARK_UNREACHABLE && from_l_t[i] != LANDMARK_UNREACHABLE &&
+            from_l_t[i] - from_l_v[i] > best) {
+            best = from_l_t[i] - from_l_v[i];
+        }
+        /* d(v, L) ≤ d(v, t) + d(t, L) */
+        if (to_l_v[i] != LANDMARK_UNREACHABLE && to_l_t[i] != LANDMARK_UNREACHABLE &&
+            to_l_v[i] - to_l_t[i] > best) {
+            best = to_l_v[i] - to_l_t[i];
+        }
+    }
+    return best;
+}
+
+long long landmarks_lower_bound(const Landmarks *lm, int from, int to) {
+    if (!lm || from < 0 || to < 0 || from >= lm->numVertices || to >= lm->numVertices) {
+        return 0;
+    }
+    return landmark_bound(lm, lm->count, lm->count, from, to);
+}
+
+/* ============================================================================
+   Landmark selection
+   ========================================================================== */
+
+typedef struct {
+    Graph *graph;
+    PQueue *pq;
+    long long *dist;
+    int *parent;
+    int *order;
+    long long *size;
+    int *bestChild;
+    unsigned char *flags;       /* LANDMARK_FLAG_* per internal vertex */
+    int *chosen;                /* internal IDs of the landmarks so far */
+    unsigned int seed;
+} LandmarkBuilder;
+
+#define LANDMARK_FLAG_CHOSEN   0x1u
+#define LANDMARK_FLAG_COVERED  0x2u    /* avoid: subtree holds a landmark */
+
+/* Vertex farthest from the chosen landmarks (or from vertex 0 for the first one).
+   Vertices they cannot reach count as farthest, so every component gets a landmark. */
+static int select_farthest(LandmarkBuilder *b, int num_chosen) {
+    int root = 0;
+    const int *sources = num_chosen > 0 ? b->chosen : &root;
+    if (landmark_sssp(b->graph, NULL, sources, num_chosen > 0 ? num_chosen : 1,
+                      b->pq, b->dist, NULL, NULL, NULL) != 0) {
+        return -1;
+    }
+
+    int best = -1;
+    for (int v = 0; v < b->graph->numVertices; v++) {
+        if (b->flags[v] & LANDMARK_FLAG_CHOSEN) continue;
+        if (b->dist[v] == LANDMARK_UNREACHABLE) return v;
+        if (best < 0 || b->dist[v] > b->dist[best]) best = v;
+    }
+    return best;
+}
+
+/*
+ * Avoid (Goldberg & Werneck): grow a shortest-path tree from a random root,
+ * weigh each vertex by how far the current bound d(r, v) - h(r, v) falls short,
+ * and sum the weights per subtree, zeroing subtrees that already hold a
+ * landmark. Walking from the root into the heaviest child down to a leaf lands
+ * in the region the current landmarks serve worst.
+ */
+static int select_avoid(LandmarkBuilder *b, const Landmarks *lm, int num_chosen) {
+    int n = b->graph->numVertices;
+    if (num_chosen == 0) {
+        return select_farthest(b, 0);
+    }
+
+    int root;
+    do {
+        b->seed = b->seed * 1103515245u + 12345u;
+        root = (int)((b->seed >> 8) % (unsigned int)n);
+    } while (b->flags[root] & LANDMARK_FLAG_CHOSEN);
+
+    int settled = 0;
+    if (landmark_sssp(b->graph, NULL, &root, 1, b->pq, b->dist, b->parent, b->order, &settled) != 0) {
+        return -1;
+    }
+
+    int root_ext = graph_to_external(b->graph, root);
+    for (int k = 0; k < settled; k++) {
+        int v = b->order[k];
+        b->size[v] = 0;
+        b->bestChild[v] = -1;
+        b->flags[v] &= (unsigned char)~LANDMARK_FLAG_COVERED;
+    }
+
+    /* Children settle after their parent, so a reverse sweep completes every subtree first */
+    for (int k = settled - 1; k >= 0; k--) {
+        int v = b->order[k];
+        if (b->flags[v] & (LANDMARK_FLAG_CHOSEN | LANDMARK_FLAG_COVERED)) {
+            b->flags[v] |= LANDMARK_FLAG_COVERED;
+            b->size[v] = 0;
+        } else {
+            long long gap = b->dist[v] - landmark_bound(lm, lm->count, num_chosen, root_ext,
+                                                        graph_to_external(b->graph, v));
+            b->size[v] += gap;
+        }
+
+        int p = b->parent[v];
+        if (p < 0) continue;
+        b->size[p] += b->size[v];
+        b->flags[p] |= b->flags[v] & LANDMARK_FLAG_COVERED;
+        if (b->size[v] > 0 && (b->bestChild[p] < 0 || b->size[v] > b->size[b->bestChild[p]])) {
+            b->bestChild[p] = v;
+        }
+    }
+
+    /* The root's own subtree usually holds a landmark; only its children's sizes matter */
+    int v = root;
+    while (b->bestChild[v] >= 0) {
+        v = b->bestChild[v];
+    }
+    if (b->flags[v] & LANDMARK_FLAG_COVERED) {
+        return select_farthest(b, num_chosen);
+    }
+    return v;
+}
+
+/* ============================================================================
+   Build / free
+   ========================================================================== */
+
+static void builder_free(LandmarkBuilder *b) {
+    pqueue_destroy(b->pq);
+    free(b->dist);
+    free(b->parent);
+    free(b->order);
+    free(b->size);
+    free(b->bestChild);
+    free(b->flags);
+    free(b->chosen);
+}
+
+/* splitmix64 finalizer */
+static uint64_t landmark_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/*
+ * Edge count and an order-independent hash of every edge (base and overlay) by
+ * external ID, so a renumbered or compressed copy of the graph hashes the same.
+ * g must be frozen.
+ */
+static void landmark_graph_hash(const Graph *g, int *num_edges, uint64_t *hash) {
+    uint64_t h = 0;
+    int m = 0;
+    for (int u = 0; u < g->numVertices; u++) {
+        uint64_t from = (uint64_t)(uint32_t)graph_to_external(g, u) << 32;
+        GraphEdgeIter it;
+        for (graph_edges_begin(g, u, &it); graph_edges_next(&it); ) {
+            uint64_t to = (uint32_t)graph_to_external(g, it.to);
+            h += landmark_mix((from | to) ^ landmark_mix((uint64_t)it.weight));
+            m++;
+        }
+    }
+    *num_edges = m;
+    *hash = h;
+}
+
+Landmarks *landmarks_build(Graph *g, int count, LandmarkStrategy strategy) {
+    if (!g || count <= 0 || graph_freeze(g) != 0) {
+        return NULL;
+    }
+
+    const GraphCSR *rev = graph_reverse(g);
+    if (!rev) {
+        return NULL;
+    }
+
+    int n = g->numVertices;
+    if (count > n) {
+        count = n;
+    }
+
+    Landmarks *lm = calloc(1, sizeof(Landmarks));
+    if (!lm) {
+        return NULL;
+    }
+    lm->numVertices = n;
+    lm->count = count;
+    lm->graphVersion = graph_version(g);
+    landmark_graph_hash(g, &lm->numEdges, &lm->edgeHash);
+    lm->vertices = malloc(count * sizeof(int));
+    lm->fromLandmark = malloc((size_t)n * count * sizeof(long long));
+    lm->toLandmark = malloc((size_t)n * count * sizeof(long long));
+
+    long long max_weight = graph_max_weight(g);
+    LandmarkBuilder b = {0};
+    b.graph = g;
+    b.pq = pqueue_create(max_weight >= 0 ? pqueue_kind_for_max_weight(max_weight) : PQ_BINARY_HEAP, n, max_weight);
+    b.dist = malloc(n * sizeof(long long));
+    b.parent = malloc(n * sizeof(int));
+    b.order = malloc(n * sizeof(int));
+    b.size = malloc(n * sizeof(long long));
+    b.bestChild = malloc(n * sizeof(int));
+    b.flags = calloc(n, 1);
+    b.chosen = malloc(count * sizeof(int));
+    b.seed = 0x5eed;
+
+    int ok = lm->vertices && lm->fromLandmark && lm->toLandmark && b.pq && b.dist && b.parent &&
+             b.order && b.size && b.bestChild && b.flags && b.chosen;
+
+    for (int i = 0; ok && i < count; i++) {
+        int l = strategy == LANDMARKS_AVOID ? select_avoid(&b, lm, i) : select_farthest(&b, i);
+        if (l < 0) {
+            ok = 0;
+            break;
+        }
+        b.chosen[i] = l;
+        b.flags[l] |= LANDMARK_FLAG_CHOSEN;
+        lm->vertices[i] = graph_to_external(g, l);
+
+        /* Column i of both tables, stored by external ID */
+        if (landmark_sssp(g, NULL, &l, 1, b.pq, b.dist, NULL, NULL, NULL) != 0) {
+            ok = 0;
+            break;
+        }
+        for (int v = 0; v < n; v++) {
+            lm->fromLandmark[(size_t)graph_to_external(g, v) * count + i] = b.dist[v];
+        }
+        if (landmark_sssp(g, rev, &l, 1, b.pq, b.dist, NULL, NULL, NULL) != 0) {
+            ok = 0;
+            break;
+        }
+        for (int v = 0; v < n; v++) {
+            lm->toLandmark[(size_t)graph_to_external(g, v) * count + i] = b.dist[v];
+        }
+    }
+
+    builder_free(&b);
+    if (!ok) {
+        landmarks_free(lm);
+        return NULL;
+    }
+    return lm;
+}
+
+void landmarks_free(Landmarks *lm) {
+    if (!lm) {
+        return;
+    }
+    free(lm->vertices);
+    free(lm->fromLandmark);
+    free(lm->toLandmark);
+    free(lm);
+}
+
+/* ============================================================================
+   Binary table file
+
+   Layout: LandmarksHeader, then
+     vertices[count]                 int32 (external IDs)
+     from_landmark[numVertices*count] int64 (vertex-major)
+     to_landmark[numVertices*count]   int64 (vertex-major)
+   ========================================================================== */
+
+#define LANDMARKS_MAGIC    "RPALT\0\0\0"
+#define LANDMARKS_VERSION  2u
+#define LANDMARKS_ENDIAN   0x01020304u
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t endian;
+    int32_t  numVertices;
+    int32_t  count;
+    int32_t  numEdges;   /* Edges of the graph the tables were built for */
+    uint32_t reserved;
+    uint64_t edgeHash;   /* Order-independent hash of those edges (landmark_graph_hash()) */
+} LandmarksHeader;
+
+int landmarks_save(const Landmarks *lm, const char *filename) {
+    if (!lm || !filename) {
+        io_print_error("Invalid landmarks or filename");
+        return -1;
+    }
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        io_print_error("Failed to open landmark file for writing");
+        return -1;
+    }
+
+    LandmarksHeader hdr = {0};
+    memcpy(hdr.magic, LANDMARKS_MAGIC, sizeof(hdr.magic));
+    hdr.version     = LANDMARKS_VERSION;
+    hdr.endian      = LANDMARKS_ENDIAN;
+    hdr.numVertices = lm->numVertices;
+    hdr.count       = lm->count;
+    hdr.numEdges    = lm->numEdges;
+    hdr.edgeHash    = lm->edgeHash;
+
+    size_t cells = (size_t)lm->numVertices * lm->count;
+    int rc = fwrite(&hdr, sizeof(hdr), 1, fp) == 1 &&
+             fwrite(lm->vertices, sizeof(int32_t), lm->count, fp) == (size_t)lm->count &&
+             fwrite(lm->fromLandmark, sizeof(int64_t), cells, fp) == cells &&
+             fwrite(lm->toLandmark, sizeof(int64_t), cells, fp) == cells ? 0 : -1;
+
+    if (fclose(fp) != 0) {
+        rc = -1;
+    }
+    if (rc != 0) {
+        io_print_error("Failed to write landmark file");
+    }
+    return rc;
+}
+
+Landmarks *landmarks_load(const char *filename, Graph *g) {
+    if (!filename || !g || graph_freeze(g) != 0) {
+        io_print_error("Invalid landmark filename or graph");
+        return NULL;
+    }
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        io_print_error("Failed to open landmark file");
+        return NULL;
+    }
+
+    LandmarksHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1 || memcmp(hdr.magic, LANDMARKS_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != LANDMARKS_VERSION || hdr.endian != LANDMARKS_ENDIAN) {
+        io_print_error("Not a landmark file, or unsupported version or byte order");
+        fclose(fp);
+        return NULL;
+    }
+    int num_edges;
+    uint64_t edge_hash;
+    landmark_graph_hash(g, &num_edges, &edge_hash);
+    if (hdr.numVertices != g->numVertices || hdr.count <= 0 || hdr.count > hdr.numVertices ||
+        hdr.numEdges != num_edges || hdr.edgeHash != edge_hash) {
+        io_print_error("Landmark file was built for a different graph");
+        fclose(fp);
+        return NULL;
+    }
+
+    Landmarks *lm = calloc(1, sizeof(Landmarks));
+    if (!lm) {
+        fclose(fp);
+        return NULL;
+    }
+    lm->numVertices = hdr.numVertices;
+    lm->count = hdr.count;
+    lm->graphVersion = graph_version(g);
+    lm->numEdges = num_edges;
+    lm->edgeHash = edge_hash;
+
+    size_t cells = (size_t)lm->numVertices * lm->count;
+    lm->vertices = malloc(lm->count * sizeof(int));
+    lm->fromLandmark = malloc(cells * sizeof(long long));
+    lm->toLandmark = malloc(cells * sizeof(long long));
+
+    int ok = lm->vertices && lm->fromLandmark && lm->toLandmark &&
+             fread(lm->vertices, sizeof(int32_t), lm->count, fp) == (size_t)lm->count &&
+             fread(lm->fromLandmark, sizeof(int64_t), cells, fp) == cells &&
+             fread(lm->toLandmark, sizeof(int64_t), cells, fp) == cells;
+    fclose(fp);
+
+    for (int i = 0; ok && i < lm->count; i++) {
+        ok = lm->vertices[i] >= 0 && lm->vertices[i] < lm->numVertices;
+    }
+    for (size_t c = 0; ok && c < cells; c++) {
+        ok = lm->fromLandmark[c] >= LANDMARK_UNREACHABLE && lm->toLandmark[c] >= LANDMARK_UNREACHABLE;
+    }
+
+    if (!ok) {
+        io_print_error("Invalid or corrupt landmark file");
+        landmarks_free(lm);
+        return NULL;
+    }
+    return lm;
+}
+
+/* ============================================================================
+   A* heuristic
+   ========================================================================== */
+
+void landmarks_set_active(const Landmarks *lm) {
+    active_landmarks = lm;
+}
+
+const Landmarks *landmarks_active(void) {
+    return active_landmarks;
+}
+
+int landmarks_current(const Landmarks *lm, const Graph *g) {
+    return lm && g && lm->numVertices == g->numVertices && lm->graphVersion == graph_version(g);
+}
+
+int landmarks_heuristic_usable(int (*heuristic)(int, int), const Graph *g) {
+    return heuristic != landmark_heuristic || !active_landmarks || landmarks_current(active_landmarks, g);
+}
+
+int landmark_heuristic(int from, int to) {
+    long long bound = landmarks_lower_bound(active_landmarks, from, to);
+    return bound > INT_MAX ? INT_MAX : (int)bound;
+}
+
+int landmark_strategy_from_string(const char *name, LandmarkStrategy *out) {
+    if (!name || !out) {
+        return -1;
+    }
+    if (strcmp(name, "farthest") == 0) {
+        *out = LANDMARKS_FARTHEST;
+    } else if (strcmp(name, "avoid") == 0) {
+        *out = LANDMARKS_AVOID;
+    } else {
+        return -1;
+    }
+    return 0;
+}
@@ -1,18 +1,83 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "../include/graph.h"
 #include "../include/io.h"
 #include "../include/cli.h"
+#include "../include/reorder.h"
+#include "../include/algorithms.h"
+#include "../include/landmarks.h"
+
+/**
+ * @brief Times the same random Dijkstra queries with each queue backend and
+ * prints queries/s, relative to the binary heap.
+ */
+static void bench_queues(Graph *graph, int queries) {
+    static const PQueueKind kinds[] = { PQ_BINARY_HEAP, PQ_DIAL, PQ_RADIX_HEAP };
+    static const char *names[] = { "binary heap", "dial buckets", "radix heap" };
+    int n = graph->numVertices;
+    long long max_weight = graph_max_weight(graph);
+    PQueueKind saved = search_get_queue();
+    double heap_rate = 0.0;
+
+    int *path = malloc(n * sizeof(int));
+    if (!path) {
+        io_print_error("Out of memory");
+        return;
+    }
+
+    printf("Queue benchmark: %d Dijkstra queries, max edge weight %lld (auto → %s)\n",
+           queries, max_weight,
+           pqueue_kind_for_max_weight(max_weight) == PQ_DIAL ? "dial buckets" : "radix heap");
+
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        if (kinds[k] == PQ_DIAL && pqueue_kind_for_max_weight(max_weight) != PQ_DIAL) {
+            printf("  %-14s skipped (max weight above %d)\n", names[k], PQ_DIAL_MAX_WEIGHT);
+            continue;
+        }
+
+        search_set_queue(kinds[k]);
+        srand(42);
+        long long checksum = 0;
+        clock_t begin = clock();
+        for (int q = 0; q < queries; q++) {
+            long long dist = -1;
+            int from = rand() % n;
+            int to = rand() % n;
+            if (dijkstra_shortest_path(graph, from, to, path, n, &dist) > 0) {
+                checksum += dist;
+            }
+        }
+        double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+        double rate = seconds > 0.0 ? queries / seconds : 0.0;
+
+        if (kinds[k] == PQ_BINARY_HEAP) {
+            heap_rate = rate;
+        }
+        printf("  %-14s %12.1f queries/s", names[k], rate);
+        if (heap_rate > 0.0 && rate > 0.0) {
+            printf("  (%.2fx heap)", rate / heap_rate);
+        }
+        printf("  checksum %lld\n", checksum);
+    }
+
+    search_set_queue(saved);
+    free(path);
+}
 
 /**
  * @brief Entry point for the Route Planner application.
  *
  * Usage:
- *   ./route_planner [graph_file]
+ *   ./route_planner [--reorder <strategy>] [--save-snapshot <file>] [--check-snapshot] [--compress]
+ *                   [--queue <backend>] [--bench-queues <queries>]
+ *                   [--landmarks <k>] [--landmark-strategy <s>] [--save-landmarks <file>]
+ *                   [--load-landmarks <file>] [graph_file]
  *
  * If no graph file is provided, defaults to "data/sample_graph.txt".
+ * Binary snapshots are detected by their magic and memory-mapped instead of parsed.
  * Loads the graph, shows basic info, starts the interactive CLI,
  * and cleans up properly on exit.
  *
@@ -23,28 +88,134 @@
 
 int main(int argc, char *argv[]) {
     const char *filename = "data/sample_graph.txt";
+    const char *snapshot_out = NULL;
+    const char *reorder = NULL;
+    int compress = 0;
+    int check_snapshot = 0;
+    int bench_queries = 0;
+    int landmark_count = 0;
+    LandmarkStrategy landmark_strategy = LANDMARKS_FARTHEST;
+    const char *landmarks_out = NULL;
+    const char *landmarks_in = NULL;
+    Landmarks *landmarks = NULL;
     Graph *graph = NULL;
 
-    if (argc > 1) {
-        if (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0) {
-            printf("Usage: %s [graph_file]\n\n", argv[0]);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            printf("Usage: %s [options] [graph_file]\n\n", argv[0]);
             printf("Options:\n");
-            printf("  graph_file     Path to graph file (default: data/sample_graph.txt)\n");
-            printf("  --help, -h     Show this help message\n");
+            printf("  graph_file               Text graph or binary snapshot (default: data/sample_graph.txt)\n");
+            printf("  --save-snapshot <file>   Write the loaded graph as a binary snapshot\n");
+            printf("  --check-snapshot         Validate every section of a snapshot graph_file while loading\n");
+            printf("  --reorder <strategy>     Renumber vertices for locality: bfs, rcm, hilbert\n");
+            printf("  --compress               Use the compressed adjacency layout and report bytes/edge\n");
+            printf("  --queue <backend>        Dijkstra/A* priority queue: auto (default), heap, dial, radix,\n");
+            printf("                           scan (tiny graphs)\n");
+            printf("  --bench-queues <n>       Time n random Dijkstra queries per queue backend and exit\n");
+            printf("  --landmarks <k>          Precompute k ALT landmarks for A* options 4.4 and 7.3\n");
+            printf("  --landmark-strategy <s>  Landmark selection: farthest (default), avoid\n");
+            printf("  --save-landmarks <file>  Write the landmark tables to a file\n");
+            printf("  --load-landmarks <file>  Use landmark tables written by --save-landmarks\n");
+            printf("  --help, -h               Show this help message\n");
             printf("\n");
             printf("Example:\n");
             printf("  %s data/sample_graph.txt\n", argv[0]);
             printf("  %s my_cities.txt\n", argv[0]);
+            printf("  %s --reorder rcm --save-snapshot europe.snap data/sample_graph.txt\n", argv[0]);
+            printf("  %s europe.snap\n", argv[0]);
             return EXIT_SUCCESS;
         }
-        filename = argv[1];
+        if (strcmp(argv[i], "--save-snapshot") == 0) {
+            if (i + 1 >= argc) {
+                io_print_error("--save-snapshot requires a file name");
+                return EXIT_FAILURE;
+            }
+            snapshot_out = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--check-snapshot") == 0) {
+            check_snapshot = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--compress") == 0) {
+            compress = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--queue") == 0) {
+            PQueueKind kind;
+            if (i + 1 >= argc || pqueue_kind_from_string(argv[i + 1], &kind) != 0) {
+                io_print_error("--queue requires a backend (auto, heap, dial, radix, scan)");
+                return EXIT_FAILURE;
+            }
+            search_set_queue(kind);
+            i++;
+            continue;
+        }
+        if (strcmp(argv[i], "--bench-queues") == 0) {
+            if (i + 1 >= argc || (bench_queries = atoi(argv[i + 1])) <= 0) {
+                io_print_error("--bench-queues requires a positive query count");
+                return EXIT_FAILURE;
+            }
+            i++;
+            continue;
+        }
+        if (strcmp(argv[i], "--landmarks") == 0) {
+            if (i + 1 >= argc || (landmark_count = atoi(argv[i + 1])) <= 0) {
+                io_print_error("--landmarks requires a positive landmark count");
+                return EXIT_FAILURE;
+            }
+            i++;
+            continue;
+        }
+        if (strcmp(argv[i], "--landmark-strategy") == 0) {
+            if (i + 1 >= argc || landmark_strategy_from_string(argv[i + 1], &landmark_strategy) != 0) {
+                io_print_error("--landmark-strategy requires a strategy (farthest, avoid)");
+                return EXIT_FAILURE;
+            }
+            i++;
+            continue;
+        }
+        if (strcmp(argv[i], "--save-landmarks") == 0) {
+            if (i + 1 >= argc) {
+                io_print_error("--save-landmarks requires a file name");
+                return EXIT_FAILURE;
+            }
+            landmarks_out = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--load-landmarks") == 0) {
+            if (i + 1 >= argc) {
+                io_print_error("--load-landmarks requires a file name");
+                return EXIT_FAILURE;
+            }
+            landmarks_in = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--reorder") == 0) {
+            if (i + 1 >= argc) {
+                io_print_error("--reorder requires a strategy (bfs, rcm, hilbert)");
+                return EXIT_FAILURE;
+            }
+            reorder = argv[++i];
+            continue;
+        }
+        filename = argv[i];
+    }
+
+    if (landmarks_out && landmark_count <= 0) {
+        io_print_error("--save-landmarks requires --landmarks <k>");
+        return EXIT_FAILURE;
     }
 
     printf("Route Planner\n");
     printf("------------- \n");
     printf("Loading graph from: %s\n", filename);
 
-    graph = load_graph_from_file(filename);
+    if (is_graph_snapshot_file(filename)) {
+        graph = check_snapshot ? load_graph_snapshot_checked(filename) : load_graph_snapshot(filename);
+    } else {
+        graph = load_graph_from_file(filename);
+    }
     if (!graph) {
         io_print_error("Failed to load graph file");
         fprintf(stderr, "  → Check file path, format, or content.\n");
@@ -54,8 +225,80 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
+    if (reorder) {
+        VertexOrder order;
+        if (vertex_order_from_string(reorder, &order) != 0) {
+            io_print_error("Unknown reorder strategy (use bfs, rcm or hilbert)");
+            graph_free(graph);
+            return EXIT_FAILURE;
+        }
+        if (graph_reorder(graph, order) != 0) {
+            io_print_error("Reordering failed (snapshots are read-only, hilbert needs coordinates)");
+            graph_free(graph);
+            return EXIT_FAILURE;
+        }
+        printf("Vertices renumbered (%s order)\n", reorder);
+    }
+
+    if (snapshot_out) {
+        if (save_graph_snapshot(graph, snapshot_out) != 0) {
+            graph_free(graph);
+            return EXIT_FAILURE;
+        }
+        printf("Snapshot written to: %s\n", snapshot_out);
+    }
+
+    if (compress) {
+        int edges = graph->csr.numEdges > 0 ? graph->csr.numEdges : 1;
+        size_t plain = graph_adjacency_bytes(graph);
+        if (graph_drop_builder(graph) != 0 || graph_compress(graph) != 0) {
+            io_print_error("Compression failed (snapshot-backed graphs are read-only)");
+            graph_free(graph);
+            return EXIT_FAILURE;
+        }
+        size_t packed = graph_adjacency_bytes(graph);
+        printf("Adjacency: plain %zu bytes (%.2f bytes/edge) → compressed %zu bytes (%.2f bytes/edge)\n",
+               plain, (double)plain / edges, packed, (double)packed / edges);
+    }
+
+    if (landmarks_in) {
+        landmarks = landmarks_load(landmarks_in, graph);
+    } else if (landmark_count > 0) {
+        landmarks = landmarks_build(graph, landmark_count, landmark_strategy);
+        if (!landmarks) {
+            io_print_error("Landmark preprocessing failed (weights must be non-negative)");
+        }
+    }
+    if ((landmarks_in || landmark_count > 0) && !landmarks) {
+        graph_free(graph);
+        return EXIT_FAILURE;
+    }
+    if (landmarks) {
+        landmarks_set_active(landmarks);
+        printf("Landmarks: %d (%s)\n", landmarks->count,
+               landmarks_in ? landmarks_in : (landmark_strategy == LANDMARKS_AVOID ? "avoid" : "farthest"));
+    }
+    if (landmarks && landmarks_out) {
+        if (landmarks_save(landmarks, landmarks_out) != 0) {
+            landmarks_free(landmarks);
+            graph_free(graph);
+            return EXIT_FAILURE;
+        }
+        printf("Landmark tables written to: %s\n", landmarks_out);
+    }
+
     printf("Graph loaded successfully!\n");
     printf("  → %d vertices (cities/places)\n", graph->numVertices);
+    printf("  → %d-bit weights, %d-bit distances\n", graph->csr.weightBits, graph->distBits);
+    if (bench_queries > 0) {
+        printf("\n");
+        bench_queues(graph, bench_queries);
+        landmarks_set_active(NULL);
+        landmarks_free(landmarks);
+        graph_free(graph);
+        search_context_release();
+        return EXIT_SUCCESS;
+    }
     printf("  → Use Ctrl+C to exit at any time\n\n");
 
     printf("Quick graph summary (first few vertices):\n");
@@ -67,7 +310,10 @@ int main(int argc, char *argv[]) {
     cli_main_loop(graph);
 
     printf("\nExiting. Freeing graph memory...\n");
+    landmarks_set_active(NULL);
+    landmarks_free(landmarks);
     graph_free(graph);
+    search_context_release();
 
     printf("Goodbye! Safe travels.\n");
     return EXIT_SUCCESS;
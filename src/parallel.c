@@ -0,0 +1,114 @@
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "../include/parallel.h"
+
+struct ParallelTeam {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int size;                   /* members, 0 until every thread is started */
+    int waiting;                /* members inside the current barrier */
+    unsigned int generation;    /* barriers completed so far */
+    ParallelFn fn;
+    void *ctx;
+};
+
+typedef struct {
+    ParallelTeam *team;
+    int member;
+} ParallelMember;
+
+int parallel_threads(int requested, int items) {
+    int cap = items < PARALLEL_MAX_THREADS ? items : PARALLEL_MAX_THREADS;
+    if (requested > cap) {
+        requested = cap;
+    }
+    return requested > 1 ? requested : 1;
+}
+
+void parallel_slice(int count, int member, int size, int *first, int *last) {
+    int per = (count + size - 1) / size;
+    *first = member * per < count ? member * per : count;
+    *last = *first + per < count ? *first + per : count;
+}
+
+static void *parallel_member_main(void *arg) {
+    const ParallelMember *m = arg;
+    ParallelTeam *team = m->team;
+
+    /* The team size is only known once the caller has started every thread */
+    pthread_mutex_lock(&team->lock);
+    while (team->size == 0) {
+        pthread_cond_wait(&team->cond, &team->lock);
+    }
+    int size = team->size;
+    pthread_mutex_unlock(&team->lock);
+
+    team->fn(team->ctx, team, m->member, size);
+    return NULL;
+}
+
+void parallel_run(int num_threads, ParallelFn fn, void *ctx) {
+    ParallelTeam team = { .fn = fn, .ctx = ctx };
+    num_threads = parallel_threads(num_threads, PARALLEL_MAX_THREADS);
+
+    int helpers = num_threads - 1;
+    pthread_t *threads = helpers > 0 ? malloc(helpers * sizeof(pthread_t)) : NULL;
+    ParallelMember *members = helpers > 0 ? malloc(helpers * sizeof(ParallelMember)) : NULL;
+    int synced = threads && members && pthread_mutex_init(&team.lock, NULL) == 0;
+    if (synced && pthread_cond_init(&team.cond, NULL) != 0) {
+        pthread_mutex_destroy(&team.lock);
+        synced = 0;
+    }
+
+    /* Without threads the caller is a team of one and barriers return at once */
+    if (!synced) {
+        free(threads);
+        free(members);
+        team.size = 1;
+        fn(ctx, &team, 0, 1);
+        return;
+    }
+
+    int started = 0;
+    for (int t = 0; t < helpers; t++) {
+        members[started] = (ParallelMember){ &team, started + 1 };
+        if (pthread_create(&threads[started], NULL, parallel_member_main, &members[started]) == 0) {
+            started++;
+        }
+    }
+
+    pthread_mutex_lock(&team.lock);
+    team.size = started + 1;
+    pthread_cond_broadcast(&team.cond);
+    pthread_mutex_unlock(&team.lock);
+
+    fn(ctx, &team, 0, started + 1);
+
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_cond_destroy(&team.cond);
+    pthread_mutex_destroy(&team.lock);
+    free(threads);
+    free(members);
+}
+
+void parallel_barrier(ParallelTeam *team) {
+    if (team->size <= 1) {
+        return;
+    }
+
+    pthread_mutex_lock(&team->lock);
+    unsigned int generation = team->generation;
+    if (++team->waiting == team->size) {
+        team->waiting = 0;
+        team->generation++;
+        pthread_cond_broadcast(&team->cond);
+    } else {
+        while (generation == team->generation) {
+            pthread_cond_wait(&team->cond, &team->lock);
+        }
+    }
+    pthread_mutex_unlock(&team->lock);
+}
@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/partition.h"
+
+typedef struct {
+    const Graph *graph;
+    const GraphCSR *rev;
+    int *regionOf;
+    int *order;             /* BFS order of the region being split */
+    unsigned int *seen;     /* BFS stamp per vertex */
+    unsigned int stamp;
+} Bisection;
+
+/*
+ * BFS over edges in both directions, restricted to region r, from root.
+ * Appends the vertices in discovery order to order[*tail] onwards.
+ */
+static void bisect_bfs(Bisection *b, int r, int root, int *tail) {
+    int head = *tail;
+    b->seen[root] = b->stamp;
+    b->order[(*tail)++] = root;
+
+    while (head < *tail) {
+        int u = b->order[head++];
+        for (int dir = 0; dir < 2; dir++) {
+            GraphEdgeIter it;
+            if (dir) {
+                graph_reverse_edges_begin(b->graph, b->rev, u, &it);
+            } else {
+                graph_edges_begin(b->graph, u, &it);
+            }
+            while (graph_edges_next(&it)) {
+                if (b->regionOf[it.to] == r && b->seen[it.to] != b->stamp) {
+                    b->seen[it.to] = b->stamp;
+                    b->order[(*tail)++] = it.to;
+                }
+            }
+        }
+    }
+}
+
+/* Reorders the members of region r by BFS and moves the second half to region q */
+static void bisect_region(Bisection *b, int r, int q, int *members, int size) {
+    /* The last vertex a BFS reaches is far from the rest of its piece */
+    int tail = 0;
+    b->stamp++;
+    bisect_bfs(b, r, members[0], &tail);
+    int root = b->order[tail - 1];
+
+    tail = 0;
+    b->stamp++;
+    bisect_bfs(b, r, root, &tail);
+
+    /* Disconnected pieces follow one after another */
+    for (int i = 0; i < size && tail < size; i++) {
+        if (b->seen[members[i]] != b->stamp) {
+            bisect_bfs(b, r, members[i], &tail);
+        }
+    }
+
+    memcpy(members, b->order, size * sizeof(int));
+    for (int i = size / 2; i < size; i++) {
+        b->regionOf[members[i]] = q;
+    }
+}
+
+int graph_partition_bisect(Graph *graph, int *region_of, int num_regions, int max_regions, int max_size) {
+    if (!graph || !region_of || num_regions < 1 || num_regions > graph->numVertices) {
+        return -1;
+    }
+    const GraphCSR *rev = graph_reverse(graph);
+    if (!rev) {
+        return -1;
+    }
+
+    int n = graph->numVertices;
+    for (int v = 0; v < n; v++) {
+        if (region_of[v] < 0 || region_of[v] >= num_regions) return -1;
+    }
+
+    /* Members of region r occupy members[begin[r] .. begin[r] + size[r]) */
+    Bisection b = { graph, rev, region_of, malloc(n * sizeof(int)), calloc(n, sizeof(unsigned int)), 0 };
+    int *members = malloc(n * sizeof(int));
+    int *begin = calloc(n + 1, sizeof(int));
+    int *size = calloc(n, sizeof(int));
+    int *fifo = malloc((num_regions + 2 * n) * sizeof(int));
+    int count = -1;
+
+    if (b.order && b.seen && members && begin && size && fifo) {
+        for (int v = 0; v < n; v++) size[region_of[v]]++;
+        for (int r = 0; r < num_regions; r++) begin[r + 1] = begin[r] + size[r];
+        for (int v = 0; v < n; v++) members[begin[region_of[v]]++] = v;
+        for (int r = 0; r < num_regions; r++) begin[r] -= size[r];
+
+        int head = 0, tail = 0;
+        for (int r = 0; r < num_regions; r++) fifo[tail++] = r;
+
+        count = num_regions;
+        while (head < tail && count < max_regions) {
+            int r = fifo[head++];
+            if (size[r] <= max_size || size[r] < 2) continue;
+
+            int q = count++;
+            bisect_region(&b, r, q, members + begin[r], size[r]);
+            begin[q] = begin[r] + size[r] / 2;
+            size[q] = size[r] - size[r] / 2;
+            size[r] /= 2;
+            fifo[tail++] = r;
+            fifo[tail++] = q;
+        }
+    }
+
+    free(b.order);
+    free(b.seen);
+    free(members);
+    free(begin);
+    free(size);
+    free(fifo);
+    return count;
+}
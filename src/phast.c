@@ -0,0 +1,303 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "../include/phast.h"
+#include "../include/pqueue.h"
+#include "../include/search_context.h"
+
+/* Distance of an unreached vertex; adding one arc weight cannot overflow it */
+#define PHAST_INF (LLONG_MAX / 2)
+
+/* ============================================================================
+   Layout – levels of the downward arcs, vertices numbered by sweep position
+   ========================================================================== */
+
+PhastSweep *phast_build(Graph *graph, const ContractionHierarchy *ch) {
+    if (!graph || !ch || graph_freeze(graph) != 0 || ch->numVertices != graph->numVertices ||
+        ch->graphVersion != graph_version(graph)) {
+        return NULL;
+    }
+
+    int n = graph->numVertices;
+    PhastSweep *ph = calloc(1, sizeof(PhastSweep));
+    int *level = calloc(n > 0 ? n : 1, sizeof(int));
+    int *levelStart = NULL;
+    if (ph) {
+        ph->numVertices = n;
+        ph->graphVersion = graph_version(graph);
+        ph->posOf = malloc((n > 0 ? n : 1) * sizeof(int));
+        ph->vertexAt = malloc((n > 0 ? n : 1) * sizeof(int));
+        ph->upOffsets = calloc(n + 1, sizeof(int));
+        ph->downOffsets = calloc(n + 1, sizeof(int));
+    }
+
+    int ok = ph && level && ph->posOf && ph->vertexAt && ph->upOffsets && ph->downOffsets;
+
+    /* Tails of downward arcs have higher ranks, so one pass from the top settles every level */
+    int num_up = 0, num_down = 0;
+    for (int r = n - 1; ok && r >= 0; r--) {
+        for (int i = ch->downOffsets[r]; i < ch->downOffsets[r + 1]; i++) {
+            if (ch->downWeights[i] == CH_NO_ARC) continue;
+            if (level[ch->downSources[i]] + 1 > level[r]) level[r] = level[ch->downSources[i]] + 1;
+            num_down++;
+        }
+        for (int i = ch->upOffsets[r]; i < ch->upOffsets[r + 1]; i++) {
+            if (ch->upWeights[i] != CH_NO_ARC) num_up++;
+        }
+        if (level[r] + 1 > ph->numLevels) ph->numLevels = level[r] + 1;
+    }
+
+    if (ok) {
+        levelStart = calloc(ph->numLevels + 1, sizeof(int));
+        ph->upTargets = malloc((num_up > 0 ? num_up : 1) * sizeof(int));
+        ph->upWeights = malloc((num_up > 0 ? num_up : 1) * sizeof(long long));
+        ph->downSources = malloc((num_down > 0 ? num_down : 1) * sizeof(int));
+        ph->downWeights = malloc((num_down > 0 ? num_down : 1) * sizeof(long long));
+        ok = levelStart && ph->upTargets && ph->upWeights && ph->downSources && ph->downWeights;
+    }
+
+    /* Counting sort by level; ranks run downwards inside a level */
+    if (ok) {
+        for (int r = 0; r < n; r++) {
+            levelStart[level[r] + 1]++;
+        }
+        for (int l = 0; l < ph->numLevels; l++) {
+            levelStart[l + 1] += levelStart[l];
+        }
+        for (int r = n - 1; r >= 0; r--) {
+            int p = levelStart[level[r]]++;
+            ph->vertexAt[p] = ch->vertexAt[r];
+            ph->posOf[ch->vertexAt[r]] = p;
+        }
+    }
+
+    for (int p = 0; ok && p < n; p++) {
+        int r = ch->rankOf[ph->vertexAt[p]];
+        ph->upOffsets[p + 1] = ph->upOffsets[p];
+        for (int i = ch->upOffsets[r]; i < ch->upOffsets[r + 1]; i++) {
+            if (ch->upWeights[i] == CH_NO_ARC) continue;
+            int a = ph->upOffsets[p + 1]++;
+            ph->upTargets[a] = ph->posOf[ch->vertexAt[ch->upTargets[i]]];
+            ph->upWeights[a] = ch->upWeights[i];
+        }
+        ph->downOffsets[p + 1] = ph->downOffsets[p];
+        for (int i = ch->downOffsets[r]; i < ch->downOffsets[r + 1]; i++) {
+            if (ch->downWeights[i] == CH_NO_ARC) continue;
+            int a = ph->downOffsets[p + 1]++;
+            ph->downSources[a] = ph->posOf[ch->vertexAt[ch->downSources[i]]];
+            ph->downWeights[a] = ch->downWeights[i];
+        }
+    }
+
+    free(level);
+    free(levelStart);
+    if (!ok) {
+        phast_free(ph);
+        return NULL;
+    }
+    return ph;
+}
+
+void phast_free(PhastSweep *ph) {
+    if (!ph) {
+        return;
+    }
+    free(ph->posOf);
+    free(ph->vertexAt);
+    free(ph->upOffsets);
+    free(ph->upTargets);
+    free(ph->upWeights);
+    free(ph->downOffsets);
+    free(ph->downSources);
+    free(ph->downWeights);
+    free(ph);
+}
+
+/* ============================================================================
+   Queries
+   ========================================================================== */
+
+static int phast_usable(const PhastSweep *ph, Graph *graph) {
+    return ph && graph && ph->numVertices == graph->numVertices && graph_freeze(graph) == 0 &&
+           graph_version(graph) == ph->graphVersion;
+}
+
+/*
+ * Dijkstra from position root over the upward arcs. Distances live in
+ * d[p * stride + lane], PHAST_INF for every position on entry.
+ */
+static int phast_upward(const PhastSweep *ph, PQueue *pq, int root, long long *d, int stride, int lane) {
+    int failed = 0;
+
+    pqueue_clear(pq);
+    d[(size_t)root * stride + lane] = 0;
+    failed = pqueue_push(pq, root, 0) != 0;
+
+    int u, popped = 0;
+    long long du;
+    while (!failed && (popped = pqueue_pop(pq, &u, &du)) == 0) {
+        for (int i = ph->upOffsets[u]; i < ph->upOffsets[u + 1]; i++) {
+            long long *dx = &d[(size_t)ph->upTargets[i] * stride + lane];
+            long long nd = du + ph->upWeights[i];
+            if (nd < *dx) {
+                *dx = nd;
+                if (pqueue_push(pq, ph->upTargets[i], nd) != 0) {
+                    failed = 1;
+                    break;
+                }
+            }
+        }
+    }
+    failed = failed || popped == PQUEUE_NO_MEMORY;
+    pqueue_clear(pq);
+    return failed ? -1 : 0;
+}
+
+/* Breadth-first tree over the edges u → v with d(u) + w = d(v) */
+static int phast_parents(const PhastSweep *ph, Graph *graph, int s, const long long *d, int *out_parent) {
+    int n = graph->numVertices;
+    int *queue = malloc((n > 0 ? n : 1) * sizeof(int));
+    unsigned char *seen = calloc(n > 0 ? n : 1, 1);
+    if (!queue || !seen) {
+        free(queue);
+        free(seen);
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) {
+        out_parent[v] = -1;
+    }
+    int head = 0, tail = 0;
+    queue[tail++] = s;
+    seen[s] = 1;
+    while (head < tail) {
+        int u = queue[head++];
+        long long du = d[ph->posOf[u]];
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            if (!seen[it.to] && it.weight >= 0 && du + it.weight == d[ph->posOf[it.to]]) {
+                seen[it.to] = 1;
+                out_parent[graph_to_external(graph, it.to)] = graph_to_external(graph, u);
+                queue[tail++] = it.to;
+            }
+        }
+    }
+
+    free(queue);
+    free(seen);
+    return 0;
+}
+
+int phast_one_to_all(const PhastSweep *ph, Graph *graph, int start, long long *out_dist, int *out_parent) {
+    if (!out_dist || start < 0 || !phast_usable(ph, graph) || start >= graph->numVertices) {
+        return -1;
+    }
+
+    int n = graph->numVertices;
+    SearchContext *ctx = search_context_current(n);
+    if (!ctx || !search_context_queue(ctx, PQ_BINARY_HEAP, 0)) {
+        return -1;
+    }
+
+    /* Borrow the context's dist array; a new generation marks its old entries unreached */
+    search_context_begin(ctx);
+    long long *d = ctx->dist;
+    for (int p = 0; p < n; p++) {
+        d[p] = PHAST_INF;
+    }
+
+    int s = graph_to_internal(graph, start);
+    if (phast_upward(ph, ctx->queue, ph->posOf[s], d, 1, 0) != 0) {
+        return -1;
+    }
+
+    /* Every tail sits at an earlier position and is final when its heads are swept */
+    const int *offsets = ph->downOffsets;
+    const int *sources = ph->downSources;
+    const long long *weights = ph->downWeights;
+    for (int p = 0; p < n; p++) {
+        long long best = d[p];
+        for (int i = offsets[p]; i < offsets[p + 1]; i++) {
+            long long c = d[sources[i]] + weights[i];
+            if (c < best) best = c;
+        }
+        d[p] = best;
+    }
+
+    int reached = 0;
+    for (int p = 0; p < n; p++) {
+        int ext = graph_to_external(graph, ph->vertexAt[p]);
+        if (d[p] >= PHAST_INF) {
+            out_dist[ext] = -1;
+        } else {
+            out_dist[ext] = d[p];
+            reached++;
+        }
+    }
+
+    if (out_parent && phast_parents(ph, graph, s, d, out_parent) != 0) {
+        reached = -1;
+    }
+    return reached;
+}
+
+int phast_many_to_all(const PhastSweep *ph, Graph *graph, const int *sources, int num_sources,
+                      long long *out_dists) {
+    if (!sources || !out_dists || num_sources < 0 || !phast_usable(ph, graph)) {
+        return -1;
+    }
+    int n = graph->numVertices;
+    for (int i = 0; i < num_sources; i++) {
+        if (sources[i] < 0 || sources[i] >= n) return -1;
+    }
+
+    SearchContext *ctx = search_context_current(n);
+    /* PHAST_LANES distances per vertex: one 64-byte cache line each */
+    long long *d = aligned_alloc(64, (size_t)(n > 0 ? n : 1) * PHAST_LANES * sizeof(long long));
+    if (!ctx || !d || !search_context_queue(ctx, PQ_BINARY_HEAP, 0)) {
+        free(d);
+        return -1;
+    }
+
+    const int *offsets = ph->downOffsets;
+    const int *arc_sources = ph->downSources;
+    const long long *weights = ph->downWeights;
+    int failed = 0;
+
+    for (int first = 0; first < num_sources && !failed; first += PHAST_LANES) {
+        int lanes = num_sources - first < PHAST_LANES ? num_sources - first : PHAST_LANES;
+
+        for (size_t i = 0; i < (size_t)n * PHAST_LANES; i++) {
+            d[i] = PHAST_INF;
+        }
+        for (int l = 0; l < lanes && !failed; l++) {
+            int s = graph_to_internal(graph, sources[first + l]);
+            failed = phast_upward(ph, ctx->queue, ph->posOf[s], d, PHAST_LANES, l) != 0;
+        }
+
+        /* Unused lanes stay at PHAST_INF; a full fixed-width loop vectorizes */
+        for (int p = 0; p < n && !failed; p++) {
+            long long *dp = d + (size_t)p * PHAST_LANES;
+            for (int i = offsets[p]; i < offsets[p + 1]; i++) {
+                const long long *ds = d + (size_t)arc_sources[i] * PHAST_LANES;
+                long long w = weights[i];
+                for (int l = 0; l < PHAST_LANES; l++) {
+                    long long c = ds[l] + w;
+                    dp[l] = c < dp[l] ? c : dp[l];
+                }
+            }
+        }
+
+        for (int l = 0; l < lanes && !failed; l++) {
+            long long *row = out_dists + (size_t)(first + l) * n;
+            for (int p = 0; p < n; p++) {
+                long long dist = d[(size_t)p * PHAST_LANES + l];
+                row[graph_to_external(graph, ph->vertexAt[p])] = dist >= PHAST_INF ? -1 : dist;
+            }
+        }
+    }
+
+    free(d);
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,587 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "../include/pqueue.h"
+
+/* ============================================================================
+   Binary heap backend (indexed, supports decrease-key)
+   ========================================================================== */
+
+typedef struct {
+    int node;
+    long long key;
+} HeapEntry;
+
+typedef struct {
+    PQueue base;
+    HeapEntry *entries;
+    int *heapIndex;     /* node -> position in entries, -1 if not queued */
+} BinaryHeap;
+
+static void heap_swap(BinaryHeap *h, int i, int j) {
+    HeapEntry tmp = h->entries[i];
+    h->entries[i] = h->entries[j];
+    h->entries[j] = tmp;
+
+    h->heapIndex[h->entries[i].node] = i;
+    h->heapIndex[h->entries[j].node] = j;
+}
+
+static void heap_sift_up(BinaryHeap *h, int idx) {
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        if (h->entries[parent].key <= h->entries[idx].key) break;
+        heap_swap(h, parent, idx);
+        idx = parent;
+    }
+}
+
+static void heap_sift_down(BinaryHeap *h, int idx) {
+    int size = h->base.size;
+
+    while (1) {
+        int min_idx = idx;
+        int left = 2 * idx + 1;
+        int right = 2 * idx + 2;
+
+        if (left < size && h->entries[left].key < h->entries[min_idx].key) {
+            min_idx = left;
+        }
+        if (right < size && h->entries[right].key < h->entries[min_idx].key) {
+            min_idx = right;
+        }
+
+        if (min_idx == idx) break;
+        heap_swap(h, idx, min_idx);
+        idx = min_idx;
+    }
+}
+
+static int heap_push(PQueue *pq, int node, long long key) {
+    BinaryHeap *h = (BinaryHeap *)pq;
+    if (node < 0 || node >= pq->capacity) return -1;
+
+    int idx = h->heapIndex[node];
+    if (idx >= 0) {
+        if (key < h->entries[idx].key) {
+            h->entries[idx].key = key;
+            heap_sift_up(h, idx);
+        }
+        return 0;
+    }
+
+    idx = pq->size++;
+    h->entries[idx].node = node;
+    h->entries[idx].key = key;
+    h->heapIndex[node] = idx;
+    heap_sift_up(h, idx);
+    return 0;
+}
+
+static int heap_pop(PQueue *pq, int *node, long long *key) {
+    BinaryHeap *h = (BinaryHeap *)pq;
+    if (pq->size == 0) return -1;
+
+    *node = h->entries[0].node;
+    *key = h->entries[0].key;
+    h->heapIndex[*node] = -1;
+
+    pq->size--;
+    if (pq->size > 0) {
+        h->entries[0] = h->entries[pq->size];
+        h->heapIndex[h->entries[0].node] = 0;
+        heap_sift_down(h, 0);
+    }
+    return 0;
+}
+
+static void heap_clear(PQueue *pq) {
+    BinaryHeap *h = (BinaryHeap *)pq;
+    for (int i = 0; i < pq->size; i++) {
+        h->heapIndex[h->entries[i].node] = -1;
+    }
+    pq->size = 0;
+}
+
+static void heap_destroy(PQueue *pq) {
+    BinaryHeap *h = (BinaryHeap *)pq;
+    free(h->entries);
+    free(h->heapIndex);
+    free(h);
+}
+
+static const PQueueOps binary_heap_ops = {
+    "binary heap", 0, heap_push, heap_pop, heap_clear, heap_destroy
+};
+
+static PQueue *binary_heap_create(int capacity) {
+    BinaryHeap *h = calloc(1, sizeof(BinaryHeap));
+    if (!h) return NULL;
+
+    h->entries = malloc(capacity * sizeof(HeapEntry));
+    h->heapIndex = malloc(capacity * sizeof(int));
+    if (!h->entries || !h->heapIndex) {
+        free(h->entries);
+        free(h->heapIndex);
+        free(h);
+        return NULL;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        h->heapIndex[i] = -1;
+    }
+
+    h->base.ops = &binary_heap_ops;
+    h->base.capacity = capacity;
+    return &h->base;
+}
+
+/* ============================================================================
+   Linear scan backend – the original O(V²) Dijkstra selection, kept as an
+   explicit mode for tiny graphs where it avoids all heap bookkeeping
+   ========================================================================== */
+
+typedef struct {
+    PQueue base;
+    long long *keys;
+    unsigned char *queued;
+} LinearScan;
+
+static int scan_push(PQueue *pq, int node, long long key) {
+    LinearScan *s = (LinearScan *)pq;
+    if (node < 0 || node >= pq->capacity) return -1;
+
+    if (!s->queued[node]) {
+        s->queued[node] = 1;
+        s->keys[node] = key;
+        pq->size++;
+    } else if (key < s->keys[node]) {
+        s->keys[node] = key;
+    }
+    return 0;
+}
+
+static int scan_pop(PQueue *pq, int *node, long long *key) {
+    LinearScan *s = (LinearScan *)pq;
+    if (pq->size == 0) return -1;
+
+    int best = -1;
+    for (int v = 0; v < pq->capacity; v++) {
+        if (s->queued[v] && (best < 0 || s->keys[v] < s->keys[best])) {
+            best = v;
+        }
+    }
+
+    s->queued[best] = 0;
+    pq->size--;
+    *node = best;
+    *key = s->keys[best];
+    return 0;
+}
+
+static void scan_clear(PQueue *pq) {
+    LinearScan *s = (LinearScan *)pq;
+    if (pq->size > 0) {
+        memset(s->queued, 0, pq->capacity);
+    }
+    pq->size = 0;
+}
+
+static void scan_destroy(PQueue *pq) {
+    LinearScan *s = (LinearScan *)pq;
+    free(s->keys);
+    free(s->queued);
+    free(s);
+}
+
+static const PQueueOps linear_scan_ops = {
+    "linear scan", 0, scan_push, scan_pop, scan_clear, scan_destroy
+};
+
+static PQueue *linear_scan_create(int capacity) {
+    LinearScan *s = calloc(1, sizeof(LinearScan));
+    if (!s) return NULL;
+
+    s->keys = malloc(capacity * sizeof(long long));
+    s->queued = calloc(capacity, 1);
+    if (!s->keys || !s->queued) {
+        free(s->keys);
+        free(s->queued);
+        free(s);
+        return NULL;
+    }
+
+    s->base.ops = &linear_scan_ops;
+    s->base.capacity = capacity;
+    return &s->base;
+}
+
+/* ============================================================================
+   Dial's buckets – ring of max_weight + 1 doubly linked lists
+   While every queued key lies in [cursor, cursor + max_weight], bucket
+   key % numBuckets holds exactly one key value, so pop only has to walk the
+   cursor forward to the next non-empty bucket.
+   ========================================================================== */
+
+typedef struct {
+    PQueue base;
+    long long cursor;   /* key of the last pop (0 after clear), lower bound of every queued key */
+    int numBuckets;
+    int *head;          /* bucket -> first node, -1 if empty */
+    int *next;
+    int *prev;
+    long long *keys;
+    unsigned char *queued;
+} DialQueue;
+
+static void dial_unlink(DialQueue *q, int node) {
+    int b = (int)(q->keys[node] % q->numBuckets);
+    if (q->prev[node] >= 0) {
+        q->next[q->prev[node]] = q->next[node];
+    } else {
+        q->head[b] = q->next[node];
+    }
+    if (q->next[node] >= 0) {
+        q->prev[q->next[node]] = q->prev[node];
+    }
+}
+
+static void dial_link(DialQueue *q, int node) {
+    int b = (int)(q->keys[node] % q->numBuckets);
+    q->prev[node] = -1;
+    q->next[node] = q->head[b];
+    if (q->head[b] >= 0) {
+        q->prev[q->head[b]] = node;
+    }
+    q->head[b] = node;
+}
+
+static int dial_push(PQueue *pq, int node, long long key) {
+    DialQueue *q = (DialQueue *)pq;
+    if (node < 0 || node >= pq->capacity || key < 0) return -1;
+
+    if (key < q->cursor || key - q->cursor >= q->numBuckets) {
+        return -1;
+    }
+
+    if (q->queued[node]) {
+        if (key >= q->keys[node]) return 0;
+        dial_unlink(q, node);
+    } else {
+        q->queued[node] = 1;
+        pq->size++;
+    }
+
+    q->keys[node] = key;
+    dial_link(q, node);
+    return 0;
+}
+
+static int dial_pop(PQueue *pq, int *node, long long *key) {
+    DialQueue *q = (DialQueue *)pq;
+    if (pq->size == 0) return -1;
+
+    int b = (int)(q->cursor % q->numBuckets);
+    while (q->head[b] < 0) {
+        q->cursor++;
+        b = (b + 1 == q->numBuckets) ? 0 : b + 1;
+    }
+
+    int v = q->head[b];
+    dial_unlink(q, v);
+    q->queued[v] = 0;
+    pq->size--;
+
+    *node = v;
+    *key = q->keys[v];
+    return 0;
+}
+
+static void dial_clear(PQueue *pq) {
+    DialQueue *q = (DialQueue *)pq;
+    for (int b = 0; pq->size > 0 && b < q->numBuckets; b++) {
+        for (int v = q->head[b]; v >= 0; v = q->next[v]) {
+            q->queued[v] = 0;
+            pq->size--;
+        }
+        q->head[b] = -1;
+    }
+    q->cursor = 0;
+}
+
+static void dial_destroy(PQueue *pq) {
+    DialQueue *q = (DialQueue *)pq;
+    free(q->head);
+    free(q->next);
+    free(q->prev);
+    free(q->keys);
+    free(q->queued);
+    free(q);
+}
+
+static const PQueueOps dial_ops = {
+    "dial buckets", 1, dial_push, dial_pop, dial_clear, dial_destroy
+};
+
+static PQueue *dial_create(int capacity, long long max_weight) {
+    if (max_weight < 0 || max_weight >= INT_MAX) {
+        return NULL;
+    }
+
+    DialQueue *q = calloc(1, sizeof(DialQueue));
+    if (!q) return NULL;
+
+    q->numBuckets = (int)max_weight + 1;
+    q->head = malloc(q->numBuckets * sizeof(int));
+    q->next = malloc(capacity * sizeof(int));
+    q->prev = malloc(capacity * sizeof(int));
+    q->keys = malloc(capacity * sizeof(long long));
+    q->queued = calloc(capacity, 1);
+    if (!q->head || !q->next || !q->prev || !q->keys || !q->queued) {
+        dial_destroy(&q->base);
+        return NULL;
+    }
+
+    for (int b = 0; b < q->numBuckets; b++) {
+        q->head[b] = -1;
+    }
+
+    q->base.ops = &dial_ops;
+    q->base.capacity = capacity;
+    return &q->base;
+}
+
+/* ============================================================================
+   Radix heap – a key k sits in bucket 0 if k == last, else in bucket
+   1 + index of the highest bit where k and last differ. Popping from an empty
+   bucket 0 moves last to the minimum of the first non-empty bucket and
+   redistributes that bucket, which sends every entry strictly lower; each node
+   therefore moves at most 64 times between pushes.
+   ========================================================================== */
+
+#define RADIX_BUCKETS 65
+
+typedef struct {
+    int *nodes;
+    int size;
+    int capacity;
+} RadixBucket;
+
+typedef struct {
+    PQueue base;
+    unsigned long long last;    /* key of the last pop, 0 after clear */
+    RadixBucket buckets[RADIX_BUCKETS];
+    unsigned long long *keys;
+    signed char *bucketOf;  /* node -> bucket, -1 if not queued */
+    int *slot;              /* node -> position in its bucket */
+} RadixHeap;
+
+static int radix_bucket_for(unsigned long long key, unsigned long long last) {
+    unsigned long long diff = key ^ last;
+    int b = 0;
+    while (diff) {
+        diff >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/* Makes room for extra more nodes in bucket */
+static int radix_reserve(RadixBucket *bucket, int extra) {
+    if (bucket->size + extra <= bucket->capacity) {
+        return 0;
+    }
+
+    int capacity = bucket->capacity ? bucket->capacity * 2 : 16;
+    if (capacity < bucket->size + extra) capacity = bucket->size + extra;
+    int *grown = realloc(bucket->nodes, capacity * sizeof(int));
+    if (!grown) return -1;
+    bucket->nodes = grown;
+    bucket->capacity = capacity;
+    return 0;
+}
+
+static int radix_insert(RadixHeap *h, int node, int b) {
+    RadixBucket *bucket = &h->buckets[b];
+    if (radix_reserve(bucket, 1) != 0) {
+        return -1;
+    }
+
+    h->bucketOf[node] = (signed char)b;
+    h->slot[node] = bucket->size;
+    bucket->nodes[bucket->size++] = node;
+    return 0;
+}
+
+static void radix_remove(RadixHeap *h, int node) {
+    RadixBucket *bucket = &h->buckets[h->bucketOf[node]];
+    int i = h->slot[node];
+    int moved = bucket->nodes[--bucket->size];
+
+    bucket->nodes[i] = moved;
+    h->slot[moved] = i;
+    h->bucketOf[node] = -1;
+}
+
+static int radix_push(PQueue *pq, int node, long long key) {
+    RadixHeap *h = (RadixHeap *)pq;
+    if (node < 0 || node >= pq->capacity || key < 0) return -1;
+
+    unsigned long long k = (unsigned long long)key;
+    if (k < h->last) {
+        return -1;
+    }
+
+    if (h->bucketOf[node] >= 0) {
+        if (k >= h->keys[node]) return 0;
+        radix_remove(h, node);
+    } else {
+        pq->size++;
+    }
+
+    h->keys[node] = k;
+    if (radix_insert(h, node, radix_bucket_for(k, h->last)) != 0) {
+        pq->size--;
+        return -1;
+    }
+    return 0;
+}
+
+static int radix_pop(PQueue *pq, int *node, long long *key) {
+    RadixHeap *h = (RadixHeap *)pq;
+    if (pq->size == 0) return -1;
+
+    if (h->buckets[0].size == 0) {
+        int b = 1;
+        while (h->buckets[b].size == 0) b++;
+
+        RadixBucket *bucket = &h->buckets[b];
+        unsigned long long min_key = h->keys[bucket->nodes[0]];
+        for (int i = 1; i < bucket->size; i++) {
+            if (h->keys[bucket->nodes[i]] < min_key) min_key = h->keys[bucket->nodes[i]];
+        }
+
+        /*
+         * Every entry lands in a strictly lower bucket. Reserve room in all
+         * of them first, so a failed allocation leaves the queue untouched.
+         */
+        int need[RADIX_BUCKETS] = {0};
+        for (int i = 0; i < bucket->size; i++) {
+            need[radix_bucket_for(h->keys[bucket->nodes[i]], min_key)]++;
+        }
+        for (int t = 0; t < b; t++) {
+            if (need[t] > 0 && radix_reserve(&h->buckets[t], need[t]) != 0) {
+                return PQUEUE_NO_MEMORY;
+            }
+        }
+
+        h->last = min_key;
+        int count = bucket->size;
+        bucket->size = 0;
+        for (int i = 0; i < count; i++) {
+            int v = bucket->nodes[i];
+            radix_insert(h, v, radix_bucket_for(h->keys[v], h->last));
+        }
+    }
+
+    RadixBucket *zero = &h->buckets[0];
+    int v = zero->nodes[zero->size - 1];
+    zero->size--;
+    h->bucketOf[v] = -1;
+    pq->size--;
+
+    *node = v;
+    *key = (long long)h->keys[v];
+    return 0;
+}
+
+static void radix_clear(PQueue *pq) {
+    RadixHeap *h = (RadixHeap *)pq;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+        for (int i = 0; i < h->buckets[b].size; i++) {
+            h->bucketOf[h->buckets[b].nodes[i]] = -1;
+        }
+        h->buckets[b].size = 0;
+    }
+    h->last = 0;
+    pq->size = 0;
+}
+
+static void radix_destroy(PQueue *pq) {
+    RadixHeap *h = (RadixHeap *)pq;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+        free(h->buckets[b].nodes);
+    }
+    free(h->keys);
+    free(h->bucketOf);
+    free(h->slot);
+    free(h);
+}
+
+static const PQueueOps radix_heap_ops = {
+    "radix heap", 1, radix_push, radix_pop, radix_clear, radix_destroy
+};
+
+static PQueue *radix_heap_create(int capacity) {
+    RadixHeap *h = calloc(1, sizeof(RadixHeap));
+    if (!h) return NULL;
+
+    h->keys = malloc(capacity * sizeof(unsigned long long));
+    h->bucketOf = malloc(capacity);
+    h->slot = malloc(capacity * sizeof(int));
+    if (!h->keys || !h->bucketOf || !h->slot) {
+        radix_destroy(&h->base);
+        return NULL;
+    }
+
+    memset(h->bucketOf, -1, capacity);
+    h->base.ops = &radix_heap_ops;
+    h->base.capacity = capacity;
+    return &h->base;
+}
+
+/* ============================================================================
+   Public API
+   ========================================================================== */
+
+PQueueKind pqueue_kind_for_max_weight(long long max_weight) {
+    return (max_weight >= 0 && max_weight <= PQ_DIAL_MAX_WEIGHT) ? PQ_DIAL : PQ_RADIX_HEAP;
+}
+
+PQueue *pqueue_create(PQueueKind kind, int capacity, long long max_weight) {
+    if (capacity <= 0) {
+        return NULL;
+    }
+
+    if (kind == PQ_AUTO) {
+        kind = pqueue_kind_for_max_weight(max_weight);
+    }
+
+    switch (kind) {
+        case PQ_BINARY_HEAP: return binary_heap_create(capacity);
+        case PQ_LINEAR_SCAN: return linear_scan_create(capacity);
+        case PQ_DIAL:        return dial_create(capacity, max_weight < 0 ? 0 : max_weight);
+        case PQ_RADIX_HEAP:  return radix_heap_create(capacity);
+        case PQ_AUTO:        break;
+    }
+    return NULL;
+}
+
+int pqueue_kind_from_string(const char *name, PQueueKind *kind) {
+    if (!name || !kind) return -1;
+
+    if (strcmp(name, "auto") == 0) {
+        *kind = PQ_AUTO;
+    } else if (strcmp(name, "heap") == 0) {
+        *kind = PQ_BINARY_HEAP;
+    } else if (strcmp(name, "scan") == 0) {
+        *kind = PQ_LINEAR_SCAN;
+    } else if (strcmp(name, "dial") == 0) {
+        *kind = PQ_DIAL;
+    } else if (strcmp(name, "radix") == 0) {
+        *kind = PQ_RADIX_HEAP;
+    } else {
+        return -1;
+    }
+    return 0;
+}
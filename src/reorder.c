@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../include/graph.h"
+#include "../include/reorder.h"
+
+/* ============================================================================
+   BFS order – discovery order, component by component
+   ========================================================================== */
+
+static int order_bfs(const Graph *g, int n, int *new_of_old) {
+    GraphEdgeIter it;
+    int *queue = malloc(n * sizeof(int));
+    if (!queue) {
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) new_of_old[v] = -1;
+
+    int next_id = 0;
+    for (int root = 0; root < n; root++) {
+        if (new_of_old[root] != -1) continue;
+
+        int front = 0, rear = 0;
+        new_of_old[root] = next_id++;
+        queue[rear++] = root;
+
+        while (front < rear) {
+            int v = queue[front++];
+            for (graph_edges_begin(g, v, &it); graph_edges_next(&it); ) {
+                int u = it.to;
+                if (new_of_old[u] == -1) {
+                    new_of_old[u] = next_id++;
+                    queue[rear++] = u;
+                }
+            }
+        }
+    }
+
+    free(queue);
+    return 0;
+}
+
+/* ============================================================================
+   Reverse Cuthill–McKee – BFS from a low-degree vertex, neighbours visited in
+   increasing degree order, final numbering reversed
+   ========================================================================== */
+
+static int degree_of(const GraphCSR *csr, int v) {
+    return csr->offsets[v + 1] - csr->offsets[v];
+}
+
+static int order_rcm(const Graph *g, int n, int *new_of_old) {
+    const GraphCSR *csr = &g->csr;
+    GraphEdgeIter it;
+    int *queue    = malloc(n * sizeof(int));
+    int *by_deg   = malloc(n * sizeof(int));
+    int max_deg = 0;
+    for (int v = 0; v < n; v++) {
+        if (degree_of(csr, v) > max_deg) max_deg = degree_of(csr, v);
+    }
+    int *bucket = calloc(max_deg + 2, sizeof(int));
+    if (!queue || !by_deg || !bucket) {
+        free(queue);
+        free(by_deg);
+        free(bucket);
+        return -1;
+    }
+
+    /* Counting sort by degree: component roots are picked lowest degree first */
+    for (int v = 0; v < n; v++) bucket[degree_of(csr, v) + 1]++;
+    for (int d = 0; d <= max_deg; d++) bucket[d + 1] += bucket[d];
+    for (int v = 0; v < n; v++) by_deg[bucket[degree_of(csr, v)]++] = v;
+    free(bucket);
+
+    for (int v = 0; v < n; v++) new_of_old[v] = -1;
+
+    int rear = 0;
+    for (int r = 0; r < n; r++) {
+        int root = by_deg[r];
+        if (new_of_old[root] != -1) continue;
+
+        int front = rear;
+        new_of_old[root] = rear;
+        queue[rear++] = root;
+
+        while (front < rear) {
+            int v = queue[front++];
+            int first = rear;
+
+            for (graph_edges_begin(g, v, &it); graph_edges_next(&it); ) {
+                int u = it.to;
+                if (new_of_old[u] == -1) {
+                    new_of_old[u] = rear;
+                    queue[rear++] = u;
+                }
+            }
+
+            /* Insertion sort of the newly queued neighbours by degree (lists are short) */
+            for (int a = first + 1; a < rear; a++) {
+                int u = queue[a];
+                int b = a - 1;
+                while (b >= first && degree_of(csr, queue[b]) > degree_of(csr, u)) {
+                    queue[b + 1] = queue[b];
+                    b--;
+                }
+                queue[b + 1] = u;
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        new_of_old[queue[i]] = n - 1 - i;
+    }
+
+    free(queue);
+    free(by_deg);
+    return 0;
+}
+
+/* ============================================================================
+   Hilbert curve – sort by position along a 2^16 × 2^16 Hilbert curve
+   ========================================================================== */
+
+#define HILBERT_BITS 16
+
+static uint64_t hilbert_index(uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for (uint32_t s = 1u << (HILBERT_BITS - 1); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) ? 1 : 0;
+        uint32_t ry = (y & s) ? 1 : 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+        /* Rotate the quadrant so the curve stays continuous */
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            uint32_t t = x;
+            x = y;
+            y = t;
+        }
+        x &= s - 1;
+        y &= s - 1;
+    }
+    return d;
+}
+
+typedef struct {
+    uint64_t key;
+    int      vertex;
+} OrderKey;
+
+static int compare_order_keys(const void *a, const void *b) {
+    const OrderKey *ka = a, *kb = b;
+    if (ka->key != kb->key) return ka->key < kb->key ? -1 : 1;
+    return (ka->vertex > kb->vertex) - (ka->vertex < kb->vertex);
+}
+
+static int order_hilbert(const Graph *g, int n, int *new_of_old) {
+    if (!g->coords) {
+        return -1;
+    }
+
+    double min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+    for (int id = 0; id < n; id++) {
+        double x = g->coords[2 * id], y = g->coords[2 * id + 1];
+        if (id == 0 || x < min_x) min_x = x;
+        if (id == 0 || x > max_x) max_x = x;
+        if (id == 0 || y < min_y) min_y = y;
+        if (id == 0 || y > max_y) max_y = y;
+    }
+
+    OrderKey *keys = malloc(n * sizeof(OrderKey));
+    if (!keys) {
+        return -1;
+    }
+
+    double span_x = max_x > min_x ? max_x - min_x : 1.0;
+    double span_y = max_y > min_y ? max_y - min_y : 1.0;
+    double cells = (double)((1u << HILBERT_BITS) - 1);
+
+    for (int v = 0; v < n; v++) {
+        int id = graph_to_external(g, v);
+        uint32_t hx = (uint32_t)((g->coords[2 * id] - min_x) / span_x * cells);
+        uint32_t hy = (uint32_t)((g->coords[2 * id + 1] - min_y) / span_y * cells);
+        keys[v].key = hilbert_index(hx, hy);
+        keys[v].vertex = v;
+    }
+
+    qsort(keys, n, sizeof(OrderKey), compare_order_keys);
+    for (int i = 0; i < n; i++) {
+        new_of_old[keys[i].vertex] = i;
+    }
+
+    free(keys);
+    return 0;
+}
+
+/* ============================================================================
+   Public entry points
+   ========================================================================== */
+
+int compute_vertex_order(Graph *g, VertexOrder order, int *new_of_old) {
+    if (!g || !new_of_old || graph_freeze(g) != 0) {
+        return -1;
+    }
+
+    switch (order) {
+        case ORDER_BFS:
+            return order_bfs(g, g->numVertices, new_of_old);
+        case ORDER_RCM:
+            return order_rcm(g, g->numVertices, new_of_old);
+        case ORDER_HILBERT:
+            return order_hilbert(g, g->numVertices, new_of_old);
+        default:
+            return -1;
+    }
+}
+
+int graph_reorder(Graph *g, VertexOrder order) {
+    if (!g) {
+        return -1;
+    }
+
+    int *new_of_old = malloc(g->numVertices * sizeof(int));
+    if (!new_of_old) {
+        return -1;
+    }
+
+    int rc = compute_vertex_order(g, order, new_of_old);
+    if (rc == 0) {
+        rc = graph_apply_permutation(g, new_of_old);
+    }
+
+    free(new_of_old);
+    return rc;
+}
+
+int vertex_order_from_string(const char *name, VertexOrder *out) {
+    if (!name || !out) {
+        return -1;
+    }
+
+    if (strcmp(name, "bfs") == 0) {
+        *out = ORDER_BFS;
+    } else if (strcmp(name, "rcm") == 0) {
+        *out = ORDER_RCM;
+    } else if (strcmp(name, "hilbert") == 0) {
+        *out = ORDER_HILBERT;
+    } else {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../include/search_context.h"
+
+/* Default workspace of each thread, and the caller-owned one bound instead */
+static _Thread_local SearchContext *thread_context = NULL;
+static _Thread_local SearchContext *bound_context = NULL;
+
+SearchContext *search_context_create(int capacity) {
+    if (capacity <= 0) {
+        return NULL;
+    }
+
+    SearchContext *ctx = calloc(1, sizeof(SearchContext));
+    if (!ctx) {
+        return NULL;
+    }
+
+    if (search_context_reserve(ctx, capacity) != 0) {
+        search_context_free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void search_context_free(SearchContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    pqueue_destroy(ctx->queue);
+    pqueue_destroy(ctx->queueBack);
+    free(ctx->stampBack);
+    free(ctx->distBack);
+    free(ctx->parentBack);
+    free(ctx->stamp);
+    free(ctx->dist);
+    free(ctx->parent);
+    free(ctx->scratch);
+    free(ctx->flags);
+    free(ctx);
+}
+
+int search_context_reserve(SearchContext *ctx, int capacity) {
+    if (!ctx || capacity < 0) {
+        return -1;
+    }
+    if (capacity <= ctx->capacity) {
+        return 0;
+    }
+
+    /* Each array is committed as soon as it grows, so a failure leaves a usable context */
+    unsigned int *stamp = realloc(ctx->stamp, capacity * sizeof(unsigned int));
+    if (!stamp) return -1;
+    memset(stamp + ctx->capacity, 0, (capacity - ctx->capacity) * sizeof(unsigned int));
+    ctx->stamp = stamp;
+
+    void *dist = realloc(ctx->dist, capacity * sizeof(int64_t));
+    if (!dist) return -1;
+    ctx->dist = dist;
+
+    int *parent = realloc(ctx->parent, capacity * sizeof(int));
+    if (!parent) return -1;
+    ctx->parent = parent;
+
+    int *scratch = realloc(ctx->scratch, capacity * sizeof(int));
+    if (!scratch) return -1;
+    ctx->scratch = scratch;
+
+    unsigned char *flags = realloc(ctx->flags, capacity);
+    if (!flags) return -1;
+    ctx->flags = flags;
+
+    if (ctx->stampBack) {
+        unsigned int *stamp_back = realloc(ctx->stampBack, capacity * sizeof(unsigned int));
+        if (!stamp_back) return -1;
+        memset(stamp_back + ctx->capacity, 0, (capacity - ctx->capacity) * sizeof(unsigned int));
+        ctx->stampBack = stamp_back;
+
+        long long *dist_back = realloc(ctx->distBack, capacity * sizeof(long long));
+        if (!dist_back) return -1;
+        ctx->distBack = dist_back;
+
+        int *parent_back = realloc(ctx->parentBack, capacity * sizeof(int));
+        if (!parent_back) return -1;
+        ctx->parentBack = parent_back;
+    }
+
+    /* Queues are sized for the old capacity */
+    pqueue_destroy(ctx->queue);
+    pqueue_destroy(ctx->queueBack);
+    ctx->queue = NULL;
+    ctx->queueBack = NULL;
+
+    ctx->capacity = capacity;
+    return 0;
+}
+
+int search_context_enable_backward(SearchContext *ctx) {
+    if (!ctx) {
+        return -1;
+    }
+    if (ctx->stampBack) {
+        return 0;
+    }
+
+    unsigned int *stamp_back = calloc(ctx->capacity, sizeof(unsigned int));
+    long long *dist_back = malloc(ctx->capacity * sizeof(long long));
+    int *parent_back = malloc(ctx->capacity * sizeof(int));
+    if (!stamp_back || !dist_back || !parent_back) {
+        free(stamp_back);
+        free(dist_back);
+        free(parent_back);
+        return -1;
+    }
+
+    ctx->stampBack = stamp_back;
+    ctx->distBack = dist_back;
+    ctx->parentBack = parent_back;
+
+    /* Rebuilt in pairs by search_context_queue() */
+    pqueue_destroy(ctx->queue);
+    ctx->queue = NULL;
+    return 0;
+}
+
+unsigned int search_context_begin(SearchContext *ctx) {
+    if (++ctx->generation == 0) {
+        memset(ctx->stamp, 0, ctx->capacity * sizeof(unsigned int));
+        if (ctx->stampBack) {
+            memset(ctx->stampBack, 0, ctx->capacity * sizeof(unsigned int));
+        }
+        ctx->generation = 1;
+    }
+    ctx->settled = 0;
+    return ctx->generation;
+}
+
+PQueue *search_context_queue(SearchContext *ctx, PQueueKind kind, long long max_weight) {
+    if (ctx->queue && ctx->queueKind == kind &&
+        (kind != PQ_DIAL || max_weight <= ctx->queueMaxWeight)) {
+        return ctx->queue;
+    }
+
+    pqueue_destroy(ctx->queue);
+    pqueue_destroy(ctx->queueBack);
+    ctx->queue = pqueue_create(kind, ctx->capacity, max_weight);
+    ctx->queueBack = NULL;
+    ctx->queueKind = kind;
+    ctx->queueMaxWeight = max_weight;
+
+    if (ctx->queue && ctx->stampBack) {
+        ctx->queueBack = pqueue_create(kind, ctx->capacity, max_weight);
+        if (!ctx->queueBack) {
+            pqueue_destroy(ctx->queue);
+            ctx->queue = NULL;
+        }
+    }
+    return ctx->queue;
+}
+
+SearchContext *search_context_bind(SearchContext *ctx) {
+    SearchContext *previous = bound_context;
+    bound_context = ctx;
+    return previous;
+}
+
+SearchContext *search_context_current(int capacity) {
+    if (bound_context) {
+        return search_context_reserve(bound_context, capacity) == 0 ? bound_context : NULL;
+    }
+
+    if (!thread_context) {
+        thread_context = search_context_create(capacity);
+        return thread_context;
+    }
+    return search_context_reserve(thread_context, capacity) == 0 ? thread_context : NULL;
+}
+
+void search_context_release(void) {
+    search_context_free(thread_context);
+    thread_context = NULL;
+}
@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/search_session.h"
+#include "../include/algorithms.h"
+#include "../include/landmarks.h"
+
+SearchSession *search_session_create(Graph *graph, int start, int (*heuristic)(int from, int to)) {
+    if (!graph || start < 0 || start >= graph->numVertices || graph_freeze(graph) != 0 ||
+        !landmarks_heuristic_usable(heuristic, graph)) {
+        return NULL;
+    }
+
+    int n = graph->numVertices;
+    long long max_weight = graph_max_weight(graph);
+    PQueueKind kind = heuristic ? PQ_BINARY_HEAP : search_get_queue();
+    if (kind == PQ_AUTO) {
+        kind = pqueue_kind_for_max_weight(max_weight);
+    }
+
+    SearchSession *session = calloc(1, sizeof(SearchSession));
+    if (!session) {
+        return NULL;
+    }
+    session->graph = graph;
+    session->start = graph_to_internal(graph, start);
+    session->heuristic = heuristic;
+    session->target = -1;
+    session->graphVersion = graph_version(graph);
+    session->dist = malloc(n * sizeof(long long));
+    session->parent = malloc(n * sizeof(int));
+    session->state = calloc(n, 1);
+    session->reached = malloc(n * sizeof(int));
+    session->queue = pqueue_create(kind, n, max_weight);
+
+    if (!session->dist || !session->parent || !session->state || !session->reached || !session->queue) {
+        search_session_free(session);
+        return NULL;
+    }
+
+    int s = session->start;
+    session->dist[s] = 0;
+    session->parent[s] = -1;
+    session->state[s] = SESSION_OPEN;
+    session->reached[session->numReached++] = s;
+    if (pqueue_push(session->queue, s, 0) != 0) {
+        search_session_free(session);
+        return NULL;
+    }
+    return session;
+}
+
+void search_session_free(SearchSession *session) {
+    if (!session) {
+        return;
+    }
+    free(session->dist);
+    free(session->parent);
+    free(session->state);
+    free(session->reached);
+    pqueue_destroy(session->queue);
+    free(session);
+}
+
+/* Queue key of v for the current target: g, or g + h(v, target) */
+static long long session_key(const SearchSession *session, int v) {
+    if (!session->heuristic) {
+        return session->dist[v];
+    }
+    const Graph *graph = session->graph;
+    return session->dist[v] + session->heuristic(graph_to_external(graph, v),
+                                                 graph_to_external(graph, session->target));
+}
+
+/* Settles vertices until goal is settled or the queue runs dry; -1 if the queue failed */
+static int session_advance(SearchSession *session, int goal) {
+    Graph *graph = session->graph;
+    PQueue *pq = session->queue;
+
+    /* A* keys depend on the goal: re-key every open vertex for the new one */
+    if (session->heuristic && session->target != goal) {
+        session->target = goal;
+        pqueue_clear(pq);
+        for (int i = 0; i < session->numReached; i++) {
+            int v = session->reached[i];
+            if (session->state[v] == SESSION_OPEN && pqueue_push(pq, v, session_key(session, v)) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    int u, popped = 0;
+    long long key;
+    while (session->state[goal] != SESSION_SETTLED && (popped = pqueue_pop(pq, &u, &key)) == 0) {
+        session->state[u] = SESSION_SETTLED;
+        session->settled++;
+        session->lastSettled++;
+
+        /* Expand before checking the goal, so the next goal can resume from here */
+        long long du = session->dist[u];
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            int v = it.to;
+            if (it.weight < 0 || session->state[v] == SESSION_SETTLED) {
+                continue;
+            }
+            long long nd = du + it.weight;
+            if (session->state[v] == SESSION_OPEN && nd >= session->dist[v]) {
+                continue;
+            }
+            if (session->state[v] == SESSION_UNSEEN) {
+                session->state[v] = SESSION_OPEN;
+                session->reached[session->numReached++] = v;
+            }
+            session->dist[v] = nd;
+            session->parent[v] = u;
+            if (pqueue_push(pq, v, session_key(session, v)) != 0) {
+                return -1;
+            }
+        }
+    }
+    /* Out of memory is a failure, not a goal that cannot be reached */
+    return popped == PQUEUE_NO_MEMORY ? -1 : 0;
+}
+
+int search_session_path(SearchSession *session, int goal, int *out_path, int max_path_len,
+                        long long *out_distance) {
+    if (!session || !out_path || !out_distance || goal < 0 || goal >= session->graph->numVertices ||
+        max_path_len < 1) {
+        if (out_distance) *out_distance = -1;
+        return 0;
+    }
+    *out_distance = -1;
+
+    Graph *graph = session->graph;
+    if (session->failed || graph_freeze(graph) != 0 || graph_version(graph) != session->graphVersion) {
+        return 0;
+    }
+
+    int t = graph_to_internal(graph, goal);
+    session->lastSettled = 0;
+
+    /* A failed push may have dropped an open vertex and a failed pop left the search
+       unfinished, so later goals could be missed */
+    if (session->state[t] != SESSION_SETTLED && session_advance(session, t) != 0) {
+        session->failed = 1;
+        return 0;
+    }
+    if (session->state[t] != SESSION_SETTLED) {
+        return 0;
+    }
+
+    /* Count, then fill the path backwards from the goal */
+    int len = 0;
+    for (int x = t; x != -1 && len <= graph->numVertices; x = session->parent[x]) len++;
+    if (len > max_path_len || len > graph->numVertices) {
+        return 0;
+    }
+    int x = t;
+    for (int i = len - 1; i >= 0; i--) {
+        out_path[i] = graph_to_external(graph, x);
+        x = session->parent[x];
+    }
+
+    *out_distance = session->dist[t];
+    return len;
+}
@@ -0,0 +1,466 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/tnr.h"
+#include "../include/partition.h"
+#include "../include/pqueue.h"
+
+/* Tentative distance of a rank the current search has not reached */
+#define TNR_UNSEEN LLONG_MAX
+
+/* ============================================================================
+   Upward searches over the hierarchy
+   ========================================================================== */
+
+typedef struct {
+    const ContractionHierarchy *ch;
+    PQueue *pq;
+    long long *dist;        /* per rank, TNR_UNSEEN outside the current search */
+    int *touched;           /* ranks whose dist must be reset */
+    int *settled;           /* ranks in settling order */
+    long long *settledDist;
+    int numSettled;
+    int firstTransit;       /* lowest transit rank */
+} UpSearch;
+
+/*
+ * Dijkstra from root over upward arcs (forward) or reversed downward arcs
+ * (backward). With stop_at_transit, transit ranks (the root included) are
+ * settled but not expanded. Leaves the settled ranks in s->settled.
+ */
+static int up_search(UpSearch *s, int root, int backward, int stop_at_transit) {
+    const ContractionHierarchy *ch = s->ch;
+    int num_touched = 0, failed = 0;
+
+    s->numSettled = 0;
+    pqueue_clear(s->pq);
+    s->dist[root] = 0;
+    s->touched[num_touched++] = root;
+    failed = pqueue_push(s->pq, root, 0) != 0;
+
+    int u, popped = 0;
+    long long du;
+    while (!failed && (popped = pqueue_pop(s->pq, &u, &du)) == 0) {
+        s->settled[s->numSettled] = u;
+        s->settledDist[s->numSettled++] = du;
+        if (stop_at_transit && u >= s->firstTransit) {
+            continue;
+        }
+
+        int first = backward ? ch->downOffsets[u] : ch->upOffsets[u];
+        int last = backward ? ch->downOffsets[u + 1] : ch->upOffsets[u + 1];
+        for (int i = first; i < last; i++) {
+            int x = backward ? ch->downSources[i] : ch->upTargets[i];
+            long long w = backward ? ch->downWeights[i] : ch->upWeights[i];
+            if (w == CH_NO_ARC) {
+                continue;
+            }
+            if (w < 0) {
+                failed = 1;
+                break;
+            }
+            long long nd = du + w;
+            if (s->dist[x] != TNR_UNSEEN && nd >= s->dist[x]) {
+                continue;
+            }
+            if (s->dist[x] == TNR_UNSEEN) {
+                s->touched[num_touched++] = x;
+            }
+            s->dist[x] = nd;
+            if (pqueue_push(s->pq, x, nd) != 0) {
+                failed = 1;
+                break;
+            }
+        }
+    }
+    failed = failed || popped == PQUEUE_NO_MEMORY;
+
+    pqueue_clear(s->pq);
+    for (int i = 0; i < num_touched; i++) {
+        s->dist[s->touched[i]] = TNR_UNSEEN;
+    }
+    return failed ? -1 : 0;
+}
+
+/* ============================================================================
+   Transit table – bucket-based many-to-many among the transit nodes
+   ========================================================================== */
+
+/*
+ * Every up-down path between two transit nodes stays among the transit
+ * nodes, so backward searches from each of them fill per-rank buckets and a
+ * forward search from each row scans the buckets it settles.
+ */
+static int tnr_fill_table(TransitNodeRouting *tnr, UpSearch *s) {
+    int k = tnr->numTransit;
+    int *bucketOffsets = calloc(k + 1, sizeof(int));
+    int *bucketTransit = NULL;
+    long long *bucketDist = NULL;
+    int capacity = 0, size = 0, failed = !bucketOffsets;
+
+    /* Pass 1: collect (rank, transit, dist) entries, counted per rank */
+    int *entryRank = NULL;
+    for (int j = 0; j < k && !failed; j++) {
+        if (up_search(s, s->firstTransit + j, 1, 0) != 0) {
+            failed = 1;
+            break;
+        }
+        if (size + s->numSettled > capacity) {
+            int grown = (size + s->numSettled) * 2;
+            int *ranks = realloc(entryRank, grown * sizeof(int));
+            if (ranks) entryRank = ranks;
+            int *transit = realloc(bucketTransit, grown * sizeof(int));
+            if (transit) bucketTransit = transit;
+            long long *dists = realloc(bucketDist, grown * sizeof(long long));
+            if (dists) bucketDist = dists;
+            if (!ranks || !transit || !dists) {
+                failed = 1;
+                break;
+            }
+            capacity = grown;
+        }
+        for (int i = 0; i < s->numSettled; i++) {
+            entryRank[size] = s->settled[i];
+            bucketTransit[size] = j;
+            bucketDist[size++] = s->settledDist[i];
+            bucketOffsets[s->settled[i] - s->firstTransit + 1]++;
+        }
+    }
+
+    /* Pass 2: group entries by rank */
+    int *sortedTransit = failed ? NULL : malloc((size > 0 ? size : 1) * sizeof(int));
+    long long *sortedDist = failed ? NULL : malloc((size > 0 ? size : 1) * sizeof(long long));
+    int *fill = failed ? NULL : malloc((k + 1) * sizeof(int));
+    failed = failed || !sortedTransit || !sortedDist || !fill;
+    if (!failed) {
+        for (int r = 0; r < k; r++) {
+            bucketOffsets[r + 1] += bucketOffsets[r];
+        }
+        memcpy(fill, bucketOffsets, (k + 1) * sizeof(int));
+        for (int i = 0; i < size; i++) {
+            int at = fill[entryRank[i] - s->firstTransit]++;
+            sortedTransit[at] = bucketTransit[i];
+            sortedDist[at] = bucketDist[i];
+        }
+    }
+
+    /* Pass 3: one forward search per row */
+    for (int i = 0; i < k && !failed; i++) {
+        long long *row = tnr->table + (size_t)i * k;
+        for (int j = 0; j < k; j++) {
+            row[j] = TNR_NO_PATH;
+        }
+        if (up_search(s, s->firstTransit + i, 0, 0) != 0) {
+            failed = 1;
+            break;
+        }
+        for (int x = 0; x < s->numSettled; x++) {
+            int bucket = s->settled[x] - s->firstTransit;
+            long long d = s->settledDist[x];
+            for (int e = bucketOffsets[bucket]; e < bucketOffsets[bucket + 1]; e++) {
+                long long nd = d + sortedDist[e];
+                if (nd < row[sortedTransit[e]]) {
+                    row[sortedTransit[e]] = nd;
+                }
+            }
+        }
+    }
+
+    free(bucketOffsets);
+    free(entryRank);
+    free(bucketTransit);
+    free(bucketDist);
+    free(sortedTransit);
+    free(sortedDist);
+    free(fill);
+    return failed ? -1 : 0;
+}
+
+/* ============================================================================
+   Access nodes and locality masks
+   ========================================================================== */
+
+typedef struct {
+    int *access;
+    long long *dists;
+    int size;
+    int capacity;
+} AccessList;
+
+static int access_push(AccessList *list, int transit, long long dist) {
+    if (list->size == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 1024;
+        int *access = realloc(list->access, capacity * sizeof(int));
+        if (access) list->access = access;
+        long long *dists = realloc(list->dists, capacity * sizeof(long long));
+        if (dists) list->dists = dists;
+        if (!access || !dists) return -1;
+        list->capacity = capacity;
+    }
+    list->access[list->size] = transit;
+    list->dists[list->size] = dist;
+    list->size++;
+    return 0;
+}
+
+/*
+ * Pruned upward search from vertex v in one direction. Transit nodes settled
+ * become candidates, nearest first; a candidate that an earlier kept one
+ * reaches at no extra cost through the table is dropped. The other settled
+ * vertices mark their cells in *cells.
+ */
+static int tnr_access_nodes(const TransitNodeRouting *tnr, UpSearch *s, const int *cellOf, int v, int backward,
+                            AccessList *list, uint64_t *cells) {
+    const ContractionHierarchy *ch = s->ch;
+    int k = tnr->numTransit;
+
+    if (up_search(s, ch->rankOf[v], backward, 1) != 0) {
+        return -1;
+    }
+
+    *cells = 0;
+    int first = list->size;
+    for (int i = 0; i < s->numSettled; i++) {
+        int r = s->settled[i];
+        long long d = s->settledDist[i];
+        if (r < s->firstTransit) {
+            *cells |= 1ULL << cellOf[ch->vertexAt[r]];
+            continue;
+        }
+
+        int a = r - s->firstTransit;
+        int dominated = 0;
+        for (int j = first; j < list->size && !dominated; j++) {
+            int b = list->access[j];
+            long long via = backward ? tnr->table[(size_t)a * k + b] : tnr->table[(size_t)b * k + a];
+            dominated = via != TNR_NO_PATH && list->dists[j] + via <= d;
+        }
+        if (!dominated && access_push(list, a, d) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Moves a finished list into the routing layer's arrays */
+static void access_take(AccessList *list, int **access, long long **dists) {
+    if (list->size == 0) {
+        free(list->access);
+        free(list->dists);
+        list->access = malloc(sizeof(int));
+        list->dists = malloc(sizeof(long long));
+    }
+    *access = list->access;
+    *dists = list->dists;
+    list->access = NULL;
+    list->dists = NULL;
+}
+
+TransitNodeRouting *tnr_build(Graph *graph, const ContractionHierarchy *ch, int num_transit) {
+    if (!graph || !ch || num_transit < 0 || graph_freeze(graph) != 0 || ch->numVertices != graph->numVertices ||
+        ch->graphVersion != graph_version(graph)) {
+        return NULL;
+    }
+
+    int n = graph->numVertices;
+    if (num_transit == 0) {
+        num_transit = (int)(TNR_DEFAULT_TRANSIT_FACTOR * sqrt((double)n));
+    }
+    int k = num_transit < n ? num_transit : n;
+
+    TransitNodeRouting *tnr = calloc(1, sizeof(TransitNodeRouting));
+    UpSearch s = { ch, pqueue_create(PQ_RADIX_HEAP, n > 0 ? n : 1, 0), malloc(n * sizeof(long long)),
+                   malloc(n * sizeof(int)), malloc(n * sizeof(int)), malloc(n * sizeof(long long)), 0, n - k };
+    int *cellOf = calloc(n > 0 ? n : 1, sizeof(int));
+    AccessList fwd = { 0 }, bwd = { 0 };
+    if (tnr) {
+        tnr->numVertices = n;
+        tnr->graphVersion = graph_version(graph);
+        tnr->numTransit = k;
+        tnr->transitVertex = malloc((k > 0 ? k : 1) * sizeof(int));
+        tnr->table = malloc(((size_t)k * k > 0 ? (size_t)k * k : 1) * sizeof(long long));
+        tnr->fwdOffsets = malloc((n + 1) * sizeof(int));
+        tnr->bwdOffsets = malloc((n + 1) * sizeof(int));
+        tnr->fwdCells = malloc((n > 0 ? n : 1) * sizeof(uint64_t));
+        tnr->bwdCells = malloc((n > 0 ? n : 1) * sizeof(uint64_t));
+    }
+
+    int ok = tnr && s.pq && s.dist && s.touched && s.settled && s.settledDist && cellOf &&
+             tnr->transitVertex && tnr->table && tnr->fwdOffsets && tnr->bwdOffsets && tnr->fwdCells && tnr->bwdCells;
+
+    for (int u = 0; ok && u < n; u++) {
+        GraphEdgeIter it;
+        for (graph_edges_begin(graph, u, &it); graph_edges_next(&it); ) {
+            if (it.weight < 0) {
+                ok = 0;
+                break;
+            }
+        }
+    }
+
+    if (ok) {
+        for (int r = 0; r < n; r++) {
+            s.dist[r] = TNR_UNSEEN;
+        }
+        for (int i = 0; i < k; i++) {
+            tnr->transitVertex[i] = ch->vertexAt[n - k + i];
+        }
+        int cells = n < TNR_LOCALITY_CELLS ? n : TNR_LOCALITY_CELLS;
+        ok = n == 0 || graph_partition_bisect(graph, cellOf, 1, cells, 1) == cells;
+    }
+    ok = ok && tnr_fill_table(tnr, &s) == 0;
+
+    for (int v = 0; ok && v < n; v++) {
+        tnr->fwdOffsets[v] = fwd.size;
+        tnr->bwdOffsets[v] = bwd.size;
+        ok = tnr_access_nodes(tnr, &s, cellOf, v, 0, &fwd, &tnr->fwdCells[v]) == 0 &&
+             tnr_access_nodes(tnr, &s, cellOf, v, 1, &bwd, &tnr->bwdCells[v]) == 0;
+    }
+    if (ok) {
+        tnr->fwdOffsets[n] = fwd.size;
+        tnr->bwdOffsets[n] = bwd.size;
+        access_take(&fwd, &tnr->fwdAccess, &tnr->fwdDists);
+        access_take(&bwd, &tnr->bwdAccess, &tnr->bwdDists);
+        ok = tnr->fwdAccess && tnr->fwdDists && tnr->bwdAccess && tnr->bwdDists;
+    }
+
+    pqueue_destroy(s.pq);
+    free(s.dist);
+    free(s.touched);
+    free(s.settled);
+    free(s.settledDist);
+    free(cellOf);
+    free(fwd.access);
+    free(fwd.dists);
+    free(bwd.access);
+    free(bwd.dists);
+    if (!ok) {
+        tnr_free(tnr);
+        return NULL;
+    }
+    return tnr;
+}
+
+void tnr_free(TransitNodeRouting *tnr) {
+    if (!tnr) {
+        return;
+    }
+    free(tnr->transitVertex);
+    free(tnr->table);
+    free(tnr->fwdOffsets);
+    free(tnr->fwdAccess);
+    free(tnr->fwdDists);
+    free(tnr->bwdOffsets);
+    free(tnr->bwdAccess);
+    free(tnr->bwdDists);
+    free(tnr->fwdCells);
+    free(tnr->bwdCells);
+    free(tnr);
+}
+
+/* ============================================================================
+   Queries
+   ========================================================================== */
+
+static int tnr_usable(const TransitNodeRouting *tnr, Graph *graph, int start, int goal) {
+    return tnr && graph && tnr->numVertices == graph->numVertices &&
+           start >= 0 && goal >= 0 && start < graph->numVertices && goal < graph->numVertices &&
+           graph_freeze(graph) == 0 && graph_version(graph) == tnr->graphVersion;
+}
+
+int tnr_is_local(const TransitNodeRouting *tnr, const Graph *graph, int start, int goal) {
+    if (!tnr || !graph || tnr->numVertices != graph->numVertices ||
+        start < 0 || goal < 0 || start >= graph->numVertices || goal >= graph->numVertices) {
+        return -1;
+    }
+    int s = graph_to_internal(graph, start);
+    int t = graph_to_internal(graph, goal);
+    return (tnr->fwdCells[s] & tnr->bwdCells[t]) != 0;
+}
+
+/* Best access pair of internal s, t through the table; TNR_NO_PATH if none */
+static long long tnr_lookup(const TransitNodeRouting *tnr, int s, int t, int *out_a, int *out_b) {
+    int k = tnr->numTransit;
+    long long best = TNR_NO_PATH;
+
+    for (int i = tnr->fwdOffsets[s]; i < tnr->fwdOffsets[s + 1]; i++) {
+        const long long *row = tnr->table + (size_t)tnr->fwdAccess[i] * k;
+        long long ds = tnr->fwdDists[i];
+        for (int j = tnr->bwdOffsets[t]; j < tnr->bwdOffsets[t + 1]; j++) {
+            long long mid = row[tnr->bwdAccess[j]];
+            if (mid == TNR_NO_PATH) {
+                continue;
+            }
+            long long d = ds + mid + tnr->bwdDists[j];
+            if (d < best) {
+                best = d;
+                *out_a = tnr->fwdAccess[i];
+                *out_b = tnr->bwdAccess[j];
+            }
+        }
+    }
+    return best;
+}
+
+long long tnr_distance(const TransitNodeRouting *tnr, const ContractionHierarchy *ch, Graph *graph,
+                       int start, int goal) {
+    if (!ch || !tnr_usable(tnr, graph, start, goal)) {
+        return -1;
+    }
+
+    if (tnr_is_local(tnr, graph, start, goal)) {
+        long long distance = -1;
+        int *path = malloc((graph->numVertices + 1) * sizeof(int));
+        if (path) {
+            ch_shortest_path(ch, graph, start, goal, path, graph->numVertices + 1, &distance);
+            free(path);
+        }
+        return distance;
+    }
+
+    int a, b;
+    long long d = tnr_lookup(tnr, graph_to_internal(graph, start), graph_to_internal(graph, goal), &a, &b);
+    return d == TNR_NO_PATH ? -1 : d;
+}
+
+int tnr_shortest_path(const TransitNodeRouting *tnr, const ContractionHierarchy *ch, Graph *graph,
+                      int start, int goal, int *out_path, int max_path_len, long long *out_distance) {
+    if (!ch || !out_path || !out_distance || max_path_len < 2 || !tnr_usable(tnr, graph, start, goal)) {
+        if (out_distance) *out_distance = -1;
+        return 0;
+    }
+    *out_distance = -1;
+
+    if (tnr_is_local(tnr, graph, start, goal)) {
+        return ch_shortest_path(ch, graph, start, goal, out_path, max_path_len, out_distance);
+    }
+
+    int a, b;
+    if (tnr_lookup(tnr, graph_to_internal(graph, start), graph_to_internal(graph, goal), &a, &b) == TNR_NO_PATH) {
+        return 0;
+    }
+
+    /* start → a → b → goal; each leg overwrites the previous leg's last vertex */
+    int stops[4] = { start, graph_to_external(graph, tnr->transitVertex[a]),
+                     graph_to_external(graph, tnr->transitVertex[b]), goal };
+    int len = 1;
+    long long total = 0;
+    out_path[0] = start;
+    for (int leg = 0; leg < 3; leg++) {
+        if (stops[leg] == stops[leg + 1]) {
+            continue;
+        }
+        long long d;
+        int n = ch_shortest_path(ch, graph, stops[leg], stops[leg + 1], out_path + len - 1,
+                                 max_path_len - len + 1, &d);
+        if (n == 0) {
+            return 0;
+        }
+        len += n - 1;
+        total += d;
+    }
+
+    *out_distance = total;
+    return len;
+}
@@ -15,6 +15,15 @@ extern void test_name_management(void);
 extern void test_name_null_and_invalid_id(void);
 extern void test_print_graph_does_not_crash(void);
 extern void test_add_edge_invalid_indices(void);
+extern void test_freeze_csr_layout(void);
+extern void test_edge_arena_reserve(void);
+extern void test_name_index_consistency(void);
+extern void test_name_pool_interning(void);
+extern void test_name_pool_stable_pointers(void);
+extern void test_reverse_adjacency_cache(void);
+extern void test_compressed_adjacency(void);
+extern void test_weight_width_selection(void);
+extern void test_delta_overlay(void);
 
 // ───────────────────────────────────────────────
 // Declare all test functions from test_algorithms.c
@@ -33,6 +42,36 @@ extern void test_bellman_ford_negative_weight(void);
 extern void test_bellman_ford_negative_cycle(void);
 extern void test_invalid_inputs(void);
 extern void test_path_buffer_overflow(void);
+extern void test_reorder_preserves_results(void);
+extern void test_algorithms_on_compressed_graph(void);
+extern void test_kernel_widths_agree(void);
+extern void test_queries_see_live_updates(void);
+extern void test_queue_backends_agree(void);
+extern void test_queue_auto_selection(void);
+extern void test_search_context_reuse(void);
+extern void test_bidirectional_dijkstra(void);
+extern void test_bidirectional_astar(void);
+extern void test_landmark_heuristic(void);
+extern void test_contraction_hierarchy(void);
+extern void test_customizable_ch(void);
+extern void test_parallel_team(void);
+extern void test_hub_labels(void);
+extern void test_arc_flags(void);
+extern void test_crp_overlay(void);
+extern void test_transit_nodes(void);
+extern void test_one_to_all(void);
+extern void test_distance_matrix(void);
+extern void test_search_session(void);
+
+// ───────────────────────────────────────────────
+// Declare all test functions from test_io.c
+// ───────────────────────────────────────────────
+extern void test_snapshot_round_trip(void);
+extern void test_snapshot_invalid_file(void);
+extern void test_snapshot_corrupt_sections(void);
+extern void test_snapshot_keeps_vertex_order(void);
+extern void test_snapshot_live_updates(void);
+extern void test_landmarks_round_trip(void);
 
 // ───────────────────────────────────────────────
 // The TEST_LIST — acutest discovers and runs these automatically
@@ -47,6 +86,15 @@ TEST_LIST = {
     { "graph/name_null_and_invalid_id",           test_name_null_and_invalid_id },
     { "graph/print_graph_does_not_crash",         test_print_graph_does_not_crash },
     { "graph/add_edge_invalid_indices",           test_add_edge_invalid_indices },
+    { "graph/freeze_csr_layout",                  test_freeze_csr_layout },
+    { "graph/edge_arena_reserve",                 test_edge_arena_reserve },
+    { "graph/name_index_consistency",             test_name_index_consistency },
+    { "graph/name_pool_interning",                test_name_pool_interning },
+    { "graph/name_pool_stable_pointers",          test_name_pool_stable_pointers },
+    { "graph/reverse_adjacency_cache",            test_reverse_adjacency_cache },
+    { "graph/compressed_adjacency",               test_compressed_adjacency },
+    { "graph/weight_width_selection",             test_weight_width_selection },
+    { "graph/delta_overlay",                      test_delta_overlay },
 
     // Pathfinding algorithms
     { "algo/bfs_disconnected",                    test_bfs_disconnected },
@@ -63,6 +111,34 @@ TEST_LIST = {
     { "algo/bellman_ford_negative_cycle",         test_bellman_ford_negative_cycle },
     { "algo/invalid_inputs_all_algos",            test_invalid_inputs },
     { "algo/path_buffer_overflow",                test_path_buffer_overflow },
+    { "algo/reorder_preserves_results",           test_reorder_preserves_results },
+    { "algo/algorithms_on_compressed_graph",      test_algorithms_on_compressed_graph },
+    { "algo/kernel_widths_agree",                 test_kernel_widths_agree },
+    { "algo/queries_see_live_updates",            test_queries_see_live_updates },
+    { "algo/queue_backends_agree",                test_queue_backends_agree },
+    { "algo/queue_auto_selection",                test_queue_auto_selection },
+    { "algo/search_context_reuse",                test_search_context_reuse },
+    { "algo/bidirectional_dijkstra",              test_bidirectional_dijkstra },
+    { "algo/bidirectional_astar",                 test_bidirectional_astar },
+    { "algo/landmark_heuristic",                  test_landmark_heuristic },
+    { "algo/contraction_hierarchy",               test_contraction_hierarchy },
+    { "algo/customizable_ch",                     test_customizable_ch },
+    { "algo/parallel_team",                       test_parallel_team },
+    { "algo/hub_labels",                          test_hub_labels },
+    { "algo/arc_flags",                           test_arc_flags },
+    { "algo/crp_overlay",                         test_crp_overlay },
+    { "algo/transit_nodes",                       test_transit_nodes },
+    { "algo/one_to_all",                          test_one_to_all },
+    { "algo/distance_matrix",                     test_distance_matrix },
+    { "algo/search_session",                      test_search_session },
+
+    // File I/O
+    { "io/snapshot_round_trip",                   test_snapshot_round_trip },
+    { "io/snapshot_invalid_file",                 test_snapshot_invalid_file },
+    { "io/snapshot_corrupt_sections",             test_snapshot_corrupt_sections },
+    { "io/snapshot_keeps_vertex_order",           test_snapshot_keeps_vertex_order },
+    { "io/snapshot_live_updates",                 test_snapshot_live_updates },
+    { "io/landmarks_round_trip",                  test_landmarks_round_trip },
 
     { NULL, NULL }
 };
\ No newline at end of file
@@ -2,8 +2,22 @@
 #include "acutest.h"
 #include <test_common.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "../include/graph.h"
 #include "../include/algorithms.h"
+#include "../include/reorder.h"
+#include "../include/landmarks.h"
+#include "../include/ch.h"
+#include "../include/cch.h"
+#include "../include/hub_labels.h"
+#include "../include/arc_flags.h"
+#include "../include/crp.h"
+#include "../include/tnr.h"
+#include "../include/phast.h"
+#include "../include/distance_matrix.h"
+#include "../include/search_session.h"
+#include "../include/parallel.h"
 
 /* Helper to create a small connected graph (used in many tests) */
 static Graph* create_small_test_graph(void) {
@@ -91,7 +105,7 @@ void test_dijkstra_basic(void) {
     TEST_ASSERT_(g != NULL, "failed to create test graph");
 
     int path[10] = {0};
-    int dist = -1;
+    long long dist = -1;
     int len = dijkstra_shortest_path(g, 0, 3, path, 10, &dist);
 
     TEST_CHECK_(len == 4 || len == 3,
@@ -121,7 +135,7 @@ void test_dijkstra_zero_weight(void) {
     addWeightedEdge(g, 1, 3, 1, 1);
 
     int path[10] = {0};
-    int dist = -1;
+    long long dist = -1;
     int len = dijkstra_shortest_path(g, 0, 3, path, 10, &dist);
 
     TEST_CHECK_(len == 3, "path length should be 3 (0→1→3)");
@@ -137,7 +151,7 @@ void test_astar_equals_dijkstra_when_no_heuristic(void) {
     TEST_ASSERT_(g != NULL, "failed to create test graph");
 
     int path_d[10] = {0}, path_a[10] = {0};
-    int dist_d = -1, dist_a = -1;
+    long long dist_d = -1, dist_a = -1;
 
     int len_d = dijkstra_shortest_path(g, 0, 5, path_d, 10, &dist_d);
     int len_a = astar_shortest_path(g, 0, 5, path_a, 10, &dist_a, NULL);
@@ -159,7 +173,7 @@ void test_dijkstra_unique_best_path(void) {
     addWeightedEdge(g, 2, 3, 10, 0);
 
     int path[10] = {0};
-    int dist = -1;
+    long long dist = -1;
     int len = dijkstra_shortest_path(g, 0, 3, path, 10, &dist);
 
     TEST_CHECK_(len == 3, "path length should be 3 vertices");
@@ -186,7 +200,7 @@ void test_astar_manhattan(void) {
     }
 
     int path[30] = {0};
-    int dist = -1;
+    long long dist = -1;
     int len = astar_shortest_path(g, 0, 24, path, 30,
                                   &dist, simple_manhattan_heuristic);
 
@@ -215,7 +229,7 @@ void test_astar_euclidean(void) {
     }
 
     int path_m[30] = {0}, path_e[30] = {0};
-    int dist_m = -1, dist_e = -1;
+    long long dist_m = -1, dist_e = -1;
 
     int len_e = astar_shortest_path(g, 0, 24, path_e, 30,
                                     &dist_e, simple_euclidean_heuristic);
@@ -247,7 +261,7 @@ void test_dijkstra_large_graph(void) {
     addWeightedEdge(g, 15, 25, 3, 0);
 
     int path[40] = {0};
-    int dist = -1;
+    long long dist = -1;
     int len = dijkstra_shortest_path(g, 0, 29, path, 40, &dist);
 
     TEST_CHECK_(len > 0, "path from 0 to 29 should exist");
@@ -269,7 +283,7 @@ void test_bellman_ford_negative_weight(void) {
     addWeightedEdge(g, 0, 3, 8, 0);
 
     int path[10] = {0};
-    int dist = -1;
+    long long dist = -1;
     int len = bellman_ford_shortest_path(g, 0, 3, path, 10, &dist);
 
     TEST_CHECK_(len > 0, "Bellman-Ford should find a path");
@@ -289,7 +303,7 @@ void test_bellman_ford_negative_cycle(void) {
     addWeightedEdge(g, 2, 1, -3, 0); /* negative cycle 1 ↔ 2 */
 
     int path[10] = {0};
-    int dist = 999;
+    long long dist = 999;
     int len = bellman_ford_shortest_path(g, 0, 2, path, 10, &dist);
 
     TEST_CHECK_(len == 0,
@@ -306,6 +320,7 @@ void test_invalid_inputs(void) {
 
     int path[5] = {0};
     int dist = 999;
+    long long cost = 999;
 
     /* Invalid vertex indices */
     TEST_CHECK_(bfs_shortest_hops(g, -1, 1, path, 5, &dist) == 0,
@@ -314,9 +329,9 @@ void test_invalid_inputs(void) {
                 "out-of-range goal rejected");
 
     /* NULL graph */
-    TEST_CHECK_(dijkstra_shortest_path(NULL, 0, 1, path, 5, &dist) == 0,
+    TEST_CHECK_(dijkstra_shortest_path(NULL, 0, 1, path, 5, &cost) == 0,
                 "NULL graph rejected");
-    TEST_CHECK_(bellman_ford_shortest_path(NULL, 0, 2, path, 5, &dist) == 0,
+    TEST_CHECK_(bellman_ford_shortest_path(NULL, 0, 2, path, 5, &cost) == 0,
                 "NULL graph rejected");
 
     /* Small buffer */
@@ -336,7 +351,7 @@ void test_path_buffer_overflow(void) {
     }
 
     int path[5] = {0}; /* buffer too small for 15-vertex path */
-    int dist = -1;
+    long long dist = -1;
     int len = dijkstra_shortest_path(g, 0, 14, path, 5, &dist);
 
     TEST_CHECK_(len == 0, "should return 0 when path buffer is too small");
@@ -344,4 +359,1116 @@ void test_path_buffer_overflow(void) {
     TEST_CHECK_(path[0] == 0, "path[0] should remain unchanged on failure");
 
     graph_free(g);
-}
\ No newline at end of file
+}
+/* renumbering vertices must not change answers expressed in external IDs */
+
+void test_reorder_preserves_results(void) {
+    VertexOrder orders[] = { ORDER_BFS, ORDER_RCM, ORDER_HILBERT };
+
+    for (int o = 0; o < 3; o++) {
+        Graph *g = createGraph(30);
+        TEST_ASSERT_(g != NULL, "failed to create graph");
+
+        for (int i = 0; i < 30; i++) {
+            if (i % 6 != 5) addWeightedEdge(g, i, i + 1, 1 + i % 3, 1);
+            if (i < 24)     addWeightedEdge(g, i, i + 6, 2, 1);
+            graphSetCoordinates(g, i, i % 6, i / 6);
+        }
+        graphSetName(g, 29, "Corner");
+
+        int path_ref[40], path[40];
+        long long dist_ref = -1, dist = -1;
+        int len_ref = dijkstra_shortest_path(g, 29, 0, path_ref, 40, &dist_ref);
+
+        TEST_ASSERT_(graph_reorder(g, orders[o]) == 0, "reorder should succeed");
+        TEST_CHECK_(g->toInternal != NULL && g->toExternal != NULL,
+                    "ID maps allocated");
+
+        int len = dijkstra_shortest_path(g, 29, 0, path, 40, &dist);
+        TEST_CHECK_(len == len_ref && dist == dist_ref,
+                    "same length and distance after reorder");
+        TEST_CHECK_(path[0] == 29 && path[len - 1] == 0,
+                    "path endpoints are external IDs");
+        TEST_CHECK_(strcmp(graphGetName(g, 29), "Corner") == 0,
+                    "names still addressed by external ID");
+
+        /* edges added after reordering land in the same internal order */
+        addWeightedEdge(g, 29, 0, 1, 0);
+        len = dijkstra_shortest_path(g, 29, 0, path, 40, &dist);
+        TEST_CHECK_(len == 2 && dist == 1, "new edge visible after refreeze");
+
+        graph_free(g);
+    }
+
+    Graph *g = createGraph(3);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+    TEST_CHECK_(graph_reorder(g, ORDER_HILBERT) == -1,
+                "hilbert order needs coordinates");
+    graph_free(g);
+}
+
+/* all algorithms give the same answers on the compressed layout */
+
+void test_algorithms_on_compressed_graph(void) {
+    Graph *g = create_small_test_graph();
+    Graph *c = create_small_test_graph();
+    TEST_ASSERT_(g != NULL && c != NULL, "failed to create test graphs");
+    TEST_ASSERT_(graph_drop_builder(c) == 0 && graph_compress(c) == 0,
+                 "compress should succeed");
+
+    int path[10];
+    long long d1 = -1, d2 = -1;
+    dijkstra_shortest_path(g, 0, 5, path, 10, &d1);
+    dijkstra_shortest_path(c, 0, 5, path, 10, &d2);
+    TEST_CHECK_(d1 == d2 && d2 == 10, "Dijkstra distance unchanged");
+
+    astar_shortest_path(c, 0, 3, path, 10, &d2, NULL);
+    TEST_CHECK_(d2 == 5, "A* distance unchanged");
+
+    bellman_ford_shortest_path(c, 0, 3, path, 10, &d2);
+    TEST_CHECK_(d2 == 5, "Bellman-Ford distance unchanged");
+
+    int hops = -1;
+    bfs_shortest_hops(c, 0, 3, path, 10, &hops);
+    TEST_CHECK_(hops == 2, "BFS hops unchanged");
+
+    TEST_CHECK_(dfs_path(c, 0, 5, path, 10) >= 3, "DFS still finds a path");
+
+    addWeightedEdge(c, 0, 5, 1, 0);
+    dijkstra_shortest_path(c, 0, 5, path, 10, &d2);
+    TEST_CHECK_(d2 == 10, "builder dropped: insertions ignored");
+
+    graph_free(g);
+    graph_free(c);
+
+    /* Undirected: the backward searches need a transpose of the compressed edges */
+    const int w = 10, n = w * w;
+    g = createGraph(n);
+    c = createGraph(n);
+    TEST_ASSERT_(g != NULL && c != NULL, "failed to create grids");
+    for (int v = 0; v < n; v++) {
+        if (v % w + 1 < w) {
+            addWeightedEdge(g, v, v + 1, 1 + (v * 7) % 5, 1);
+            addWeightedEdge(c, v, v + 1, 1 + (v * 7) % 5, 1);
+        }
+        if (v + w < n) {
+            addWeightedEdge(g, v, v + w, 1 + (v * 3) % 4, 1);
+            addWeightedEdge(c, v, v + w, 1 + (v * 3) % 4, 1);
+        }
+    }
+    TEST_ASSERT_(graph_compress(c) == 0, "compress should succeed");
+    const GraphCSR *rev = graph_reverse(c);
+    TEST_CHECK_(rev != NULL && rev != &c->csr && rev->targets != NULL, "compressed graph gets its own transpose");
+
+    Landmarks *lm = landmarks_build(c, 3, LANDMARKS_FARTHEST);
+    TEST_ASSERT_(lm != NULL, "landmarks build on the compressed graph");
+    landmarks_set_active(lm);
+    int grid_path[10 * 10];
+    for (int s = 0; s < n; s += 7) {
+        for (int t = 0; t < n; t += 11) {
+            long long d = -1, b = -1, a = -1;
+            dijkstra_shortest_path(g, s, t, grid_path, n, &d);
+            bidirectional_dijkstra_shortest_path(c, s, t, grid_path, n, &b);
+            astar_shortest_path(c, s, t, grid_path, n, &a, landmark_heuristic);
+            TEST_CHECK_(b == d && a == d, "%d→%d: Dijkstra %lld, bidirectional %lld, ALT %lld", s, t, d, b, a);
+        }
+    }
+    landmarks_set_active(NULL);
+    landmarks_free(lm);
+
+    graph_free(g);
+    graph_free(c);
+}
+
+/* every kernel width gives the same answers; 64-bit distances do not overflow */
+
+void test_kernel_widths_agree(void) {
+    static const int widths[][2] = { {0, 0}, {16, 32}, {16, 64}, {32, 32}, {32, 64}, {64, 64} };
+    long long ref_d = -1, ref_a = -1, ref_b = -1;
+
+    for (size_t k = 0; k < sizeof(widths) / sizeof(widths[0]); k++) {
+        Graph *g = create_small_test_graph();
+        addWeightedEdge(g, 5, 3, -2, 0);
+        TEST_ASSERT_(graph_select_widths(g, widths[k][0], widths[k][1]) == 0,
+                     "width selection should succeed");
+
+        int path[10];
+        long long d = -1, a = -1, b = -1;
+        dijkstra_shortest_path(g, 0, 5, path, 10, &d);
+        astar_shortest_path(g, 0, 3, path, 10, &a, NULL);
+        bellman_ford_shortest_path(g, 0, 3, path, 10, &b);
+
+        if (k == 0) {
+            ref_d = d;
+            ref_a = a;
+            ref_b = b;
+            TEST_CHECK_(g->csr.weightBits == 16 && g->distBits == 16, "automatic choice is 16/16");
+        }
+        TEST_CHECK_(d == ref_d && a == ref_a && b == ref_b, "same distances for every width");
+        TEST_MSG("weight %d / dist %d bits: %lld %lld %lld", widths[k][0], widths[k][1], d, a, b);
+
+        graph_free(g);
+    }
+    TEST_CHECK_(ref_d == 10 && ref_a == 5 && ref_b == 5, "expected reference distances");
+
+    /* continent-scale costs: the sum no longer fits in 32 bits */
+    Graph *g = createGraph(4);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+    addWeightedEdge(g, 0, 1, 2000000000, 0);
+    addWeightedEdge(g, 1, 2, 2000000000, 0);
+    addWeightedEdge(g, 2, 3, 2000000000, 0);
+
+    int path[4];
+    long long d = -1;
+    TEST_CHECK_(dijkstra_shortest_path(g, 0, 3, path, 4, &d) == 4, "Dijkstra finds the path");
+    TEST_CHECK_(g->csr.weightBits == 32 && g->distBits == 64, "32-bit weights, 64-bit distances");
+    TEST_CHECK_(d == 6000000000LL, "distance is exact");
+    TEST_CHECK_(bellman_ford_shortest_path(g, 0, 3, path, 4, &d) == 4 && d == 6000000000LL,
+                "Bellman-Ford distance is exact");
+
+    TEST_ASSERT_(graph_drop_builder(g) == 0 && graph_compress(g) == 0, "compress should succeed");
+    TEST_CHECK_(astar_shortest_path(g, 0, 3, path, 4, &d, NULL) == 4 && d == 6000000000LL,
+                "A* on the compressed layout is exact");
+
+    graph_free(g);
+}
+
+/* queries pick up live updates without rebuilding the graph */
+
+void test_queries_see_live_updates(void) {
+    Graph *g = create_small_test_graph();
+    int path[10];
+    long long d = -1;
+
+    TEST_ASSERT_(dijkstra_shortest_path(g, 0, 5, path, 10, &d) > 0 && d == 10, "baseline 0→5 = 10");
+
+    /* close 4→5, open 3→5 */
+    TEST_ASSERT_(graph_delete_edge(g, 4, 5) == 0 && graph_insert_edge(g, 3, 5, 1) == 0,
+                 "updates should apply");
+    int len = dijkstra_shortest_path(g, 0, 5, path, 10, &d);
+    TEST_CHECK_(len > 0 && d == 6 && path[len - 2] == 3, "Dijkstra routes over the new edge");
+    TEST_CHECK_(astar_shortest_path(g, 0, 5, path, 10, &d, NULL) > 0 && d == 6, "A* agrees");
+    TEST_CHECK_(bellman_ford_shortest_path(g, 0, 5, path, 10, &d) > 0 && d == 6, "Bellman-Ford agrees");
+
+    /* a huge weight widens the distance accumulators on the fly */
+    TEST_ASSERT_(graph_set_edge_weight(g, 3, 5, 4000000000LL) == 0, "reweight should apply");
+    TEST_CHECK_(dijkstra_shortest_path(g, 0, 5, path, 10, &d) > 0 && d == 4000000005LL,
+                "64-bit distance through a reweighted edge");
+
+    TEST_CHECK_(graph_compact(g, 1) == 0 && graph_compact_wait(g) == 0, "background compaction");
+    TEST_CHECK_(g->csr.weightBits == 64 && g->distBits == 64, "compacted base widened");
+    TEST_CHECK_(dijkstra_shortest_path(g, 0, 5, path, 10, &d) > 0 && d == 4000000005LL,
+                "same answer after compaction");
+
+    graph_free(g);
+}
+
+/* every queue backend pops in key order and gives Dijkstra/A* the same answers */
+
+void test_queue_backends_agree(void) {
+    static const PQueueKind kinds[] = { PQ_BINARY_HEAP, PQ_LINEAR_SCAN, PQ_DIAL, PQ_RADIX_HEAP };
+    static const char *names[] = { "heap", "scan", "dial", "radix" };
+    long long ref[30];
+
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        PQueue *pq = pqueue_create(kinds[k], 8, 64);
+        TEST_ASSERT_(pq != NULL, "queue creation should succeed");
+
+        pqueue_push(pq, 3, 30);
+        pqueue_push(pq, 5, 10);
+        pqueue_push(pq, 1, 20);
+        pqueue_push(pq, 3, 5);      /* decrease-key */
+        pqueue_push(pq, 5, 50);     /* higher key is ignored */
+        TEST_CHECK_(pq->size == 3, "each node is queued once");
+        TEST_CHECK_(pqueue_push(pq, 8, 1) == -1, "out-of-range node is rejected");
+
+        static const int order[] = { 3, 5, 1 };
+        static const long long keys[] = { 5, 10, 20 };
+        for (int i = 0; i < 3; i++) {
+            int node;
+            long long key;
+            TEST_CHECK_(pqueue_pop(pq, &node, &key) == 0 && node == order[i] && key == keys[i],
+                        "%s pops in key order", pq->ops->name);
+        }
+        int node;
+        long long key;
+        TEST_CHECK_(pqueue_pop(pq, &node, &key) == -1, "empty queue");
+        if (pq->ops->monotone) {
+            TEST_CHECK_(pqueue_push(pq, 0, 19) == -1, "%s rejects a key below the last pop",
+                        pq->ops->name);
+        }
+        if (kinds[k] == PQ_DIAL) {
+            TEST_CHECK_(pqueue_push(pq, 0, 20 + 65) == -1, "key beyond the bucket ring is rejected");
+        }
+        pqueue_destroy(pq);
+
+        Graph *g = createGraph(30);
+        TEST_ASSERT_(g != NULL, "failed to create graph");
+        for (int i = 0; i < 29; i++) {
+            if (i % 6 != 5) addWeightedEdge(g, i, i + 1, 1 + i % 4, 0);
+            if (i < 24)     addWeightedEdge(g, i, i + 6, 1 + i % 3, 0);
+        }
+        addWeightedEdge(g, 0, 10, 5, 0);
+        addWeightedEdge(g, 15, 25, 3, 0);
+
+        search_set_queue(kinds[k]);
+        for (int goal = 0; goal < 30; goal++) {
+            int path[40];
+            long long d = -1, a = -1;
+            dijkstra_shortest_path(g, 0, goal, path, 40, &d);
+            astar_shortest_path(g, 0, goal, path, 40, &a, NULL);
+            if (k == 0) ref[goal] = d;
+            TEST_CHECK_(d == ref[goal] && a == ref[goal], "same distance to %d with %s", goal, names[k]);
+        }
+        graph_free(g);
+    }
+    search_set_queue(PQ_AUTO);
+}
+
+/* PQ_AUTO follows the largest weight; the radix heap handles 64-bit keys */
+
+void test_queue_auto_selection(void) {
+    TEST_CHECK_(pqueue_kind_for_max_weight(0) == PQ_DIAL, "unit weights use buckets");
+    TEST_CHECK_(pqueue_kind_for_max_weight(PQ_DIAL_MAX_WEIGHT) == PQ_DIAL, "small weights use buckets");
+    TEST_CHECK_(pqueue_kind_for_max_weight(PQ_DIAL_MAX_WEIGHT + 1) == PQ_RADIX_HEAP, "large weights use radix");
+
+    Graph *g = create_small_test_graph();
+    TEST_CHECK_(graph_max_weight(g) == 7, "max weight recorded at freeze");
+    TEST_ASSERT_(graph_insert_edge(g, 3, 5, 5000000000LL) == 0, "update should apply");
+    TEST_CHECK_(graph_max_weight(g) == 5000000000LL, "overlay raises the max weight");
+
+    int path[10];
+    long long d = -1;
+    TEST_CHECK_(dijkstra_shortest_path(g, 0, 5, path, 10, &d) > 0 && d == 10, "auto queue on mixed weights");
+    TEST_ASSERT_(graph_delete_edge(g, 4, 5) == 0, "update should apply");
+    TEST_CHECK_(dijkstra_shortest_path(g, 0, 5, path, 10, &d) > 0 && d == 5000000005LL,
+                "radix heap reaches 64-bit distances");
+    graph_free(g);
+
+    /* pseudo-random monotone workload against the binary heap */
+    PQueue *heap = pqueue_create(PQ_BINARY_HEAP, 256, 0);
+    PQueue *radix = pqueue_create(PQ_RADIX_HEAP, 256, 0);
+    TEST_ASSERT_(heap && radix, "queue creation should succeed");
+
+    unsigned long long seed = 12345;
+    long long last = 0;
+    int mismatches = 0;
+    for (int round = 0; round < 2000; round++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        int node = (int)((seed >> 33) % 256);
+        /* low byte = node keeps keys unique, so both queues pop the same node */
+        long long step = 1 + (long long)((seed >> 20) % (1ULL << ((seed >> 8) % 40)));
+        long long key = (((last >> 8) + step) << 8) | node;
+        pqueue_push(heap, node, key);
+        pqueue_push(radix, node, key);
+
+        if (round % 3 == 2) {
+            int hn, rn;
+            long long hk, rk;
+            if (pqueue_pop(heap, &hn, &hk) == 0) {
+                if (pqueue_pop(radix, &rn, &rk) != 0 || rk != hk) mismatches++;
+                last = hk;
+            }
+        }
+    }
+    TEST_CHECK_(heap->size == radix->size, "same number of queued nodes");
+    TEST_CHECK_(mismatches == 0, "radix heap pops the same keys as the binary heap");
+    pqueue_destroy(heap);
+    pqueue_destroy(radix);
+}
+
+/* a bound context is reused across queries and survives generation wrap-around */
+
+void test_search_context_reuse(void) {
+    Graph *g = create_small_test_graph();
+    SearchContext *ctx = search_context_create(2);
+    TEST_ASSERT_(ctx != NULL, "context creation should succeed");
+    TEST_CHECK_(search_context_bind(ctx) == NULL, "default context was in use");
+
+    int path[10];
+    long long d = -1;
+    int hops = -1;
+    TEST_CHECK_(dijkstra_shortest_path(g, 0, 3, path, 10, &d) > 0 && d == 5, "query grows the context");
+    TEST_CHECK_(ctx->capacity >= 6, "context holds every vertex");
+
+    const unsigned int *stamp = ctx->stamp;
+    const PQueue *queue = ctx->queue;
+    for (int round = 0; round < 20; round++) {
+        long long a = -1, b = -1;
+        TEST_CHECK_(dijkstra_shortest_path(g, 0, 5, path, 10, &d) > 0 && d == 10, "Dijkstra 0→5");
+        TEST_CHECK_(bfs_shortest_hops(g, 0, 3, path, 10, &hops) > 0 && hops == 2, "BFS 0→3");
+        TEST_CHECK_(dfs_path(g, 0, 5, path, 10) > 0, "DFS 0→5");
+        TEST_CHECK_(bellman_ford_shortest_path(g, 0, 3, path, 10, &b) > 0 && b == 5, "Bellman-Ford 0→3");
+        TEST_CHECK_(astar_shortest_path(g, 0, 3, path, 10, &a, NULL) > 0 && a == 5, "A* 0→3");
+        TEST_CHECK_(dijkstra_shortest_path(g, 5, 0, path, 10, &d) == 0 && d == -1,
+                    "stale stamps from earlier queries do not leak in");
+    }
+    TEST_CHECK_(ctx->stamp == stamp && ctx->queue == queue, "no reallocation between queries");
+
+    /* wrap the generation counter mid-sequence */
+    ctx->generation = UINT_MAX - 2;
+    for (int round = 0; round < 5; round++) {
+        TEST_CHECK_(dijkstra_shortest_path(g, 0, 3, path, 10, &d) > 0 && d == 5,
+                    "distance stays correct across wrap (round %d)", round);
+        TEST_CHECK_(bfs_shortest_hops(g, 0, 5, path, 10, &hops) > 0 && hops == 3, "BFS across wrap");
+    }
+    TEST_CHECK_(ctx->generation > 0 && ctx->generation < 16, "generation restarted after wrap");
+
+    TEST_CHECK_(search_context_bind(NULL) == ctx, "bound context is returned");
+    search_context_free(ctx);
+    graph_free(g);
+}
+
+/* bidirectional Dijkstra matches Dijkstra on every pair and settles fewer vertices */
+
+void test_bidirectional_dijkstra(void) {
+    const int w = 12, n = w * w;
+    Graph *g = createGraph(n);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    /* grid with one-way streets, so the backward search needs incoming edges */
+    for (int v = 0; v < n; v++) {
+        int x = v % w, y = v / w;
+        if (x + 1 < w) addWeightedEdge(g, v, v + 1, 1 + (v * 7) % 5, y % 3 != 0);
+        if (y + 1 < w) addWeightedEdge(g, v, v + w, 1 + (v * 3) % 4, x % 4 != 1);
+    }
+
+    int path[144], bpath[144];
+    for (int s = 0; s < n; s += 13) {
+        for (int t = 0; t < n; t += 7) {
+            long long d = -1, b = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            int blen = bidirectional_dijkstra_shortest_path(g, s, t, bpath, n, &b);
+            TEST_CHECK_(d == b && (len > 0) == (blen > 0), "%d→%d: %lld vs %lld", s, t, d, b);
+            if (blen > 0) {
+                TEST_CHECK_(bpath[0] == s && bpath[blen - 1] == t, "path endpoints %d→%d", s, t);
+            }
+        }
+    }
+
+    long long d = -1, b = -1;
+    dijkstra_shortest_path(g, 0, n - 1, path, n, &d);
+    int one_way = search_last_settled();
+    int blen = bidirectional_dijkstra_shortest_path(g, 0, n - 1, bpath, n, &b);
+    int two_way = search_last_settled();
+    TEST_CHECK_(blen > 0 && b == d, "corner to corner");
+    TEST_CHECK_(two_way < one_way, "bidirectional settles fewer (%d vs %d)", two_way, one_way);
+
+    /* the path's edge weights add up to the distance */
+    long long sum = 0;
+    for (int i = 0; i + 1 < blen; i++) {
+        long long best = -1;
+        GraphEdgeIter it;
+        int u = graph_to_internal(g, bpath[i]), v = graph_to_internal(g, bpath[i + 1]);
+        for (graph_edges_begin(g, u, &it); graph_edges_next(&it); ) {
+            if (it.to == v && (best < 0 || it.weight < best)) best = it.weight;
+        }
+        sum += best;
+    }
+    TEST_CHECK_(sum == b, "path weight %lld equals distance %lld", sum, b);
+
+    /* live updates reach the backward search through the cached base transpose */
+    const GraphCSR *rev = graph_reverse(g);
+    TEST_ASSERT_(graph_insert_edge(g, 0, n - 1, 3) == 0, "update should apply");
+    TEST_CHECK_(bidirectional_dijkstra_shortest_path(g, 0, n - 1, bpath, n, &b) == 2 && b == 3,
+                "shortcut is found");
+    TEST_ASSERT_(graph_delete_edge(g, 0, n - 1) == 0 && graph_delete_edge(g, 0, 1) == 0 &&
+                 graph_set_edge_weight(g, 0, w, 40) == 0 && graph_insert_edge(g, 5, 3 * w, 1) == 0,
+                 "updates should apply");
+    TEST_CHECK_(graph_reverse(g) == rev, "updates keep the cached transpose");
+    for (int s = 0; s < n; s += 11) {
+        for (int t = 0; t < n; t += 5) {
+            long long d = -1;
+            dijkstra_shortest_path(g, s, t, path, n, &d);
+            bidirectional_dijkstra_shortest_path(g, s, t, bpath, n, &b);
+            TEST_CHECK_(d == b, "after updates %d→%d: %lld vs %lld", s, t, d, b);
+        }
+    }
+    TEST_CHECK_(bidirectional_dijkstra_shortest_path(g, 5, 5, bpath, n, &b) == 1 && b == 0,
+                "start == goal");
+
+    graph_free(g);
+}
+
+/* bidirectional A* stays exact with a consistent heuristic and settles fewer vertices */
+
+#define BIASTAR_WIDTH 24
+
+/* 4 × Manhattan distance: consistent, since every edge costs at least 4 */
+static int grid_heuristic(int a, int b) {
+    return 4 * (abs(a % BIASTAR_WIDTH - b % BIASTAR_WIDTH) + abs(a / BIASTAR_WIDTH - b / BIASTAR_WIDTH));
+}
+
+void test_bidirectional_astar(void) {
+    const int w = BIASTAR_WIDTH, n = w * w;
+    Graph *g = createGraph(n);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    for (int v = 0; v < n; v++) {
+        int x = v % w, y = v / w;
+        if (x + 1 < w) addWeightedEdge(g, v, v + 1, 4 + (v * 7) % 3, y % 3 != 0);
+        if (y + 1 < w) addWeightedEdge(g, v, v + w, 4 + (v * 3) % 4, x % 4 != 1);
+    }
+
+    int path[BIASTAR_WIDTH * BIASTAR_WIDTH], bpath[BIASTAR_WIDTH * BIASTAR_WIDTH];
+    for (int s = 0; s < n; s += 29) {
+        for (int t = 0; t < n; t += 17) {
+            long long d = -1, b = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            int blen = bidirectional_astar_shortest_path(g, s, t, bpath, n, &b, grid_heuristic);
+            TEST_CHECK_(d == b && (len > 0) == (blen > 0), "%d→%d: %lld vs %lld", s, t, d, b);
+            if (blen > 0) {
+                TEST_CHECK_(bpath[0] == s && bpath[blen - 1] == t, "path endpoints %d→%d", s, t);
+            }
+        }
+    }
+
+    long long d = -1, a = -1, b = -1;
+    bidirectional_dijkstra_shortest_path(g, w - 1, n - w, path, n, &d);
+    int bidijkstra = search_last_settled();
+    astar_shortest_path(g, w - 1, n - w, path, n, &a, grid_heuristic);
+    int astar = search_last_settled();
+    int blen = bidirectional_astar_shortest_path(g, w - 1, n - w, bpath, n, &b, grid_heuristic);
+    int biastar = search_last_settled();
+    TEST_CHECK_(blen > 0 && b == d && a == d, "corner to corner");
+    TEST_CHECK_(biastar < bidijkstra, "fewer settled than bidirectional Dijkstra (%d vs %d)", biastar, bidijkstra);
+    TEST_CHECK_(biastar <= astar, "no more settled than A* (%d vs %d)", biastar, astar);
+    TEST_MSG("settled: A* %d, bidirectional Dijkstra %d, bidirectional A* %d", astar, bidijkstra, biastar);
+
+    TEST_CHECK_(bidirectional_astar_shortest_path(g, 7, 7, bpath, n, &b, grid_heuristic) == 1 && b == 0,
+                "start == goal");
+    TEST_CHECK_(bidirectional_astar_shortest_path(g, 0, n - 1, bpath, n, &b, NULL) > 0,
+                "NULL heuristic runs bidirectional Dijkstra");
+
+    graph_free(g);
+}
+
+/* ALT: landmark bounds never overestimate and make A* settle fewer vertices */
+
+void test_landmark_heuristic(void) {
+    const int w = 16, n = w * w + 1;   /* plus one isolated vertex */
+    Graph *g = createGraph(n);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    for (int v = 0; v < w * w; v++) {
+        int x = v % w, y = v / w;
+        if (x + 1 < w) addWeightedEdge(g, v, v + 1, 1 + (v * 7) % 5, y % 3 != 0);
+        if (y + 1 < w) addWeightedEdge(g, v, v + w, 1 + (v * 3) % 4, x % 4 != 1);
+    }
+
+    static const LandmarkStrategy strategies[] = { LANDMARKS_FARTHEST, LANDMARKS_AVOID };
+    int path[16 * 16 + 1];
+    for (int k = 0; k < 2; k++) {
+        Landmarks *lm = landmarks_build(g, 4, strategies[k]);
+        TEST_ASSERT_(lm != NULL && lm->count == 4, "landmarks should build (strategy %d)", k);
+        landmarks_set_active(lm);
+
+        for (int s = 0; s < n; s += 11) {
+            for (int t = 0; t < n; t += 13) {
+                long long d = -1, a = -1, b = -1;
+                dijkstra_shortest_path(g, s, t, path, n, &d);
+                astar_shortest_path(g, s, t, path, n, &a, landmark_heuristic);
+                bidirectional_astar_shortest_path(g, s, t, path, n, &b, landmark_heuristic);
+                TEST_CHECK_(a == d && b == d, "%d→%d: Dijkstra %lld, ALT %lld, bidirectional ALT %lld", s, t, d, a, b);
+                TEST_CHECK_(d < 0 || landmarks_lower_bound(lm, s, t) <= d,
+                            "bound %lld ≤ %lld for %d→%d", landmarks_lower_bound(lm, s, t), d, s, t);
+            }
+        }
+
+        long long d = -1, a = -1;
+        dijkstra_shortest_path(g, w - 1, w * (w - 1), path, n, &d);
+        int plain = search_last_settled();
+        astar_shortest_path(g, w - 1, w * (w - 1), path, n, &a, landmark_heuristic);
+        int alt = search_last_settled();
+        TEST_CHECK_(a == d && alt < plain, "ALT settles fewer (%d vs %d)", alt, plain);
+
+        landmarks_set_active(NULL);
+        landmarks_free(lm);
+    }
+    TEST_CHECK_(landmark_heuristic(0, 5) == 0, "no active set gives 0");
+
+    addWeightedEdge(g, 0, 1, -2, 0);
+    TEST_CHECK_(landmarks_build(g, 2, LANDMARKS_FARTHEST) == NULL, "negative weights are rejected");
+    graph_free(g);
+
+    /* A lowered weight can make old bounds overestimate: stale sets are refused */
+    g = build_oneway_grid(8, 5, 1);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+    Landmarks *lm = landmarks_build(g, 2, LANDMARKS_FARTHEST);
+    TEST_ASSERT_(lm != NULL && landmarks_current(lm, g), "fresh set is current");
+    landmarks_set_active(lm);
+    TEST_ASSERT_(graph_set_edge_weight(g, 0, 1, 0) == 0, "update applies");
+    long long d = -1, a = 0, b = 0;
+    TEST_CHECK_(!landmarks_current(lm, g), "set is stale after an update");
+    TEST_CHECK_(astar_shortest_path(g, 0, 62, path, 64, &a, landmark_heuristic) == 0 && a == -1,
+                "ALT refuses a stale set");
+    TEST_CHECK_(bidirectional_astar_shortest_path(g, 0, 62, path, 64, &b, landmark_heuristic) == 0 && b == -1,
+                "bidirectional ALT refuses a stale set");
+    TEST_CHECK_(search_session_create(g, 0, landmark_heuristic) == NULL, "sessions refuse a stale set");
+    TEST_CHECK_(astar_shortest_path(g, 0, 62, path, 64, &a, NULL) > 0 &&
+                dijkstra_shortest_path(g, 0, 62, path, 64, &d) > 0 && a == d,
+                "plain A* still runs");
+    landmarks_set_active(NULL);
+    landmarks_free(lm);
+    graph_free(g);
+}
+
+/* contraction hierarchy queries match Dijkstra, and unpacked paths are real edge sequences */
+
+void test_contraction_hierarchy(void) {
+    const int w = 14, n = w * w;
+    Graph *g = build_oneway_grid(w, 0, 0);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    /* plus parallel edges */
+    for (int v = 0; v + 1 < n - 1; v += 9) {
+        if (v % w + 1 < w) addWeightedEdge(g, v, v + 1, 1, 0);
+    }
+
+    ContractionHierarchy *ch = ch_build(g);
+    TEST_ASSERT_(ch != NULL, "hierarchy should build");
+
+    int path[14 * 14], cpath[14 * 14];
+    for (int s = 0; s < n; s += 5) {
+        for (int t = 0; t < n; t += 7) {
+            long long d = -1, c = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            int clen = ch_shortest_path(ch, g, s, t, cpath, n, &c);
+            TEST_CHECK_(d == c && (len > 0) == (clen > 0), "%d→%d: %lld vs %lld", s, t, d, c);
+            if (clen > 0) check_path_weight(g, cpath, clen, s, t, c);
+        }
+    }
+
+    long long d = -1, c = -1;
+    dijkstra_shortest_path(g, 0, n - 2, path, n, &d);
+    int plain = search_last_settled();
+    ch_shortest_path(ch, g, 0, n - 2, cpath, n, &c);
+    int hierarchy = search_last_settled();
+    TEST_CHECK_(c == d && hierarchy < plain, "CH settles fewer (%d vs %d)", hierarchy, plain);
+    TEST_CHECK_(ch_shortest_path(ch, g, 3, 3, cpath, n, &c) == 1 && c == 0, "start == goal");
+    TEST_CHECK_(ch_shortest_path(ch, g, 3, 3, cpath, 1, &c) == 1 && c == 0 && cpath[0] == 3, "start == goal fits one slot");
+    TEST_CHECK_(ch_shortest_path(ch, g, 0, n - 2, cpath, 2, &c) == 0, "short buffer fails cleanly");
+
+    /* Edge changes make the hierarchy stale */
+    TEST_CHECK_(graph_set_edge_weight(g, w, w + 1, 9) == 0, "weight update");
+    TEST_CHECK_(ch_shortest_path(ch, g, 0, n - 2, cpath, n, &c) == 0 && c == -1, "stale hierarchy refuses to answer");
+
+    ch_free(ch);
+    addWeightedEdge(g, 0, 1, -1, 0);
+    TEST_CHECK_(ch_build(g) == NULL, "negative weights are rejected");
+    graph_free(g);
+}
+
+/* Checks every sampled CCH distance against Dijkstra */
+static int cch_matches_dijkstra(const CustomizableCH *cch, Graph *g, int n, int *path, int *cpath) {
+    int mismatches = 0;
+    for (int s = 0; s < n; s += 37) {
+        for (int t = 0; t < n; t += 53) {
+            long long d = -1, c = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            int clen = ch_shortest_path(cch->hierarchy, g, s, t, cpath, n, &c);
+            if (d != c || (len > 0) != (clen > 0) || (clen > 0 && (cpath[0] != s || cpath[clen - 1] != t))) {
+                TEST_MSG("%d→%d: %lld vs %lld", s, t, d, c);
+                mismatches++;
+            }
+        }
+    }
+    return mismatches;
+}
+
+void test_customizable_ch(void) {
+    const int w = 40, n = w * w;
+    Graph *g = createGraph(n);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    for (int v = 0; v < n; v++) {
+        int x = v % w, y = v / w;
+        if (x + 1 < w) addWeightedEdge(g, v, v + 1, 1 + (v * 7) % 5, y % 3 != 0);
+        if (y + 1 < w) addWeightedEdge(g, v, v + w, 1 + (v * 3) % 4, x % 4 != 1);
+    }
+
+    CustomizableCH *cch = cch_build(g);
+    TEST_ASSERT_(cch != NULL, "customizable hierarchy should build");
+    TEST_CHECK_(cch->numLevels > 1 && cch->numLevels < n, "%d customization rounds", cch->numLevels);
+
+    int *path = malloc(n * sizeof(int)), *cpath = malloc(n * sizeof(int));
+    TEST_ASSERT(path != NULL && cpath != NULL);
+    TEST_CHECK_(cch_matches_dijkstra(cch, g, n, path, cpath) == 0, "initial metric");
+
+    /* New weights on the same topology: only customization reruns */
+    for (int v = 0; v + 1 < n; v += 3) {
+        if (v % w + 1 < w) graph_set_edge_weight(g, v, v + 1, (v % 11 == 0) ? 0 : 20 + v % 7);
+    }
+    TEST_CHECK(cch_customize(cch, g, 1) == 0);
+    TEST_CHECK_(cch_matches_dijkstra(cch, g, n, path, cpath) == 0, "sequential customization");
+
+    graph_set_edge_weight(g, 0, 1, 500);
+    graph_set_edge_weight(g, w, w + 1, 0);
+    TEST_CHECK(cch_customize(cch, g, 4) == 0);
+    TEST_CHECK_(cch_matches_dijkstra(cch, g, n, path, cpath) == 0, "threaded customization");
+
+    graph_set_edge_weight(g, 0, 1, -3);
+    TEST_CHECK_(cch_customize(cch, g, 0) == -1, "negative weights are rejected");
+    graph_set_edge_weight(g, 0, 1, 2);
+    graph_insert_edge(g, 0, n - 1, 1);
+    TEST_CHECK_(cch_customize(cch, g, 0) == -1, "edges outside the topology are rejected");
+    long long c = 0;
+    TEST_CHECK_(ch_shortest_path(cch->hierarchy, g, 0, 1, cpath, n, &c) == 0, "failed customization answers nothing");
+
+    free(path);
+    free(cpath);
+    cch_free(cch);
+    graph_free(g);
+}
+
+/* Items each member handled per round; members check every round is complete */
+#define TEAM_ROUNDS 50
+#define TEAM_ITEMS  37
+
+typedef struct {
+    int done[PARALLEL_MAX_THREADS][TEAM_ROUNDS];
+    int incomplete[PARALLEL_MAX_THREADS];
+    int size;
+} TeamCheck;
+
+static void team_rounds(void *ctx, ParallelTeam *team, int member, int size) {
+    TeamCheck *check = ctx;
+    if (member == 0) check->size = size;
+    for (int r = 0; r < TEAM_ROUNDS; r++) {
+        int first, last;
+        parallel_slice(TEAM_ITEMS, member, size, &first, &last);
+        check->done[member][r] = last - first;
+        parallel_barrier(team);
+
+        int total = 0;
+        for (int m = 0; m < size; m++) total += check->done[m][r];
+        check->incomplete[member] += total != TEAM_ITEMS;
+    }
+}
+
+void test_parallel_team(void) {
+    TEST_CHECK(parallel_threads(0, 10) == 1 && parallel_threads(8, 3) == 3);
+    TEST_CHECK(parallel_threads(1000, 1000000) == PARALLEL_MAX_THREADS);
+
+    int requests[] = { 1, 4, 1000 };
+    for (int i = 0; i < 3; i++) {
+        TeamCheck *check = calloc(1, sizeof(TeamCheck));
+        TEST_ASSERT(check != NULL);
+        parallel_run(requests[i], team_rounds, check);
+        TEST_CHECK_(check->size >= 1 && check->size <= parallel_threads(requests[i], PARALLEL_MAX_THREADS),
+                    "%d members for %d requested", check->size, requests[i]);
+        for (int m = 0; m < check->size; m++) {
+            TEST_CHECK_(check->incomplete[m] == 0, "member %d saw an unfinished round", m);
+        }
+        free(check);
+    }
+}
+
+void test_hub_labels(void) {
+    const int w = 14, n = w * w;
+    Graph *g = build_oneway_grid(w, 1, 0);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    CustomizableCH *cch = cch_build(g);
+    TEST_ASSERT_(cch != NULL, "order should build");
+    HubLabels *hl = hub_labels_build(g, cch->hierarchy);
+    TEST_ASSERT_(hl != NULL, "labels should build");
+    TEST_CHECK_(hl->numEntries < (long long)n * n, "pruning keeps labels small (%lld entries)", hl->numEntries);
+
+    int path[14 * 14], hpath[14 * 14];
+    for (int s = 0; s < n; s += 3) {
+        for (int t = 0; t < n; t += 5) {
+            long long d = -1, h = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            int hlen = hub_labels_shortest_path(hl, g, s, t, hpath, n, &h);
+            TEST_CHECK_(d == h && h == hub_labels_distance(hl, g, s, t) && (len > 0) == (hlen > 0),
+                        "%d→%d: %lld vs %lld", s, t, d, h);
+            if (hlen > 0) check_path_weight(g, hpath, hlen, s, t, h);
+        }
+    }
+
+    long long h = 0;
+    TEST_CHECK_(hub_labels_distance(hl, g, 0, n - 1) == -1, "unreachable goal");
+    TEST_CHECK_(hub_labels_shortest_path(hl, g, 0, n - 1, hpath, n, &h) == 0 && h == -1, "no path");
+    TEST_CHECK_(hub_labels_shortest_path(hl, g, 7, 7, hpath, n, &h) == 1 && h == 0, "start == goal");
+    TEST_CHECK_(hub_labels_shortest_path(hl, g, 0, n - 2, hpath, 2, &h) == 0, "short buffer fails cleanly");
+    TEST_CHECK_(hub_labels_distance(hl, g, -1, 3) == -1, "invalid vertex");
+
+    /* Edge changes make the labels stale */
+    TEST_CHECK_(graph_delete_edge(g, w, w + 1) == 0, "edge removal");
+    TEST_CHECK_(hub_labels_distance(hl, g, 0, 2 * w) == -1, "stale labels refuse distances");
+    TEST_CHECK_(hub_labels_shortest_path(hl, g, 0, 2 * w, hpath, n, &h) == 0 && h == -1,
+                "stale labels refuse paths");
+
+    hub_labels_free(hl);
+    cch_free(cch);
+    graph_free(g);
+}
+
+void test_arc_flags(void) {
+    const int w = 16, n = w * w;
+    Graph *g = build_oneway_grid(w, 2, 0);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    TEST_CHECK_(arc_flags_build(g, 0, 1) == NULL, "zero regions rejected");
+    TEST_CHECK_(arc_flags_build(g, ARC_FLAGS_MAX_REGIONS + 1, 1) == NULL, "too many regions rejected");
+
+    ArcFlags *af = arc_flags_build(g, 12, 3);
+    TEST_ASSERT_(af != NULL, "flags should build");
+    TEST_CHECK_(af->numRegions == 12, "got %d regions", af->numRegions);
+
+    int sizes[12] = {0};
+    for (int v = 0; v < n; v++) sizes[af->regionOf[v]]++;
+    for (int r = 0; r < 12; r++) {
+        TEST_CHECK_(sizes[r] >= n / 16, "region %d holds %d vertices", r, sizes[r]);
+    }
+
+    int path[16 * 16], fpath[16 * 16];
+    long long settled = 0, settled_plain = 0;
+    for (int s = 0; s < n; s += 3) {
+        for (int t = 1; t < n; t += 7) {
+            long long d = -1, f = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            settled_plain += search_last_settled();
+            int flen = arc_flags_shortest_path(af, g, s, t, fpath, n, &f);
+            settled += search_last_settled();
+            TEST_CHECK_(d == f && (len > 0) == (flen > 0), "%d→%d: %lld vs %lld", s, t, d, f);
+            if (flen > 0) check_path_weight(g, fpath, flen, s, t, f);
+        }
+    }
+    TEST_CHECK_(settled < settled_plain, "flags prune the search (%lld vs %lld settled)", settled, settled_plain);
+
+    long long f = 0;
+    TEST_CHECK_(arc_flags_shortest_path(af, g, 0, n - 1, fpath, n, &f) == 0 && f == -1, "unreachable goal");
+    TEST_CHECK_(arc_flags_shortest_path(af, g, 0, n - 2, fpath, 2, &f) == 0, "short buffer fails cleanly");
+    TEST_CHECK_(arc_flags_shortest_path(af, g, 5, 5, fpath, 1, &f) == 1 && f == 0 && fpath[0] == 5,
+                "start == goal fits one slot");
+
+    /* Same flags with one thread */
+    ArcFlags *serial = arc_flags_build(g, 12, 1);
+    TEST_ASSERT_(serial != NULL, "serial build");
+    TEST_CHECK_(memcmp(serial->flags, af->flags, af->numEdges * sizeof(uint64_t)) == 0, "threads do not change flags");
+    arc_flags_free(serial);
+
+    /* Any change makes the flags stale */
+    TEST_CHECK_(graph_set_edge_weight(g, 0, 1, 100) == 0, "weight update");
+    TEST_CHECK_(arc_flags_shortest_path(af, g, 0, 17, fpath, n, &f) == 0 && f == -1, "stale flags refuse to answer");
+    arc_flags_free(af);
+
+    af = arc_flags_build(g, 12, 0);
+    TEST_ASSERT_(af != NULL, "rebuild over the overlay");
+    long long d = -1;
+    dijkstra_shortest_path(g, 0, 17, path, n, &d);
+    TEST_CHECK_(arc_flags_shortest_path(af, g, 0, 17, fpath, n, &f) > 0 && f == d, "rebuilt flags: %lld vs %lld", f, d);
+
+    arc_flags_free(af);
+    graph_free(g);
+}
+
+/* Checks every CRP answer on the sampled pairs against Dijkstra, including the unpacked path's weight */
+static void check_crp_queries(Graph *g, const CrpOverlay *crp, int n) {
+    int path[18 * 18], cpath[18 * 18];
+    for (int s = 0; s < n; s += 5) {
+        for (int t = 2; t < n; t += 7) {
+            long long d = -1, c = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            int clen = crp_shortest_path(crp, g, s, t, cpath, n, &c);
+            TEST_CHECK_(d == c && (len > 0) == (clen > 0), "%d→%d: %lld vs %lld", s, t, d, c);
+            if (clen > 0) check_path_weight(g, cpath, clen, s, t, c);
+        }
+    }
+}
+
+void test_crp_overlay(void) {
+    const int w = 18, n = w * w;
+    Graph *g = build_oneway_grid(w, 3, 0);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    TEST_CHECK_(crp_build(g, 0, 8) == NULL, "no levels rejected");
+    CrpOverlay *crp = crp_build(g, 3, 6);
+    TEST_ASSERT_(crp != NULL, "overlay should build");
+    for (int l = 0; l < crp->numLevels; l++) {
+        const CrpLevel *lvl = &crp->levels[l];
+        for (int v = 0; v < n && l + 1 < crp->numLevels; v++) {
+            TEST_CHECK_(crp->levels[l + 1].boundaryIndex[v] < 0 || lvl->boundaryIndex[v] >= 0,
+                        "level %d boundary %d is a boundary below", l + 2, v);
+        }
+        TEST_CHECK_(l == 0 || lvl->numCells < crp->levels[l - 1].numCells, "cells grow with the level");
+    }
+    check_crp_queries(g, crp, n);
+
+    long long c = 0;
+    int cpath[18 * 18];
+    TEST_CHECK_(crp_shortest_path(crp, g, 0, n - 1, cpath, n, &c) == 0 && c == -1, "unreachable goal");
+    TEST_CHECK_(crp_shortest_path(crp, g, 9, 9, cpath, 1, &c) == 1 && c == 0 && cpath[0] == 9,
+                "start == goal fits one slot");
+    TEST_CHECK_(crp_shortest_path(crp, g, 0, n - 2, cpath, 2, &c) == 0, "short buffer fails cleanly");
+
+    /* Matrices do not depend on the thread count */
+    long long cells = crp->levels[0].matrixOffsets[crp->levels[0].numCells];
+    long long *matrices = malloc(cells * sizeof(long long));
+    TEST_ASSERT_(matrices != NULL, "copy matrices");
+    memcpy(matrices, crp->levels[0].matrices, cells * sizeof(long long));
+    TEST_CHECK_(crp_customize(crp, g, 1) == 0, "serial customization");
+    TEST_CHECK_(memcmp(matrices, crp->levels[0].matrices, cells * sizeof(long long)) == 0, "same matrices");
+    free(matrices);
+
+    /* Weight changes: stale until customized again */
+    TEST_CHECK_(graph_set_edge_weight(g, 0, 1, 40) == 0, "weight update");
+    TEST_CHECK_(graph_set_edge_weight(g, 5 * w + 6, 5 * w + 7, 0) == 0, "weight update");
+    TEST_CHECK_(graph_delete_edge(g, 8 * w + 2, 9 * w + 2) == 0, "edge removal");
+    TEST_CHECK_(crp_shortest_path(crp, g, 0, 20, cpath, n, &c) == 0, "stale overlay refuses to answer");
+    TEST_CHECK_(crp_customize(crp, g, 3) == 0, "re-customization");
+    check_crp_queries(g, crp, n);
+
+    /* Renumbered vertices invalidate the cells, not just the matrices */
+    TEST_CHECK_(graph_compact(g, 0) == 0 && graph_reorder(g, ORDER_BFS) == 0, "reorder");
+    TEST_CHECK_(crp_shortest_path(crp, g, 0, 20, cpath, n, &c) == 0, "renumbered graph refused");
+    TEST_CHECK_(crp_customize(crp, g, 1) == -1, "renumbered graph needs a rebuild");
+
+    crp_free(crp);
+    graph_free(g);
+}
+
+void test_transit_nodes(void) {
+    const int w = 20, n = w * w;
+    Graph *g = build_oneway_grid(w, 4, 0);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    ContractionHierarchy *ch = ch_build(g);
+    TEST_ASSERT_(ch != NULL, "hierarchy should build");
+    TEST_CHECK_(tnr_build(g, ch, -1) == NULL, "negative transit count rejected");
+    TransitNodeRouting *tnr = tnr_build(g, ch, 40);
+    TEST_ASSERT_(tnr != NULL, "transit nodes should build");
+    TEST_CHECK_(tnr->numTransit == 40, "40 transit nodes");
+
+    /* A transit node is its own only access node */
+    int top = tnr->transitVertex[tnr->numTransit - 1];
+    TEST_CHECK_(tnr->fwdOffsets[top + 1] - tnr->fwdOffsets[top] == 1 &&
+                tnr->fwdAccess[tnr->fwdOffsets[top]] == tnr->numTransit - 1 &&
+                tnr->fwdDists[tnr->fwdOffsets[top]] == 0, "transit node accesses itself");
+
+    int path[20 * 20], tpath[20 * 20], local = 0, remote = 0;
+    for (int s = 0; s < n; s += 3) {
+        for (int t = 1; t < n; t += 7) {
+            long long d = -1, h = -1;
+            int len = dijkstra_shortest_path(g, s, t, path, n, &d);
+            int tlen = tnr_shortest_path(tnr, ch, g, s, t, tpath, n, &h);
+            TEST_CHECK_(d == h && h == tnr_distance(tnr, ch, g, s, t) && (len > 0) == (tlen > 0),
+                        "%d→%d: %lld vs %lld", s, t, d, h);
+            if (tnr_is_local(tnr, g, s, t)) local++; else remote++;
+            if (tlen > 0) check_path_weight(g, tpath, tlen, s, t, h);
+        }
+    }
+    TEST_CHECK_(local > 0 && remote > 0, "filter splits queries (%d local, %d by table)", local, remote);
+
+    long long h = 0;
+    TEST_CHECK_(tnr_distance(tnr, ch, g, 0, n - 1) == -1, "unreachable goal");
+    TEST_CHECK_(tnr_shortest_path(tnr, ch, g, 0, n - 1, tpath, n, &h) == 0 && h == -1, "no path");
+    TEST_CHECK_(tnr_shortest_path(tnr, ch, g, 7, 7, tpath, n, &h) == 1 && h == 0, "start == goal");
+    TEST_CHECK_(tnr_is_local(tnr, g, -1, 3) == -1, "invalid vertex");
+
+    /* Edge changes make the tables stale */
+    TEST_CHECK_(graph_set_edge_weight(g, 0, 1, 40) == 0, "weight update");
+    TEST_CHECK_(tnr_distance(tnr, ch, g, 0, n - 2) == -1, "stale tables refuse to answer");
+
+    tnr_free(tnr);
+    ch_free(ch);
+    graph_free(g);
+}
+
+void test_one_to_all(void) {
+    const int w = 16, n = w * w;
+    Graph *g = build_oneway_grid(w, 5, 0);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    ContractionHierarchy *ch = ch_build(g);
+    TEST_ASSERT_(ch != NULL, "hierarchy should build");
+    PhastSweep *ph = phast_build(g, ch);
+    TEST_ASSERT_(ph != NULL, "sweep layout should build");
+    for (int p = 0; p < n; p++) {
+        for (int i = ph->downOffsets[p]; i < ph->downOffsets[p + 1]; i++) {
+            TEST_CHECK_(ph->downSources[i] < p, "arc into %d comes from an earlier position", p);
+        }
+    }
+
+    int sources[11];
+    long long dist[16 * 16], sweep[16 * 16], *rows = malloc(11 * n * sizeof(long long));
+    int parent[16 * 16], path[16 * 16];
+    TEST_ASSERT_(rows != NULL, "allocate rows");
+    for (int i = 0; i < 11; i++) sources[i] = (i * 23) % n;
+    TEST_CHECK_(phast_many_to_all(ph, g, sources, 11, rows) == 0, "batched sweeps");
+
+    for (int i = 0; i < 11; i++) {
+        int s = sources[i];
+        int reached = dijkstra_one_to_all(g, s, dist, parent);
+        TEST_CHECK_(reached > 0 && phast_one_to_all(ph, g, s, sweep, NULL) == reached, "same reach from %d", s);
+        for (int t = 0; t < n; t++) {
+            long long d = -1;
+            dijkstra_shortest_path(g, s, t, path, n, &d);
+            TEST_CHECK_(dist[t] == d && sweep[t] == d && rows[(size_t)i * n + t] == d,
+                        "%d→%d: %lld, one-to-all %lld, sweep %lld, batch %lld",
+                        s, t, d, dist[t], sweep[t], rows[(size_t)i * n + t]);
+        }
+
+        /* Sweep parents: every reached vertex hangs off a tight edge */
+        TEST_CHECK_(phast_one_to_all(ph, g, s, sweep, parent) == reached, "parents from %d", s);
+        for (int t = 0; t < n; t++) {
+            if (t == s || sweep[t] < 0) {
+                TEST_CHECK_(parent[t] == -1, "%d has no parent", t);
+                continue;
+            }
+            int hop[2] = { parent[t], t };
+            check_path_weight(g, hop, 2, parent[t], t, sweep[t] - sweep[parent[t]]);
+        }
+    }
+
+    TEST_CHECK_(dijkstra_one_to_all(g, -1, dist, NULL) == -1, "invalid start");
+    TEST_CHECK_(phast_one_to_all(ph, g, n, dist, NULL) == -1, "invalid start");
+    TEST_CHECK_(phast_many_to_all(ph, g, sources, 0, rows) == 0, "no sources");
+
+    /* Edge changes make the layout stale */
+    TEST_CHECK_(graph_set_edge_weight(g, 0, 1, 40) == 0, "weight update");
+    TEST_CHECK_(phast_one_to_all(ph, g, 0, sweep, NULL) == -1, "stale layout refuses to answer");
+    long long d01 = -1;
+    dijkstra_shortest_path(g, 0, 1, path, n, &d01);
+    TEST_CHECK_(dijkstra_one_to_all(g, 0, dist, NULL) > 0 && dist[1] == d01, "one-to-all Dijkstra sees the update");
+
+    free(rows);
+    phast_free(ph);
+    ch_free(ch);
+    graph_free(g);
+}
+
+void test_distance_matrix(void) {
+    const int w = 15, n = w * w;
+    Graph *g = build_oneway_grid(w, 6, 0);
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    ContractionHierarchy *ch = ch_build(g);
+    CustomizableCH *cch = cch_build(g);
+    TEST_ASSERT_(ch != NULL && cch != NULL, "hierarchies should build");
+
+    /* Duplicates and the unreachable corner on both sides */
+    int sources[13], targets[17], path[15 * 15];
+    for (int i = 0; i < 13; i++) sources[i] = (i * 37) % n;
+    for (int j = 0; j < 17; j++) targets[j] = (j * 53 + 11) % n;
+    sources[12] = sources[3];
+    targets[16] = n - 1;
+    targets[15] = targets[2];
+
+    long long serial[13 * 17], threaded[13 * 17], custom[13 * 17];
+    TEST_CHECK_(distance_matrix(g, ch, sources, 13, targets, 17, serial, 1) == 0, "serial table");
+    TEST_CHECK_(distance_matrix(g, ch, sources, 13, targets, 17, threaded, 3) == 0, "threaded table");
+    TEST_CHECK_(distance_matrix(g, cch->hierarchy, sources, 13, targets, 17, custom, 0) == 0, "table over a CCH");
+    for (int i = 0; i < 13; i++) {
+        for (int j = 0; j < 17; j++) {
+            long long d = -1;
+            dijkstra_shortest_path(g, sources[i], targets[j], path, n, &d);
+            TEST_CHECK_(serial[i * 17 + j] == d && threaded[i * 17 + j] == d && custom[i * 17 + j] == d,
+                        "%d→%d: %lld, table %lld / %lld / %lld", sources[i], targets[j], d,
+                        serial[i * 17 + j], threaded[i * 17 + j], custom[i * 17 + j]);
+        }
+    }
+
+    TEST_CHECK_(distance_matrix(g, ch, sources, 0, targets, 17, serial, 2) == 0, "no rows");
+    TEST_CHECK_(distance_matrix(g, ch, sources, 13, targets, 0, serial, 2) == 0, "no columns");
+    targets[4] = n;
+    TEST_CHECK_(distance_matrix(g, ch, sources, 13, targets, 17, serial, 1) == -1, "invalid target");
+    TEST_CHECK_(distance_matrix(g, NULL, sources, 13, targets, 17, serial, 1) == -1, "hierarchy required");
+
+    /* Edge changes: the CH is stale, the CCH answers again once customized */
+    targets[4] = 0;
+    TEST_CHECK_(graph_set_edge_weight(g, 0, 1, 40) == 0, "weight update");
+    TEST_CHECK_(distance_matrix(g, ch, sources, 13, targets, 17, serial, 1) == -1, "stale hierarchy refused");
+    TEST_CHECK_(distance_matrix(g, cch->hierarchy, sources, 13, targets, 17, custom, 1) == -1,
+                "uncustomized hierarchy refused");
+    TEST_CHECK_(cch_customize(cch, g, 1) == 0, "re-customization");
+    TEST_CHECK_(distance_matrix(g, cch->hierarchy, sources, 13, targets, 17, custom, 1) == 0, "customized table");
+    for (int i = 0; i < 13; i++) {
+        for (int j = 0; j < 17; j++) {
+            long long d = -1;
+            dijkstra_shortest_path(g, sources[i], targets[j], path, n, &d);
+            TEST_CHECK_(custom[i * 17 + j] == d, "%d→%d after the update: %lld vs %lld",
+                        sources[i], targets[j], custom[i * 17 + j], d);
+        }
+    }
+
+    cch_free(cch);
+    ch_free(ch);
+    graph_free(g);
+}
+
+/* Pop of a backend that cannot allocate */
+static int pop_out_of_memory(PQueue *pq, int *node, long long *key) {
+    (void)pq; (void)node; (void)key;
+    return PQUEUE_NO_MEMORY;
+}
+
+void test_search_session(void) {
+    const int w = BIASTAR_WIDTH, n = w * w;
+    Graph *g = build_oneway_grid(w, 7, 4);   /* edges of at least 4 keep grid_heuristic consistent */
+    TEST_ASSERT_(g != NULL, "failed to create grid");
+
+    TEST_CHECK_(search_session_create(g, n, NULL) == NULL, "invalid start rejected");
+
+    /* Stops in scattered order, with repeats, the start and the unreachable vertex */
+    int stops[] = { 300, 17, n - 2, 300, 5 * w + 9, 5 * w + 3, n - 1, 250, 17, w * 7, 42 };
+    int num_stops = (int)(sizeof(stops) / sizeof(stops[0]));
+    int path[BIASTAR_WIDTH * BIASTAR_WIDTH], spath[BIASTAR_WIDTH * BIASTAR_WIDTH];
+
+    for (int mode = 0; mode < 2; mode++) {
+        SearchSession *session = search_session_create(g, 42, mode ? grid_heuristic : NULL);
+        TEST_ASSERT_(session != NULL, "session should start");
+
+        for (int i = 0; i < num_stops; i++) {
+            long long d = -1, sd = -1;
+            int len = dijkstra_shortest_path(g, 42, stops[i], path, n, &d);
+            int before = session->settled;
+            int slen = search_session_path(session, stops[i], spath, n, &sd);
+            TEST_CHECK_(sd == d && slen == len, "%s stop %d: %lld vs %lld",
+                        mode ? "A*" : "Dijkstra", stops[i], sd, d);
+            TEST_CHECK_(session->lastSettled == session->settled - before, "per-call settled count");
+            if (slen > 0) {
+                TEST_CHECK_(spath[0] == 42 && spath[slen - 1] == stops[i], "path ends at stop %d", stops[i]);
+            }
+            for (int j = 0; j < i; j++) {
+                if (stops[j] == stops[i] && stops[i] != n - 1) {
+                    TEST_CHECK_(session->lastSettled == 0, "repeat stop %d needs no search", stops[i]);
+                }
+            }
+        }
+        TEST_CHECK_(session->settled <= n, "every vertex settled at most once (%d)", session->settled);
+
+        long long sd = -1;
+        TEST_CHECK_(search_session_path(session, 42, spath, 1, &sd) == 1 && sd == 0 && spath[0] == 42,
+                    "start == goal fits one slot");
+        TEST_CHECK_(search_session_path(session, 17, spath, 1, &sd) == 0 && sd == -1, "short buffer fails cleanly");
+
+        /* Edge changes end the session */
+        if (mode) {
+            long long sd = 0;
+            TEST_CHECK_(graph_set_edge_weight(g, 0, 1, 40) == 0, "weight update");
+            TEST_CHECK_(search_session_path(session, 300, spath, n, &sd) == 0 && sd == -1,
+                        "stale session refuses to answer");
+        }
+        search_session_free(session);
+    }
+
+    /* A pop that runs out of memory fails the session for good, even for settled goals */
+    SearchSession *session = search_session_create(g, 42, NULL);
+    TEST_ASSERT_(session != NULL, "session should start");
+    long long sd = -1;
+    TEST_CHECK_(search_session_path(session, 17, spath, n, &sd) > 0, "first goal");
+    const PQueueOps *ops = session->queue->ops;
+    PQueueOps failing = *ops;
+    failing.pop = pop_out_of_memory;
+    session->queue->ops = &failing;
+    TEST_CHECK_(search_session_path(session, n - 2, spath, n, &sd) == 0 && sd == -1 && session->failed,
+                "out of memory is a failure, not an unreachable goal");
+    session->queue->ops = ops;
+    TEST_CHECK_(search_session_path(session, 17, spath, n, &sd) == 0 && sd == -1, "failed session refuses to answer");
+    search_session_free(session);
+
+    graph_free(g);
+}
@@ -4,5 +4,51 @@
 #define TEST_COMMON_H
 
 #include "acutest.h"   // ← include here once
+#include "../include/graph.h"
 
-#endif
\ No newline at end of file
+/*
+ * w × w grid of one-way and two-way streets. seed varies the weights and
+ * which streets are one-way. Edges weigh min_weight or more, so 0 gives
+ * zero-weight edges. Nothing leads into or out of the last vertex.
+ */
+static inline Graph *build_oneway_grid(int w, int seed, int min_weight) {
+    int n = w * w;
+    Graph *g = createGraph(n);
+    if (!g) {
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        int x = v % w, y = v / w;
+        if (x + 1 < w && v + 1 != n - 1) {
+            addWeightedEdge(g, v, v + 1, min_weight + (v * (3 + seed % 5)) % (4 + seed % 4),
+                            y % 3 != seed % 3);
+        }
+        if (y + 1 < w && v + w != n - 1) {
+            addWeightedEdge(g, v, v + w, min_weight + 1 + (v * (7 - seed % 4)) % (4 + seed % 6),
+                            x % 4 != (seed + 1) % 4);
+        }
+    }
+    return g;
+}
+
+/*
+ * Checks that path runs from s to t over real edges and that its cheapest
+ * parallel edges add up to d. Returns 1 if it does.
+ */
+static inline int check_path_weight(Graph *g, const int *path, int len, int s, int t, long long d) {
+    long long sum = 0;
+    int ok = TEST_CHECK_(len > 0 && path[0] == s && path[len - 1] == t, "path runs %d→%d", s, t);
+    for (int i = 0; ok && i + 1 < len; i++) {
+        long long best = -1;
+        GraphEdgeIter it;
+        int u = graph_to_internal(g, path[i]), v = graph_to_internal(g, path[i + 1]);
+        for (graph_edges_begin(g, u, &it); graph_edges_next(&it); ) {
+            if (it.to == v && (best < 0 || it.weight < best)) best = it.weight;
+        }
+        ok = TEST_CHECK_(best >= 0, "%d→%d is an edge", path[i], path[i + 1]);
+        sum += best;
+    }
+    return ok && TEST_CHECK_(sum == d, "%d→%d: path weighs %lld, distance %lld", s, t, sum, d);
+}
+
+#endif
@@ -1,6 +1,7 @@
 #define TEST_NO_MAIN
 #include "acutest.h"
 #include <test_common.h>
+#include <stdio.h>
 #include <string.h>
 #include "../include/graph.h"
 
@@ -18,7 +19,7 @@ void test_create_and_free_empty_graph(void) {
     TEST_CHECK_(g->numVertices == 1, "numVertices should be 1");
     TEST_CHECK_(g->array != NULL, "adjacency array should be allocated");
     TEST_CHECK_(g->array[0].head == NULL, "no edges initially");
-    TEST_CHECK_(g->names != NULL, "names array should be allocated");
+    TEST_CHECK_(g->nameOffsets != NULL, "name offset table should be allocated");
     TEST_CHECK_(graphGetName(g, 0) == NULL, "initial name should be NULL");
 
     /* graph_free(NULL) must be safe */
@@ -181,4 +182,414 @@ void test_add_edge_invalid_indices(void) {
     TEST_CHECK_(g->array[2].head == NULL, "vertex 2 still has no edges");
 
     graph_free(g);
-}
\ No newline at end of file
+}
+/* graph_freeze builds CSR arrays in adjacency-list order */
+
+void test_freeze_csr_layout(void) {
+    Graph *g = createGraph(3);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    addWeightedEdge(g, 0, 1, 4, 0);
+    addWeightedEdge(g, 0, 2, 9, 0);
+    addWeightedEdge(g, 1, 2, 3, 1);
+
+    TEST_CHECK_(g->frozen == 0, "new graph is not frozen");
+    TEST_ASSERT_(graph_freeze(g) == 0, "freeze should succeed");
+    TEST_CHECK_(g->frozen == 1, "graph marked frozen");
+    TEST_CHECK_(g->csr.numEdges == 4, "4 directed edges stored");
+
+    const GraphCSR *csr = &g->csr;
+    TEST_CHECK_(csr->offsets[0] == 0 && csr->offsets[1] == 2 &&
+                csr->offsets[2] == 3 && csr->offsets[3] == 4,
+                "offsets follow out-degrees");
+    TEST_CHECK_(csr->targets[0] == 2 && graph_csr_weight(csr, 0) == 9,
+                "newest edge of vertex 0 first");
+    TEST_CHECK_(csr->targets[1] == 1 && graph_csr_weight(csr, 1) == 4,
+                "older edge of vertex 0 second");
+    TEST_CHECK_(csr->targets[3] == 1 && graph_csr_weight(csr, 3) == 3,
+                "reverse half of undirected edge stored");
+
+    /* mutation invalidates, next freeze rebuilds */
+    addWeightedEdge(g, 2, 0, 1, 0);
+    TEST_CHECK_(g->frozen == 0, "adding an edge unfreezes the graph");
+    TEST_ASSERT_(graph_freeze(g) == 0, "refreeze should succeed");
+    TEST_CHECK_(g->csr.numEdges == 5, "rebuilt CSR contains new edge");
+
+    TEST_CHECK_(graph_freeze(NULL) == -1, "NULL graph rejected");
+
+    graph_free(g);
+}
+
+/* edges come from the graph-owned arena; reserving avoids extra chunks */
+
+void test_edge_arena_reserve(void) {
+    Graph *g = createGraph(100);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    TEST_CHECK_(graph_reserve_edges(NULL, 10) == -1, "NULL graph rejected");
+    TEST_CHECK_(graph_reserve_edges(g, -1) == -1, "negative count rejected");
+    TEST_ASSERT_(graph_reserve_edges(g, 5000) == 0, "reserve should succeed");
+
+    EdgeChunk *reserved = g->edgeChunks;
+    for (int i = 0; i < 2500; i++) {
+        addWeightedEdge(g, i % 100, (i + 1) % 100, i, 1);
+    }
+
+    TEST_CHECK_(g->edgeChunks == reserved, "no new chunk after reserving");
+    TEST_CHECK_(reserved->used == 5000, "every undirected edge used two slots");
+
+    /* growing past the reservation allocates a new chunk */
+    addWeightedEdge(g, 0, 1, 1, 0);
+    TEST_CHECK_(g->edgeChunks != reserved, "new chunk when arena is full");
+    TEST_CHECK_(g->edgeChunks->next == reserved, "old chunk kept in chain");
+    TEST_CHECK_(g->array[0].head->to == 1 && g->array[0].head->weight == 1,
+                "edge from new chunk linked at head");
+
+    graph_free(g);
+}
+
+/* name index stays consistent across renames and duplicate names */
+
+void test_name_index_consistency(void) {
+    Graph *g = createGraph(2000);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    char buf[32];
+    for (int i = 0; i < 2000; i++) {
+        snprintf(buf, sizeof(buf), "city-%d", i);
+        graphSetName(g, i, buf);
+    }
+    TEST_CHECK_(g->nameIndex != NULL, "index built when names are set");
+
+    int all_found = 1;
+    for (int i = 0; i < 2000; i++) {
+        snprintf(buf, sizeof(buf), "city-%d", i);
+        if (graph_find_vertex_by_name(g, buf) != i) all_found = 0;
+    }
+    TEST_CHECK_(all_found, "every name resolves to its vertex");
+
+    /* rename half the vertices: old names disappear, new ones resolve */
+    for (int i = 0; i < 2000; i += 2) {
+        snprintf(buf, sizeof(buf), "renamed-%d", i);
+        graphSetName(g, i, buf);
+    }
+    int consistent = 1;
+    for (int i = 0; i < 2000; i++) {
+        snprintf(buf, sizeof(buf), "city-%d", i);
+        int expect_old = (i % 2 == 1) ? i : -1;
+        if (graph_find_vertex_by_name(g, buf) != expect_old) consistent = 0;
+        snprintf(buf, sizeof(buf), "renamed-%d", i);
+        int expect_new = (i % 2 == 0) ? i : -1;
+        if (graph_find_vertex_by_name(g, buf) != expect_new) consistent = 0;
+    }
+    TEST_CHECK_(consistent, "index follows renames");
+
+    /* duplicate names: lowest ID wins, next one takes over after rename */
+    graphSetName(g, 7, "Twin");
+    graphSetName(g, 3, "Twin");
+    TEST_CHECK_(graph_find_vertex_by_name(g, "Twin") == 3, "lowest ID returned");
+    graphSetName(g, 3, "Single");
+    TEST_CHECK_(graph_find_vertex_by_name(g, "Twin") == 7, "remaining twin found");
+    TEST_CHECK_(graph_find_vertex_by_name(g, "Single") == 3, "renamed twin found");
+
+    graph_free(g);
+}
+
+/* names live in one pool; equal names are stored once */
+
+void test_name_pool_interning(void) {
+    Graph *g = createGraph(4);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    graphSetName(g, 0, "Mainz");
+    graphSetName(g, 1, "Ulm");
+    graphSetName(g, 2, "Mainz");
+    TEST_CHECK_(g->nameOffsets[0] == g->nameOffsets[2], "equal names share an offset");
+    TEST_CHECK_(graphGetName(g, 0) == graphGetName(g, 2), "same pooled string returned");
+    TEST_CHECK_(g->names.size == sizeof("Mainz") + sizeof("Ulm"),
+                "pool holds each distinct name once");
+    TEST_CHECK_(g->nameOffsets[3] == GRAPH_NO_NAME, "unnamed vertex has no offset");
+
+    graphSetName(g, 2, "Ulm");
+    TEST_CHECK_(strcmp(graphGetName(g, 0), "Mainz") == 0,
+                "renaming a sharer keeps the other name intact");
+    TEST_CHECK_(g->nameOffsets[2] == g->nameOffsets[1], "renamed vertex reuses pooled name");
+    TEST_CHECK_(g->names.garbage == 0, "a name still in use is not garbage");
+
+    graph_free(g);
+}
+
+/* pooled names never move while the pool grows; compaction reclaims replaced names */
+
+void test_name_pool_stable_pointers(void) {
+    const int n = 200;
+    Graph *g = createGraph(n);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    graphSetName(g, 0, "Mainz");
+    graphSetName(g, 1, "Ulm");
+    const char *mainz = graphGetName(g, 0);
+    const char *ulm = graphGetName(g, 1);
+
+    /* Enough names to fill several chunks, one longer than the first chunk */
+    char name[400];
+    for (int v = 2; v < n; v++) {
+        snprintf(name, sizeof(name), "Vertex %d with a fairly long name", v);
+        graphSetName(g, v, name);
+    }
+    memset(name, 'x', 300);
+    name[300] = '\0';
+    graphSetName(g, n - 1, name);
+    TEST_CHECK_(g->names.size > 4 * GRAPH_NAME_CHUNK_MIN, "pool spans several chunks");
+    TEST_CHECK_(graphGetName(g, 0) == mainz && strcmp(mainz, "Mainz") == 0, "earlier pointer still valid");
+    TEST_CHECK_(strcmp(graphGetName(g, n - 1), name) == 0, "long name stored whole");
+
+    uint32_t garbage = g->names.garbage;
+    graphSetName(g, 1, "Bonn");
+    TEST_CHECK_(strcmp(ulm, "Ulm") == 0, "replaced name's pointer still readable");
+    TEST_CHECK_(g->names.garbage == garbage + sizeof("Ulm"), "replaced name counted as garbage");
+    graphSetName(g, 2, NULL);
+    TEST_CHECK_(graphGetName(g, 2) == NULL && graph_find_vertex_by_name(g, "Vertex 2 with a fairly long name") == -1,
+                "NULL removes a name");
+
+    uint32_t before = g->names.size;
+    TEST_ASSERT_(graph_compact_names(g) == 0, "compaction succeeds");
+    TEST_CHECK_(g->names.garbage == 0 && g->names.size < before, "compaction reclaims garbage");
+    int intact = 1;
+    for (int v = 3; v < n - 1; v++) {
+        snprintf(name, sizeof(name), "Vertex %d with a fairly long name", v);
+        intact = intact && strcmp(graphGetName(g, v), name) == 0 && graph_find_vertex_by_name(g, name) == v;
+    }
+    TEST_CHECK_(intact && strcmp(graphGetName(g, 0), "Mainz") == 0 && strcmp(graphGetName(g, 1), "Bonn") == 0,
+                "names and lookups survive compaction");
+    TEST_CHECK_(strlen(graphGetName(g, n - 1)) == 300, "long name survives compaction");
+
+    graph_free(g);
+}
+
+/* reverse adjacency: transposed for directed graphs, shared for undirected */
+
+void test_reverse_adjacency_cache(void) {
+    Graph *g = createGraph(4);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    addWeightedEdge(g, 0, 1, 4, 0);
+    addWeightedEdge(g, 2, 1, 6, 0);
+    addWeightedEdge(g, 1, 3, 2, 0);
+
+    const GraphCSR *rev = graph_reverse(g);
+    TEST_ASSERT_(rev != NULL, "reverse CSR built");
+    TEST_CHECK_(rev != &g->csr, "directed graph gets its own transpose");
+    TEST_CHECK_(rev->offsets[1] == 0 && rev->offsets[2] == 2,
+                "vertex 1 has two incoming edges");
+    TEST_CHECK_(rev->targets[0] == 0 && graph_csr_weight(rev, 0) == 4 &&
+                rev->targets[1] == 2 && graph_csr_weight(rev, 1) == 6,
+                "incoming edges of 1 list their sources");
+    TEST_CHECK_(graph_reverse(g) == rev, "cached on second call");
+
+    /* mutation invalidates the cache */
+    addWeightedEdge(g, 3, 1, 9, 0);
+    rev = graph_reverse(g);
+    TEST_ASSERT_(rev != NULL, "reverse CSR rebuilt");
+    TEST_CHECK_(rev->offsets[2] - rev->offsets[1] == 3,
+                "rebuilt reverse sees the new edge");
+
+    graph_free(g);
+
+    Graph *u = createGraph(3);
+    TEST_ASSERT_(u != NULL, "failed to create graph");
+    addWeightedEdge(u, 0, 1, 1, 1);
+    addWeightedEdge(u, 1, 2, 1, 1);
+    TEST_CHECK_(graph_reverse(u) == &u->csr, "undirected graph shares forward CSR");
+    graph_free(u);
+}
+
+/* compressed adjacency decodes to the same edges and is smaller */
+
+void test_compressed_adjacency(void) {
+    Graph *g = createGraph(300);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    for (int i = 0; i < 300; i++) {
+        for (int k = 1; k <= 6; k++) {
+            addWeightedEdge(g, i, (i + k * k) % 300, (i + k) % 50, 0);
+        }
+        addWeightedEdge(g, i, (i * 7) % 300, -(i % 3), 0);
+    }
+
+    TEST_ASSERT_(graph_freeze(g) == 0, "freeze should succeed");
+    int m = g->csr.numEdges;
+    long long sum_plain = 0, sum_to_plain = 0;
+    for (int i = 0; i < m; i++) {
+        sum_plain += graph_csr_weight(&g->csr, i);
+        sum_to_plain += g->csr.targets[i];
+    }
+    size_t plain_bytes = graph_adjacency_bytes(g);
+
+    TEST_ASSERT_(graph_compress(g) == 0, "compress should succeed");
+    TEST_CHECK_(g->compressed != NULL && g->csr.targets == NULL,
+                "plain arrays released");
+    TEST_CHECK_(g->compressed->weightBytes == 1, "small weights packed to one byte");
+    TEST_CHECK_(graph_adjacency_bytes(g) < plain_bytes, "compressed layout is smaller");
+
+    long long sum_packed = 0, sum_to_packed = 0;
+    int count = 0, sorted = 1;
+    GraphEdgeIter it;
+    for (int v = 0; v < 300; v++) {
+        int prev = -1;
+        for (graph_edges_begin(g, v, &it); graph_edges_next(&it); ) {
+            sum_packed += it.weight;
+            sum_to_packed += it.to;
+            if (it.to < prev) sorted = 0;
+            prev = it.to;
+            count++;
+        }
+    }
+    TEST_CHECK_(count == m, "every edge decoded");
+    TEST_CHECK_(sum_packed == sum_plain && sum_to_packed == sum_to_plain,
+                "targets and weights survive encoding");
+    TEST_CHECK_(sorted, "edges of each vertex sorted by target");
+
+    /* refreezing after an insertion returns to the plain layout */
+    addWeightedEdge(g, 0, 5, 1, 0);
+    TEST_ASSERT_(graph_freeze(g) == 0, "refreeze should succeed");
+    TEST_CHECK_(g->compressed == NULL && g->csr.targets != NULL,
+                "plain layout restored");
+
+    /* a wide weight widens the whole stream */
+    addWeightedEdge(g, 1, 2, 40000, 0);
+    TEST_ASSERT_(graph_compress(g) == 0, "compress should succeed");
+    TEST_CHECK_(g->compressed->weightBytes == 4, "40000 needs 4-byte weights");
+    int found = 0;
+    for (graph_edges_begin(g, 1, &it); graph_edges_next(&it); ) {
+        if (it.to == 2 && it.weight == 40000) found = 1;
+    }
+    TEST_CHECK_(found, "wide weight decoded");
+
+    graph_free(g);
+}
+
+/* freezing picks the narrowest safe weight and distance widths */
+
+void test_weight_width_selection(void) {
+    Graph *g = createGraph(3);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    addWeightedEdge(g, 0, 1, 100, 0);
+    addWeightedEdge(g, 1, 2, -7, 0);
+    TEST_ASSERT_(graph_freeze(g) == 0, "freeze should succeed");
+    TEST_CHECK_(g->csr.weightBits == 16 && g->distBits == 16, "small graph → 16/16");
+
+    /* each weight fits 16 bits, but a path of two of them does not */
+    addWeightedEdge(g, 1, 2, 30000, 0);
+    addWeightedEdge(g, 0, 1, 30000, 0);
+    TEST_ASSERT_(graph_freeze(g) == 0, "refreeze should succeed");
+    TEST_CHECK_(g->csr.weightBits == 16 && g->distBits == 32, "path sum needs 32-bit distances");
+
+    addWeightedEdge(g, 2, 0, 40000, 0);
+    TEST_ASSERT_(graph_freeze(g) == 0, "refreeze should succeed");
+    TEST_CHECK_(g->csr.weightBits == 32 && g->distBits == 32, "40000 needs 32-bit weights");
+
+    addWeightedEdge(g, 2, 1, 5000000000LL, 0);
+    TEST_ASSERT_(graph_freeze(g) == 0, "refreeze should succeed");
+    TEST_CHECK_(g->csr.weightBits == 64 && g->distBits == 64, "5e9 needs 64 bits");
+    TEST_CHECK_(graph_csr_weight(&g->csr, g->csr.offsets[2]) == 5000000000LL,
+                "64-bit weight stored exactly");
+
+    graph_free(g);
+
+    g = createGraph(2);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+    addWeightedEdge(g, 0, 1, 3, 1);
+    TEST_CHECK_(graph_select_widths(g, 32, 64) == 0, "widening should succeed");
+    TEST_CHECK_(g->csr.weightBits == 32 && g->distBits == 64, "requested widths applied");
+    TEST_CHECK_(graph_select_widths(g, 24, 0) == -1, "unsupported width rejected");
+    graph_free(g);
+}
+
+/* delta overlay: insert, delete and reweight are visible to iteration and compact away */
+
+static int edge_weight_of(const Graph *g, int from, int to, long long *weight) {
+    GraphEdgeIter it;
+    int found = 0;
+    for (graph_edges_begin(g, graph_to_internal(g, from), &it); graph_edges_next(&it); ) {
+        if (graph_to_external(g, it.to) == to) {
+            *weight = it.weight;
+            found++;
+        }
+    }
+    return found;
+}
+
+static int reverse_weight_of(const Graph *g, const GraphCSR *rev, int from, int to, long long *weight) {
+    GraphEdgeIter it;
+    int found = 0;
+    for (graph_reverse_edges_begin(g, rev, graph_to_internal(g, to), &it); graph_edges_next(&it); ) {
+        if (graph_to_external(g, it.to) == from) {
+            *weight = it.weight;
+            found++;
+        }
+    }
+    return found;
+}
+
+void test_delta_overlay(void) {
+    Graph *g = createGraph(4);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    addWeightedEdge(g, 0, 1, 5, 0);
+    addWeightedEdge(g, 1, 2, 5, 0);
+    addWeightedEdge(g, 0, 2, 20, 0);
+    TEST_ASSERT_(graph_freeze(g) == 0, "freeze should succeed");
+
+    long long w = 0;
+    TEST_CHECK_(graph_insert_edge(g, 0, 3, 1) == 0, "insert new edge");
+    TEST_CHECK_(graph_insert_edge(g, 0, 1, 9) == -1, "insert of existing edge rejected");
+    TEST_CHECK_(edge_weight_of(g, 0, 3, &w) == 1 && w == 1, "inserted edge visible");
+
+    TEST_CHECK_(graph_set_edge_weight(g, 0, 2, 3) == 0, "reweight base edge");
+    TEST_CHECK_(edge_weight_of(g, 0, 2, &w) == 1 && w == 3, "new weight visible");
+
+    TEST_CHECK_(graph_delete_edge(g, 0, 1) == 0, "delete base edge");
+    TEST_CHECK_(edge_weight_of(g, 0, 1, &w) == 0, "deleted edge gone");
+    TEST_CHECK_(graph_delete_edge(g, 0, 1) == -1, "second delete rejected");
+    TEST_CHECK_(graph_set_edge_weight(g, 0, 1, 4) == -1, "reweight of deleted edge rejected");
+    TEST_CHECK_(graph_insert_edge(g, 0, 1, 7) == 0, "re-insert deleted base edge");
+    TEST_CHECK_(edge_weight_of(g, 0, 1, &w) == 1 && w == 7, "re-inserted weight visible");
+    TEST_CHECK_(graph_delta_size(g) == 3, "one overlay entry per changed edge");
+
+    const GraphCSR *rev = graph_reverse(g);
+    TEST_ASSERT_(rev != NULL, "reverse should build");
+    TEST_CHECK_(reverse_weight_of(g, rev, 0, 3, &w) == 1 && w == 1,
+                "reverse iteration includes the inserted edge");
+    TEST_CHECK_(reverse_weight_of(g, rev, 0, 2, &w) == 1 && w == 3 &&
+                reverse_weight_of(g, rev, 0, 1, &w) == 1 && w == 7,
+                "reverse iteration applies new weights");
+    TEST_CHECK_(graph_delete_edge(g, 1, 2) == 0 && graph_reverse(g) == rev,
+                "updates keep the cached transpose");
+    TEST_CHECK_(reverse_weight_of(g, rev, 1, 2, &w) == 0, "reverse iteration drops the deleted edge");
+    TEST_CHECK_(graph_insert_edge(g, 1, 2, 5) == 0, "restore 1→2");
+
+    TEST_CHECK_(graph_compact(g, 0) == 0, "synchronous compaction");
+    TEST_CHECK_(graph_delta_size(g) == 0 && g->array == NULL, "overlay folded, builder dropped");
+    TEST_CHECK_(g->csr.numEdges == 4, "base now holds 0→1, 0→2, 0→3, 1→2");
+    rev = graph_reverse(g);
+    TEST_CHECK_(rev && rev->offsets[4] - rev->offsets[3] == 1, "transpose rebuilt for the new base");
+    TEST_CHECK_(edge_weight_of(g, 0, 1, &w) == 1 && w == 7 &&
+                edge_weight_of(g, 0, 2, &w) == 1 && w == 3 &&
+                edge_weight_of(g, 0, 3, &w) == 1 && w == 1,
+                "compacted base keeps overlay weights");
+
+    /* updates made while a background compaction runs stay in the overlay */
+    TEST_CHECK_(graph_delete_edge(g, 1, 2) == 0, "delete before compaction");
+    TEST_CHECK_(graph_compact(g, 1) == 0, "background compaction starts");
+    TEST_CHECK_(graph_insert_edge(g, 2, 3, 8) == 0, "update during compaction");
+    TEST_CHECK_(edge_weight_of(g, 1, 2, &w) == 0 && edge_weight_of(g, 2, 3, &w) == 1,
+                "queries see both updates while compacting");
+    TEST_CHECK_(graph_compact_wait(g) == 0, "compaction installs");
+    TEST_CHECK_(g->csr.numEdges == 3 && graph_delta_size(g) == 1,
+                "only the later insert is still pending");
+    TEST_CHECK_(edge_weight_of(g, 2, 3, &w) == 1 && w == 8, "pending insert still visible");
+
+    graph_free(g);
+}
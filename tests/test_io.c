@@ -0,0 +1,299 @@
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include <test_common.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../include/graph.h"
+#include "../include/algorithms.h"
+#include "../include/io.h"
+#include "../include/reorder.h"
+#include "../include/landmarks.h"
+
+#define SNAPSHOT_TEST_FILE "build/test_snapshot.bin"
+#define LANDMARKS_TEST_FILE "build/test_landmarks.bin"
+
+/* snapshot round trip: topology, weights and names survive, graph is read-only */
+
+void test_snapshot_round_trip(void) {
+    Graph *g = createGraph(4);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    addWeightedEdge(g, 0, 1, 5, 1);
+    addWeightedEdge(g, 1, 2, 3, 0);
+    addWeightedEdge(g, 0, 2, 10, 0);
+    graphSetName(g, 0, "Berlin");
+    graphSetName(g, 2, "Munich");
+    /* Longer than the first pool chunk, so the pool spans several */
+    char lengthy[300];
+    memset(lengthy, 'q', sizeof(lengthy) - 1);
+    lengthy[sizeof(lengthy) - 1] = '\0';
+    graphSetName(g, 3, lengthy);
+
+    TEST_ASSERT_(save_graph_snapshot(g, SNAPSHOT_TEST_FILE) == 0,
+                 "snapshot should be written");
+    TEST_CHECK_(is_graph_snapshot_file(SNAPSHOT_TEST_FILE) == 1,
+                "snapshot magic detected");
+    TEST_CHECK_(is_graph_snapshot_file("data/sample_graph.txt") == 0,
+                "text graph is not a snapshot");
+
+    Graph *m = load_graph_snapshot(SNAPSHOT_TEST_FILE);
+    TEST_ASSERT_(m != NULL, "snapshot should load");
+    TEST_CHECK_(m->numVertices == 4, "vertex count preserved");
+    TEST_CHECK_(m->csr.numEdges == g->csr.numEdges, "edge count preserved");
+    TEST_CHECK_(memcmp(m->csr.offsets, g->csr.offsets, 5 * sizeof(int)) == 0 &&
+                memcmp(m->csr.targets, g->csr.targets, 4 * sizeof(int)) == 0 &&
+                m->csr.weightBits == g->csr.weightBits && m->distBits == g->distBits &&
+                memcmp(m->csr.weights, g->csr.weights, 4 * (g->csr.weightBits / 8)) == 0,
+                "CSR arrays identical");
+    TEST_CHECK_(strcmp(graphGetName(m, 0), "Berlin") == 0 &&
+                strcmp(graphGetName(m, 2), "Munich") == 0 &&
+                strcmp(graphGetName(m, 3), lengthy) == 0,
+                "names preserved");
+    TEST_CHECK_(graph_find_vertex_by_name(m, lengthy) == 3, "name from a later chunk found");
+    TEST_CHECK_(graphGetName(m, 1) == NULL, "unnamed vertex stays unnamed");
+    TEST_CHECK_(graph_find_vertex_by_name(m, "Munich") == 2, "lookup by name works");
+
+    int path[4] = {0};
+    long long dist = -1;
+    int len = dijkstra_shortest_path(m, 0, 2, path, 4, &dist);
+    TEST_CHECK_(len == 3 && dist == 8, "query on mapped graph finds 0→1→2");
+
+    addWeightedEdge(m, 0, 3, 1, 0);
+    graphSetName(m, 3, "Ignored");
+    TEST_CHECK_(m->csr.numEdges == 4 && strcmp(graphGetName(m, 3), lengthy) == 0,
+                "snapshot-backed graph is read-only");
+
+    graph_free(m);
+    graph_free(g);
+    remove(SNAPSHOT_TEST_FILE);
+}
+
+/* corrupt or missing snapshots are rejected */
+
+void test_snapshot_invalid_file(void) {
+    TEST_CHECK_(load_graph_snapshot(NULL) == NULL, "NULL filename rejected");
+    TEST_CHECK_(load_graph_snapshot("does/not/exist.bin") == NULL,
+                "missing file rejected");
+    TEST_CHECK_(load_graph_snapshot("data/sample_graph.txt") == NULL,
+                "text file rejected");
+}
+
+/* Header fields patched below (byte positions in io.c's SnapshotHeader) */
+#define HDR_TARGETS_POS      32
+#define HDR_NAME_OFFSETS_POS 48
+#define HDR_NAME_INDEX_POS   72
+#define HDR_NAME_INDEX_CAP   80
+#define HDR_TO_EXTERNAL_POS  88
+#define HDR_FLAGS            112
+#define HDR_DIST_BITS        118
+
+static long snapshot_read(unsigned char *buf, long cap) {
+    FILE *fp = fopen(SNAPSHOT_TEST_FILE, "rb");
+    if (!fp) return -1;
+    long size = (long)fread(buf, 1, cap, fp);
+    fclose(fp);
+    return size;
+}
+
+static uint64_t snapshot_field(const unsigned char *buf, int pos) {
+    uint64_t v;
+    memcpy(&v, buf + pos, sizeof(v));
+    return v;
+}
+
+/* Writes buf with one 32- or 16-bit value replaced, then tries to load it */
+static Graph *snapshot_load_patched(const unsigned char *buf, long size, uint64_t pos, int32_t value, int width) {
+    unsigned char *copy = malloc(size);
+    if (!copy) return NULL;
+    memcpy(copy, buf, size);
+    if (width == 16) {
+        int16_t v16 = (int16_t)value;
+        memcpy(copy + pos, &v16, sizeof(v16));
+    } else {
+        memcpy(copy + pos, &value, sizeof(value));
+    }
+    FILE *fp = fopen(SNAPSHOT_TEST_FILE, "wb");
+    if (fp) {
+        fwrite(copy, 1, size, fp);
+        fclose(fp);
+    }
+    free(copy);
+    return load_graph_snapshot_checked(SNAPSHOT_TEST_FILE);
+}
+
+/* the checked loader tests sections against each other, not just against the file size */
+
+void test_snapshot_corrupt_sections(void) {
+    Graph *g = createGraph(4);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+    addWeightedEdge(g, 0, 1, 30000, 0);
+    addWeightedEdge(g, 1, 2, 30000, 0);
+    addWeightedEdge(g, 2, 3, 30000, 0);
+    graphSetName(g, 0, "Berlin");
+    TEST_ASSERT_(graph_reorder(g, ORDER_BFS) == 0, "reorder should succeed");
+    TEST_ASSERT_(save_graph_snapshot(g, SNAPSHOT_TEST_FILE) == 0, "snapshot should be written");
+    TEST_CHECK_(g->distBits == 32, "distances need 32 bits");
+    graph_free(g);
+
+    static unsigned char buf[4096];
+    long size = snapshot_read(buf, sizeof(buf));
+    TEST_ASSERT_(size > 0 && size < (long)sizeof(buf), "snapshot read back");
+
+    Graph *m = snapshot_load_patched(buf, size, snapshot_field(buf, HDR_TARGETS_POS), 4, 32);
+    TEST_CHECK_(m == NULL, "target outside the graph rejected");
+    m = snapshot_load_patched(buf, size, snapshot_field(buf, HDR_NAME_OFFSETS_POS), 1000, 32);
+    TEST_CHECK_(m == NULL, "name offset past the pool rejected");
+    uint64_t to_external = snapshot_field(buf, HDR_TO_EXTERNAL_POS);
+    int32_t second;
+    memcpy(&second, buf + to_external + 4, sizeof(second));
+    m = snapshot_load_patched(buf, size, to_external, second, 32);
+    TEST_CHECK_(m == NULL, "vertex order that is not a permutation rejected");
+
+    /* Fill every empty index slot: a probe would never stop */
+    unsigned char *full = malloc(size);
+    TEST_ASSERT(full != NULL);
+    memcpy(full, buf, size);
+    uint64_t index_pos = snapshot_field(buf, HDR_NAME_INDEX_POS);
+    for (uint64_t i = 0; i < snapshot_field(buf, HDR_NAME_INDEX_CAP); i++) {
+        int32_t vertex;
+        memcpy(&vertex, full + index_pos + i * 8 + 4, sizeof(vertex));
+        if (vertex == -1) {
+            vertex = 0;
+            memcpy(full + index_pos + i * 8 + 4, &vertex, sizeof(vertex));
+        }
+    }
+    int32_t flags = (int32_t)snapshot_field(buf, HDR_FLAGS);
+    m = snapshot_load_patched(full, size, HDR_FLAGS, flags, 32);
+    TEST_CHECK_(m == NULL, "name index without a free slot rejected");
+    free(full);
+
+    /* Header claims are recomputed from the edges */
+    m = snapshot_load_patched(buf, size, HDR_DIST_BITS, 16, 16);
+    TEST_ASSERT_(m != NULL, "narrow distance claim still loads");
+    TEST_CHECK_(m->distBits == 32, "distance width recomputed");
+    graph_free(m);
+    m = snapshot_load_patched(buf, size, HDR_FLAGS, flags | 0x4, 32);
+    TEST_ASSERT_(m != NULL, "symmetry claim still loads");
+    TEST_CHECK_(!m->symmetric, "one-way edges are not symmetric");
+    int path[4];
+    long long d = -1;
+    TEST_CHECK_(dijkstra_shortest_path(m, 3, 0, path, 4, &d) == 0 && d == -1, "no way back");
+    graph_free(m);
+
+    /* The plain loader only checks the header and section bounds */
+    m = load_graph_snapshot(SNAPSHOT_TEST_FILE);
+    TEST_ASSERT_(m != NULL, "plain loader maps the file");
+    TEST_CHECK_(m->symmetric && m->distBits == 32, "header claims taken as written");
+    graph_free(m);
+    m = snapshot_load_patched(buf, size, HDR_TARGETS_POS, 3, 32);
+    TEST_CHECK_(m == NULL, "misaligned section rejected");
+    TEST_CHECK_(load_graph_snapshot(SNAPSHOT_TEST_FILE) == NULL, "plain loader rejects it too");
+
+    remove(SNAPSHOT_TEST_FILE);
+}
+
+/* a vertex order applied before saving is restored by the loader */
+
+void test_snapshot_keeps_vertex_order(void) {
+    Graph *g = createGraph(5);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+
+    for (int i = 0; i < 4; i++) {
+        addWeightedEdge(g, i, i + 1, 10 + i, 1);
+        graphSetCoordinates(g, i, i, 0);
+    }
+    TEST_ASSERT_(graph_reorder(g, ORDER_RCM) == 0, "reorder should succeed");
+    TEST_ASSERT_(save_graph_snapshot(g, SNAPSHOT_TEST_FILE) == 0,
+                 "snapshot should be written");
+
+    Graph *m = load_graph_snapshot(SNAPSHOT_TEST_FILE);
+    TEST_ASSERT_(m != NULL, "snapshot should load");
+    for (int i = 0; i < 5; i++) {
+        TEST_CHECK_(graph_to_internal(m, i) == graph_to_internal(g, i),
+                    "internal IDs preserved");
+    }
+
+    double x = -1, y = -1;
+    TEST_CHECK_(graphGetCoordinates(m, 3, &x, &y) == 1 && x == 3 && y == 0,
+                "coordinates preserved");
+
+    int path[5];
+    int dist = -1;
+    int len = bfs_shortest_hops(m, 4, 0, path, 5, &dist);
+    TEST_CHECK_(len == 5 && path[0] == 4 && path[4] == 0,
+                "path reported in external IDs");
+
+    graph_free(m);
+    graph_free(g);
+    remove(SNAPSHOT_TEST_FILE);
+}
+
+/* live updates work on a mapped snapshot; compaction moves the base out of the mapping */
+
+void test_snapshot_live_updates(void) {
+    Graph *g = createGraph(3);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+    addWeightedEdge(g, 0, 1, 4, 1);
+    addWeightedEdge(g, 1, 2, 4, 1);
+    TEST_ASSERT_(save_graph_snapshot(g, SNAPSHOT_TEST_FILE) == 0, "snapshot should be written");
+    graph_free(g);
+
+    Graph *m = load_graph_snapshot_checked(SNAPSHOT_TEST_FILE);
+    TEST_CHECK_(m != NULL && m->symmetric, "checked load confirms the symmetry flag");
+    graph_free(m);
+    m = load_graph_snapshot(SNAPSHOT_TEST_FILE);
+    TEST_ASSERT_(m != NULL, "snapshot should load");
+
+    int path[3];
+    long long d = -1;
+    TEST_CHECK_(graph_insert_edge(m, 0, 2, 5) == 0, "insert into mapped graph");
+    TEST_CHECK_(dijkstra_shortest_path(m, 0, 2, path, 3, &d) == 2 && d == 5, "query uses the overlay");
+    TEST_CHECK_(graph_compact(m, 0) == 0 && !m->csrInMapping, "compacted base is owned");
+    TEST_CHECK_(dijkstra_shortest_path(m, 2, 0, path, 3, &d) == 3 && d == 8, "reverse direction untouched");
+
+    graph_free(m);
+    remove(SNAPSHOT_TEST_FILE);
+}
+
+/* landmark tables survive a save/load round trip and are tied to the graph's edges */
+
+void test_landmarks_round_trip(void) {
+    Graph *g = createGraph(6);
+    TEST_ASSERT_(g != NULL, "failed to create graph");
+    for (int v = 0; v + 1 < 6; v++) {
+        addWeightedEdge(g, v, v + 1, v + 1, v % 2);
+    }
+
+    Landmarks *lm = landmarks_build(g, 2, LANDMARKS_AVOID);
+    TEST_ASSERT_(lm != NULL, "landmarks should build");
+    TEST_ASSERT_(landmarks_save(lm, LANDMARKS_TEST_FILE) == 0, "tables should be written");
+
+    Landmarks *loaded = landmarks_load(LANDMARKS_TEST_FILE, g);
+    TEST_ASSERT_(loaded != NULL, "tables should load");
+    TEST_CHECK_(loaded->count == lm->count &&
+                memcmp(loaded->vertices, lm->vertices, lm->count * sizeof(int)) == 0 &&
+                memcmp(loaded->fromLandmark, lm->fromLandmark, 6 * lm->count * sizeof(long long)) == 0 &&
+                memcmp(loaded->toLandmark, lm->toLandmark, 6 * lm->count * sizeof(long long)) == 0,
+                "tables identical after reload");
+
+    Graph *other = createGraph(5);
+    TEST_CHECK_(landmarks_load(LANDMARKS_TEST_FILE, other) == NULL, "other graph size rejected");
+
+    /* Same size, one weight differs */
+    Graph *reweighted = createGraph(6);
+    TEST_ASSERT_(reweighted != NULL, "failed to create graph");
+    for (int v = 0; v + 1 < 6; v++) {
+        addWeightedEdge(reweighted, v, v + 1, v == 2 ? 1 : v + 1, v % 2);
+    }
+    TEST_CHECK_(landmarks_load(LANDMARKS_TEST_FILE, reweighted) == NULL, "other edges rejected");
+    graph_free(reweighted);
+    TEST_CHECK_(landmarks_load("data/sample_graph.txt", g) == NULL, "text file rejected");
+
+    graph_free(other);
+    landmarks_free(loaded);
+    landmarks_free(lm);
+    graph_free(g);
+    remove(LANDMARKS_TEST_FILE);
+}